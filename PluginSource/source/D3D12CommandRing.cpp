@@ -0,0 +1,128 @@
+#include "D3D12CommandRing.h"
+#include "PlatformBase.h"
+
+#include <utility>
+
+
+const UINT kRingNodeMask = 0;
+
+
+D3D12CommandRing::D3D12CommandRing()
+	: m_entries()
+	, m_type(D3D12_COMMAND_LIST_TYPE_DIRECT)
+	, m_current(0)
+	, m_lastFence(nullptr)
+	, m_lastFenceValue(0)
+	, m_stallCount(0)
+	, m_event(nullptr)
+{
+}
+
+
+D3D12CommandRing::~D3D12CommandRing()
+{
+	Release();
+}
+
+
+bool D3D12CommandRing::Create(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type)
+{
+	for (int i = 0; i < NRD_FRAMES_IN_FLIGHT; i++)
+	{
+		Entry& entry = m_entries[i];
+
+		HRESULT hr = device->CreateCommandAllocator(type, IID_PPV_ARGS(&entry.alloc));
+		if (FAILED(hr))
+		{
+			OutputDebugStringA("Failed to CreateCommandAllocator.\n");
+			Release();
+			return false;
+		}
+
+		hr = device->CreateCommandList(kRingNodeMask, type, entry.alloc, nullptr, IID_PPV_ARGS(&entry.list));
+		if (FAILED(hr))
+		{
+			OutputDebugStringA("Failed to CreateCommandList.\n");
+			Release();
+			return false;
+		}
+
+		entry.list->Close();
+		entry.fence = nullptr;
+		entry.fenceValue = 0;
+	}
+
+	m_type = type;
+	m_event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+	m_current = NRD_FRAMES_IN_FLIGHT - 1; // First Begin() lands on entry 0
+	return true;
+}
+
+
+void D3D12CommandRing::Release()
+{
+	for (int i = 0; i < NRD_FRAMES_IN_FLIGHT; i++)
+	{
+		SAFE_RELEASE(m_entries[i].list);
+		SAFE_RELEASE(m_entries[i].alloc);
+		m_entries[i].fence = nullptr;
+		m_entries[i].fenceValue = 0;
+	}
+
+	if (m_event)
+	{
+		CloseHandle(m_event);
+		m_event = nullptr;
+	}
+
+	m_lastFence = nullptr;
+	m_lastFenceValue = 0;
+}
+
+
+void D3D12CommandRing::Swap(D3D12CommandRing& other)
+{
+	std::swap(m_entries, other.m_entries);
+	std::swap(m_type, other.m_type);
+	std::swap(m_current, other.m_current);
+	std::swap(m_lastFence, other.m_lastFence);
+	std::swap(m_lastFenceValue, other.m_lastFenceValue);
+	std::swap(m_event, other.m_event);
+}
+
+
+ID3D12GraphicsCommandList* D3D12CommandRing::Begin()
+{
+	if (!IsCreated())
+		return nullptr;
+
+	m_current = (m_current + 1) % NRD_FRAMES_IN_FLIGHT;
+	Entry& entry = m_entries[m_current];
+
+	// D3D12 forbids resetting an allocator the GPU is still reading from. With one entry per
+	// frame in flight this only triggers when the GPU is a full ring behind the render thread.
+	if (entry.fence && entry.fence->GetCompletedValue() < entry.fenceValue)
+	{
+		m_stallCount++;
+		if (m_event)
+		{
+			entry.fence->SetEventOnCompletion(entry.fenceValue, m_event);
+			WaitForSingleObject(m_event, 2000); // 2s timeout to avoid infinite hang
+		}
+	}
+
+	entry.alloc->Reset();
+	entry.list->Reset(entry.alloc, nullptr);
+	return entry.list;
+}
+
+
+void D3D12CommandRing::SetSubmitted(ID3D12Fence* fence, UINT64 fenceValue)
+{
+	Entry& entry = m_entries[m_current];
+	entry.fence = fence;
+	entry.fenceValue = fenceValue;
+
+	m_lastFence = fence;
+	m_lastFenceValue = fenceValue;
+}
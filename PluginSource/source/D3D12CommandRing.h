@@ -0,0 +1,59 @@
+#pragma once
+#include <basetsd.h>
+#include <d3d12.h>
+
+
+// Number of command allocator/list pairs per ring — one per frame the GPU may still be executing.
+static const int NRD_FRAMES_IN_FLIGHT = 3;
+
+
+// Ring of command allocator/list pairs. Recording into entry N only has to wait for the GPU
+// to finish the submission made NRD_FRAMES_IN_FLIGHT recordings ago, not the previous one,
+// so the render thread no longer serializes against the GPU every frame.
+class D3D12CommandRing
+{
+public:
+	D3D12CommandRing();
+	~D3D12CommandRing();
+
+	bool Create(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type);
+	// Caller must ensure the GPU is done with every entry (see GetLastFenceValue)
+	void Release();
+	// Exchange command objects with another ring (used to hand a ring to the retire queue).
+	// Stall counts stay with their owner.
+	void Swap(D3D12CommandRing& other);
+	bool IsCreated() const { return m_entries[0].list != nullptr; }
+	D3D12_COMMAND_LIST_TYPE GetType() const { return m_type; }
+
+	// Advance to the next entry, reset it and return its command list open for recording.
+	// Blocks only if that entry's previous submission has not completed yet (counted as a stall).
+	ID3D12GraphicsCommandList* Begin();
+	ID3D12CommandAllocator* GetCurrentAllocator() const { return m_entries[m_current].alloc; }
+	ID3D12GraphicsCommandList* GetCurrentList() const { return m_entries[m_current].list; }
+
+	// Record the fence/value that signals completion of the current entry's submission
+	void SetSubmitted(ID3D12Fence* fence, UINT64 fenceValue);
+
+	// Latest fence value submitted from this ring — waiting on it makes every entry reusable
+	UINT64 GetLastFenceValue() const { return m_lastFenceValue; }
+	ID3D12Fence* GetLastFence() const { return m_lastFence; }
+
+	UINT64 GetStallCount() const { return m_stallCount; }
+
+private:
+	struct Entry
+	{
+		ID3D12CommandAllocator* alloc;
+		ID3D12GraphicsCommandList* list;
+		ID3D12Fence* fence;
+		UINT64 fenceValue;
+	};
+
+	Entry m_entries[NRD_FRAMES_IN_FLIGHT];
+	D3D12_COMMAND_LIST_TYPE m_type;
+	int m_current;
+	ID3D12Fence* m_lastFence;
+	UINT64 m_lastFenceValue;
+	UINT64 m_stallCount;
+	HANDLE m_event;
+};
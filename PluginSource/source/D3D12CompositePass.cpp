@@ -0,0 +1,105 @@
+#include "D3D12CompositePass.h"
+
+
+// Same formulas as NRDComposite.cpp; flag values are NRDCompositeFlags
+static const char s_compositeShader[] = R"(
+cbuffer Constants : register(b0)
+{
+	uint2 gRectSize;
+	uint gFlags;
+};
+
+Texture2D<float4> gDiffuse : register(t0);
+Texture2D<float4> gDiffuseSh1 : register(t1);
+Texture2D<float4> gSpecular : register(t2);
+Texture2D<float4> gSpecularSh1 : register(t3);
+Texture2D<float4> gAlbedo : register(t4);
+Texture2D<float4> gSpecularAlbedo : register(t5);
+Texture2D<float4> gNormal : register(t6);
+Texture2D<float4> gBase : register(t7);
+
+RWTexture2D<float4> gTarget : register(u0);
+
+#define FLAG_REMODULATE     1
+#define FLAG_ADD_BASE       2
+#define FLAG_DIFFUSE        4
+#define FLAG_SPECULAR       8
+#define FLAG_DIFFUSE_SH     16
+#define FLAG_SPECULAR_SH    32
+#define FLAG_YCOCG          64
+
+float3 YCoCgToLinear(float3 c)
+{
+	float t = c.x - c.z;
+	return max(float3(t + c.y, c.x + c.z, t - c.y), 0.0);
+}
+
+float3 ResolveSh(float4 sh0, float4 sh1, float3 n)
+{
+	float y = sh0.x;
+	if (y <= 0.0)
+		return 0.0;
+
+	float len = length(sh1.xyz);
+	float r = saturate(len / y);
+	float q = len > 0.0 ? 0.5 + 0.5 * dot(sh1.xyz, n) / len : 0.5;
+	float p = 1.0 + 2.0 * r;
+	float a = (1.0 - r) / (1.0 + r);
+	float resolved = y * (a + (1.0 - a) * (p + 1.0) * pow(saturate(q), p));
+	return YCoCgToLinear(float3(resolved, sh0.yz * (resolved / y)));
+}
+
+float3 ResolveSignal(float4 radiance, float4 sh1, float3 n, bool sh)
+{
+	if (sh)
+		return ResolveSh(radiance, sh1, n);
+	if (gFlags & FLAG_YCOCG)
+		return YCoCgToLinear(radiance.xyz);
+	return radiance.xyz;
+}
+
+[numthreads(8, 8, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (any(id >= gRectSize))
+		return;
+
+	float3 n = 0.0;
+	if (gFlags & (FLAG_DIFFUSE_SH | FLAG_SPECULAR_SH))
+	{
+		n = gNormal[id].xyz * 2.0 - 1.0;
+		float len = length(n);
+		n = len > 0.0 ? n / len : n;
+	}
+
+	bool remodulate = (gFlags & FLAG_REMODULATE) != 0;
+	float3 color = 0.0;
+
+	if (gFlags & FLAG_DIFFUSE)
+	{
+		float3 diffuse = ResolveSignal(gDiffuse[id], gDiffuseSh1[id], n, (gFlags & FLAG_DIFFUSE_SH) != 0);
+		color += remodulate ? diffuse * gAlbedo[id].rgb : diffuse;
+	}
+
+	if (gFlags & FLAG_SPECULAR)
+	{
+		float3 specular = ResolveSignal(gSpecular[id], gSpecularSh1[id], n, (gFlags & FLAG_SPECULAR_SH) != 0);
+		color += remodulate ? specular * gSpecularAlbedo[id].rgb : specular;
+	}
+
+	// Write-only: typed UAV loads of the target's format aren't available everywhere
+	if (gFlags & FLAG_ADD_BASE)
+	{
+		float4 base = gBase[id];
+		gTarget[id] = float4(base.rgb + color, base.a);
+	}
+	else
+		gTarget[id] = float4(color, 1.0);
+}
+)";
+
+
+bool D3D12CompositePass::Create(ID3D12Device* device)
+{
+	return D3D12ComputePass::Create(device, s_compositeShader, "NRDComposite", NRD_COMPOSITE_INPUT_COUNT, 1);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "D3D12ComputePass.h"
+
+
+// Textures the composite pass reads, in descriptor table order (t0..t7)
+enum NRDCompositeInput
+{
+	NRD_COMPOSITE_INPUT_DIFFUSE,         // OUT_DIFF_RADIANCE_HITDIST or OUT_DIFF_SH0
+	NRD_COMPOSITE_INPUT_DIFFUSE_SH1,
+	NRD_COMPOSITE_INPUT_SPECULAR,        // OUT_SPEC_RADIANCE_HITDIST or OUT_SPEC_SH0
+	NRD_COMPOSITE_INPUT_SPECULAR_SH1,
+	NRD_COMPOSITE_INPUT_ALBEDO,
+	NRD_COMPOSITE_INPUT_SPECULAR_ALBEDO,
+	NRD_COMPOSITE_INPUT_NORMAL,
+	NRD_COMPOSITE_INPUT_BASE,
+	NRD_COMPOSITE_INPUT_COUNT
+};
+
+// The first NRD_COMPOSITE_INPUT_SPECULAR_SH1 + 1 inputs are NRD outputs
+static const int NRD_COMPOSITE_OUTPUT_INPUT_COUNT = NRD_COMPOSITE_INPUT_SPECULAR_SH1 + 1;
+
+
+// Constant buffer of one dispatch (layout matches the shader's cbuffer)
+struct NRDCompositeConstants
+{
+	uint32_t rectSize[2];
+	uint32_t flags; // NRDCompositeFlags
+	uint32_t padding;
+};
+
+
+// Output stage: one compute dispatch after NRD resolves SH outputs, remodulates and writes the
+// result to the caller's target (u0). Mirrors EvaluateComposite (NRDComposite.h).
+class D3D12CompositePass : public D3D12ComputePass
+{
+public:
+	bool Create(ID3D12Device* device);
+};
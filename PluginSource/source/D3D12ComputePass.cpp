@@ -0,0 +1,227 @@
+#include "D3D12ComputePass.h"
+#include "PlatformBase.h"
+
+#include <d3dcompiler.h>
+#include <string.h>
+
+#pragma comment(lib, "d3dcompiler")
+
+
+const UINT kComputeNodeMask = 0;
+const UINT kComputeGroupSize = 8;
+
+
+D3D12ComputePass::D3D12ComputePass()
+	: m_rootSignature(nullptr)
+	, m_pipeline(nullptr)
+	, m_heap(nullptr)
+	, m_descriptorSize(0)
+	, m_srvCount(0)
+	, m_uavCount(0)
+	, m_failed(false)
+{
+}
+
+
+D3D12ComputePass::~D3D12ComputePass()
+{
+	Release();
+}
+
+
+bool D3D12ComputePass::Create(ID3D12Device* device, const char* source, const char* name, UINT srvCount, UINT uavCount)
+{
+	if (m_pipeline)
+		return true;
+	if (m_failed)
+		return false;
+
+	// b0 as a root CBV, then one table: SRVs t0.., then UAVs u0..
+	D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+	ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	ranges[0].NumDescriptors = srvCount;
+	ranges[0].OffsetInDescriptorsFromTableStart = 0;
+	ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+	ranges[1].NumDescriptors = uavCount;
+	ranges[1].OffsetInDescriptorsFromTableStart = srvCount;
+
+	D3D12_ROOT_PARAMETER params[2] = {};
+	params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	params[0].Descriptor.ShaderRegister = 0;
+	params[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	params[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	params[1].DescriptorTable.NumDescriptorRanges = 2;
+	params[1].DescriptorTable.pDescriptorRanges = ranges;
+	params[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+	D3D12_ROOT_SIGNATURE_DESC rootDesc = {};
+	rootDesc.NumParameters = 2;
+	rootDesc.pParameters = params;
+
+	ID3DBlob* blob = nullptr;
+	ID3DBlob* errors = nullptr;
+	HRESULT hr = D3D12SerializeRootSignature(&rootDesc, D3D_ROOT_SIGNATURE_VERSION_1, &blob, &errors);
+	if (SUCCEEDED(hr))
+		hr = device->CreateRootSignature(kComputeNodeMask, blob->GetBufferPointer(), blob->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature));
+	SAFE_RELEASE(blob);
+	SAFE_RELEASE(errors);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to create a compute pass root signature.\n");
+		m_failed = true;
+		return false;
+	}
+
+	hr = D3DCompile(source, strlen(source), name, nullptr, nullptr, "main", "cs_5_0",
+		D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &blob, &errors);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to compile a compute pass shader.\n");
+		if (errors)
+			OutputDebugStringA((const char*)errors->GetBufferPointer());
+		SAFE_RELEASE(blob);
+		SAFE_RELEASE(errors);
+		Release();
+		m_failed = true;
+		return false;
+	}
+	SAFE_RELEASE(errors);
+
+	D3D12_COMPUTE_PIPELINE_STATE_DESC pipelineDesc = {};
+	pipelineDesc.pRootSignature = m_rootSignature;
+	pipelineDesc.CS.pShaderBytecode = blob->GetBufferPointer();
+	pipelineDesc.CS.BytecodeLength = blob->GetBufferSize();
+	hr = device->CreateComputePipelineState(&pipelineDesc, IID_PPV_ARGS(&m_pipeline));
+	SAFE_RELEASE(blob);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to create a compute pass pipeline.\n");
+		Release();
+		m_failed = true;
+		return false;
+	}
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	heapDesc.NumDescriptors = (srvCount + uavCount) * NRD_COMPUTE_PASS_TABLES;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	hr = device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_heap));
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to create a compute pass descriptor heap.\n");
+		Release();
+		m_failed = true;
+		return false;
+	}
+
+	m_descriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	m_tables.Reset(heapDesc.NumDescriptors);
+
+	m_srvCount = srvCount;
+	m_uavCount = uavCount;
+	return true;
+}
+
+
+// Callers wait for every submission that used the heap first (device shutdown)
+void D3D12ComputePass::Release()
+{
+	SAFE_RELEASE(m_pipeline);
+	SAFE_RELEASE(m_rootSignature);
+	SAFE_RELEASE(m_heap);
+	m_tables.Reset(0);
+	m_failed = false;
+}
+
+
+bool D3D12ComputePass::AllocateTable(D3D12_CPU_DESCRIPTOR_HANDLE* cpuHandle, D3D12_GPU_DESCRIPTOR_HANDLE* gpuHandle)
+{
+	if (m_heap == nullptr)
+		return false;
+
+	int64_t index = m_tables.Allocate(GetDescriptorCount());
+	if (index < 0)
+		return false;
+
+	cpuHandle->ptr = m_heap->GetCPUDescriptorHandleForHeapStart().ptr + (SIZE_T)index * m_descriptorSize;
+	gpuHandle->ptr = m_heap->GetGPUDescriptorHandleForHeapStart().ptr + (UINT64)index * m_descriptorSize;
+	return true;
+}
+
+
+void D3D12ComputePass::WriteDescriptors(ID3D12Device* device, ID3D12Resource* const* srvs, const DXGI_FORMAT* srvFormats,
+	ID3D12Resource* const* uavs, const DXGI_FORMAT* uavFormats, D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle)
+{
+	for (UINT i = 0; i < m_srvCount; i++)
+	{
+		D3D12_SHADER_RESOURCE_VIEW_DESC srv = {};
+		srv.Format = srvs[i] ? srvFormats[i] : DXGI_FORMAT_R16G16B16A16_FLOAT;
+		srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srv.Texture2D.MipLevels = 1;
+		device->CreateShaderResourceView(srvs[i], &srv, cpuHandle);
+		cpuHandle.ptr += m_descriptorSize;
+	}
+
+	for (UINT i = 0; i < m_uavCount; i++)
+	{
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uav = {};
+		uav.Format = uavs[i] ? uavFormats[i] : DXGI_FORMAT_R16G16B16A16_FLOAT;
+		uav.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+		device->CreateUnorderedAccessView(uavs[i], nullptr, &uav, cpuHandle);
+		cpuHandle.ptr += m_descriptorSize;
+	}
+}
+
+
+void D3D12ComputePass::Record(ID3D12GraphicsCommandList* cmdList, D3D12_GPU_DESCRIPTOR_HANDLE table,
+	D3D12_GPU_VIRTUAL_ADDRESS constants, uint32_t width, uint32_t height)
+{
+	cmdList->SetDescriptorHeaps(1, &m_heap);
+	cmdList->SetComputeRootSignature(m_rootSignature);
+	cmdList->SetPipelineState(m_pipeline);
+	cmdList->SetComputeRootConstantBufferView(0, constants);
+	cmdList->SetComputeRootDescriptorTable(1, table);
+	cmdList->Dispatch((width + kComputeGroupSize - 1) / kComputeGroupSize, (height + kComputeGroupSize - 1) / kComputeGroupSize, 1);
+
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+	barrier.UAV.pResource = nullptr;
+	cmdList->ResourceBarrier(1, &barrier);
+}
+
+
+void D3D12ComputePass::TransitionForRead(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* const* resources, int count, bool toShaderResource)
+{
+	D3D12_RESOURCE_STATES uav = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	D3D12_RESOURCE_STATES srv = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+
+	// A resource may appear only once per barrier batch
+	const int kMaxBarriers = 32;
+	D3D12_RESOURCE_BARRIER barriers[kMaxBarriers] = {};
+	UINT barrierCount = 0;
+	for (int i = 0; i < count; i++)
+	{
+		bool repeated = resources[i] == nullptr;
+		for (int j = 0; j < i && !repeated; j++)
+			repeated = resources[j] == resources[i];
+		if (repeated)
+			continue;
+
+		if (barrierCount == kMaxBarriers)
+		{
+			cmdList->ResourceBarrier(barrierCount, barriers);
+			barrierCount = 0;
+		}
+
+		D3D12_RESOURCE_BARRIER& barrier = barriers[barrierCount++];
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Transition.pResource = resources[i];
+		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		barrier.Transition.StateBefore = toShaderResource ? uav : srv;
+		barrier.Transition.StateAfter = toShaderResource ? srv : uav;
+	}
+
+	if (barrierCount > 0)
+		cmdList->ResourceBarrier(barrierCount, barriers);
+}
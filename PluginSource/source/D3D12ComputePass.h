@@ -0,0 +1,66 @@
+#pragma once
+#include "NRDDescriptorArena.h"
+
+#include <basetsd.h>
+#include <d3d12.h>
+#include <stdint.h>
+
+
+// Descriptor tables in a pass's own heap: enough for every dispatch of the submissions in flight
+static const uint32_t NRD_COMPUTE_PASS_TABLES = 64;
+
+
+// A compute shader the plugin dispatches next to NRD: root CBV b0 plus one descriptor table of
+// srvCount SRVs (t0..) followed by uavCount UAVs (u0..), 8x8 thread groups. The HLSL source is
+// compiled on first use. Each pass owns a small shader-visible heap for its tables, recycled per
+// submission; constants come from the backend's upload ring.
+class D3D12ComputePass
+{
+public:
+	D3D12ComputePass();
+	~D3D12ComputePass();
+
+	// Fences read by the table ring — set before the first AllocateTable
+	void SetFenceSource(RetireFenceSource* fenceSource) { m_tables.SetFenceSource(fenceSource); }
+
+	// Compiles the shader and creates the pipeline and heap; a failure is remembered and not retried
+	bool Create(ID3D12Device* device, const char* source, const char* name, UINT srvCount, UINT uavCount);
+	void Release();
+	bool IsCreated() const { return m_pipeline != nullptr; }
+
+	// Descriptors needed by one dispatch: the SRVs, then the UAVs
+	UINT GetDescriptorCount() const { return m_srvCount + m_uavCount; }
+
+	// One dispatch's table for the next submission; it stays valid until EndSubmission's fence passes.
+	// Returns false if every table is still in flight.
+	bool AllocateTable(D3D12_CPU_DESCRIPTOR_HANDLE* cpuHandle, D3D12_GPU_DESCRIPTOR_HANDLE* gpuHandle);
+
+	// Tables allocated since the previous call are recycled once fence reaches fenceValue
+	void EndSubmission(void* fence, uint64_t fenceValue) { m_tables.EndFrame(fence, fenceValue); }
+
+	// Size of the pass's shader-visible heap (zero until created)
+	UINT64 GetHeapBytes() const { return m_heap ? (UINT64)m_tables.GetCapacity() * m_descriptorSize : 0; }
+
+	// Fill a dispatch's descriptor table at cpuHandle. Null resources get null descriptors; formats
+	// are the typed views to create (see the backend's format resolution).
+	void WriteDescriptors(ID3D12Device* device, ID3D12Resource* const* srvs, const DXGI_FORMAT* srvFormats,
+		ID3D12Resource* const* uavs, const DXGI_FORMAT* uavFormats, D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle);
+
+	// Dispatch over width x height, then a UAV barrier so later work reads the finished results
+	void Record(ID3D12GraphicsCommandList* cmdList, D3D12_GPU_DESCRIPTOR_HANDLE table,
+		D3D12_GPU_VIRTUAL_ADDRESS constants, uint32_t width, uint32_t height);
+
+	// Switch resources between UAV (NRD's state for everything it binds) and shader resource around
+	// a dispatch that reads them. Null and repeated entries are skipped.
+	static void TransitionForRead(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* const* resources, int count, bool toShaderResource);
+
+private:
+	ID3D12RootSignature* m_rootSignature;
+	ID3D12PipelineState* m_pipeline;
+	ID3D12DescriptorHeap* m_heap;
+	UINT m_descriptorSize;
+	NRDDescriptorArena m_tables; // Indices into m_heap, in descriptors
+	UINT m_srvCount;
+	UINT m_uavCount;
+	bool m_failed;
+};
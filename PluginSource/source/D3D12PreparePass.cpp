@@ -0,0 +1,106 @@
+#include "D3D12PreparePass.h"
+#include "RenderAPI.h"
+
+
+// Unity built-in deferred conventions: GBuffer0 = albedo, GBuffer1.a = smoothness,
+// GBuffer2.rgb = world normal * 0.5 + 0.5, motion vectors = currentUv - previousUv.
+// Packing follows NRD's front-end functions (NRD.hlsli) for the encoding NRD was built with.
+static const char s_prepareShader[] = R"(
+cbuffer Constants : register(b0)
+{
+	float4 gDepthParams;
+	float4 gHitDistParams;
+	uint2 gRectSize;
+	uint gTargetMask;
+	uint gNormalEncoding;
+	uint gReblurPacking;
+	uint2 gCheckerboardPhase;
+};
+
+Texture2D<float4> gMotionVectors : register(t0);
+Texture2D<float> gDepth : register(t1);
+Texture2D<float4> gGBuffer0 : register(t2);
+Texture2D<float4> gGBuffer1 : register(t3);
+Texture2D<float4> gGBuffer2 : register(t4);
+Texture2D<float4> gDiffuse : register(t5);
+Texture2D<float4> gSpecular : register(t6);
+
+RWTexture2D<float4> gOutMv : register(u0);
+RWTexture2D<float4> gOutNormalRoughness : register(u1);
+RWTexture2D<float4> gOutBaseColorMetalness : register(u2);
+RWTexture2D<float4> gOutViewZ : register(u3);
+RWTexture2D<float4> gOutDiffRadianceHitDist : register(u4);
+RWTexture2D<float4> gOutSpecRadianceHitDist : register(u5);
+
+float2 EncodeOctahedral(float3 n)
+{
+	n /= dot(abs(n), 1.0);
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * (n.xy >= 0.0 ? 1.0 : -1.0);
+	return n.xy * 0.5 + 0.5;
+}
+
+float4 PackNormalRoughness(float3 n, float roughness)
+{
+	if (gNormalEncoding == 2)
+		return float4(EncodeOctahedral(n), roughness, 0.0);
+	if (gNormalEncoding == 1 || gNormalEncoding == 4)
+		return float4(n, roughness);
+	return float4(n * 0.5 + 0.5, roughness);
+}
+
+float3 LinearToYCoCg(float3 color)
+{
+	return float3(dot(color, float3(0.25, 0.5, 0.25)), dot(color, float3(0.5, 0.0, -0.5)), dot(color, float3(-0.25, 0.5, -0.25)));
+}
+
+float4 PackRadianceHitDist(float4 lighting, float viewZ, float roughness)
+{
+	if (gReblurPacking == 0)
+		return lighting;
+
+	// 0 marks "no data" for REBLUR, so real hits keep a tiny distance
+	float f = (gHitDistParams.x + viewZ * gHitDistParams.y) * lerp(1.0, gHitDistParams.z, saturate(exp2(gHitDistParams.w * roughness * roughness)));
+	float normHitDist = lighting.a != 0.0 ? max(saturate(lighting.a / f), 1e-7) : 0.0;
+	return float4(LinearToYCoCg(lighting.rgb), normHitDist);
+}
+
+// Checkerboard: only this frame's pixels are written, packed to half width
+bool GetRadianceTexel(uint2 id, uint phase, out uint2 texel)
+{
+	texel = phase == 2 ? id : uint2(id.x >> 1, id.y);
+	return phase == 2 || ((id.x ^ id.y) & 1) == phase;
+}
+
+[numthreads(8, 8, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (any(id >= gRectSize))
+		return;
+
+	float d = gDepth[id];
+	float viewZ = abs((gDepthParams.y - d * gDepthParams.w) / (d * gDepthParams.z - gDepthParams.x));
+	float roughness = 1.0 - gGBuffer1[id].a;
+
+	if (gTargetMask & 1)
+		gOutMv[id] = float4(-gMotionVectors[id].xy, 0.0, 0.0);
+	if (gTargetMask & 2)
+		gOutNormalRoughness[id] = PackNormalRoughness(normalize(gGBuffer2[id].xyz * 2.0 - 1.0), roughness);
+	if (gTargetMask & 4)
+		gOutBaseColorMetalness[id] = float4(gGBuffer0[id].rgb, 0.0);
+	if (gTargetMask & 8)
+		gOutViewZ[id] = viewZ;
+
+	uint2 texel;
+	if ((gTargetMask & 16) && GetRadianceTexel(id, gCheckerboardPhase.x, texel))
+		gOutDiffRadianceHitDist[texel] = PackRadianceHitDist(gDiffuse[id], viewZ, 1.0);
+	if ((gTargetMask & 32) && GetRadianceTexel(id, gCheckerboardPhase.y, texel))
+		gOutSpecRadianceHitDist[texel] = PackRadianceHitDist(gSpecular[id], viewZ, roughness);
+}
+)";
+
+
+bool D3D12PreparePass::Create(ID3D12Device* device)
+{
+	return D3D12ComputePass::Create(device, s_prepareShader, "NRDPrepare", NRD_PREPARE_SOURCE_COUNT, NRD_PREPARE_TARGET_COUNT);
+}
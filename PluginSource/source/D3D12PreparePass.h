@@ -0,0 +1,38 @@
+#pragma once
+#include "D3D12ComputePass.h"
+
+
+// NRD inputs the prepare pass can write, in descriptor table order (u0..u5)
+enum NRDPrepareTarget
+{
+	NRD_PREPARE_TARGET_MV,
+	NRD_PREPARE_TARGET_NORMAL_ROUGHNESS,
+	NRD_PREPARE_TARGET_BASECOLOR_METALNESS,
+	NRD_PREPARE_TARGET_VIEWZ,
+	NRD_PREPARE_TARGET_DIFF_RADIANCE_HITDIST,
+	NRD_PREPARE_TARGET_SPEC_RADIANCE_HITDIST,
+	NRD_PREPARE_TARGET_COUNT
+};
+
+
+// Constant buffer of one dispatch (layout matches the shader's cbuffer)
+struct NRDPrepareConstants
+{
+	float depthParams[4];   // viewToClip (2,2), (2,3), (3,2), (3,3): viewZ = (p1 - d * p3) / (d * p2 - p0)
+	float hitDistParams[4]; // REBLUR HitDistanceParameters A, B, C, D
+	uint32_t rectSize[2];
+	uint32_t targetMask;    // Bit per NRDPrepareTarget written by this dispatch
+	uint32_t normalEncoding;   // nrd::NormalEncoding of the loaded NRD
+	uint32_t reblurPacking;    // REBLUR: YCoCg radiance, normalized hit distance. RELAX: RGB, world units
+	uint32_t checkerboardPhase[2]; // Diffuse, specular: GetCheckerboardPhase, or 2 = full rate
+	uint32_t padding;
+};
+
+
+// Fused input preparation: one compute dispatch reads Unity's motion vectors, depth, G-buffer and
+// lighting (NRDPrepareSource SRVs) and writes every NRD input the slot has (NRDPrepareTarget UAVs)
+class D3D12PreparePass : public D3D12ComputePass
+{
+public:
+	bool Create(ID3D12Device* device);
+};
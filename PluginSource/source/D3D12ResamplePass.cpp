@@ -0,0 +1,175 @@
+#include "D3D12ResamplePass.h"
+
+
+// Same selection as GetDownsampleTexel (NRDUpsample.cpp)
+static const char s_downsampleShader[] = R"(
+cbuffer Constants : register(b0)
+{
+	uint2 gRectSize;
+	uint2 gLowRectSize;
+	uint gDivisor;
+	uint gCount;
+};
+
+Texture2D<float> gViewZ : register(t0);
+Texture2D<float4> gInputs[8] : register(t1);
+
+RWTexture2D<float4> gOutputs[8] : register(u0);
+
+[numthreads(8, 8, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (any(id >= gLowRectSize))
+		return;
+
+	uint2 texel = id * gDivisor;
+	float nearest = abs(gViewZ[texel]);
+	for (uint j = 0; j < gDivisor; j++)
+	{
+		for (uint i = 0; i < gDivisor; i++)
+		{
+			uint2 s = id * gDivisor + uint2(i, j);
+			if (any(s >= gRectSize))
+				continue;
+
+			float z = abs(gViewZ[s]);
+			if (z < nearest)
+			{
+				nearest = z;
+				texel = s;
+			}
+		}
+	}
+
+	[unroll]
+	for (uint k = 0; k < 8; k++)
+	{
+		if (k < gCount)
+			gOutputs[k][id] = gInputs[k][texel];
+	}
+}
+)";
+
+
+// Same weights as EvaluateUpsample (NRDUpsample.cpp); the constants are NRD_UPSAMPLE_DEPTH_SCALE and
+// NRD_UPSAMPLE_NORMAL_POWER. Normals are unpacked the way the prepare pass packs them.
+static const char s_upsampleShader[] = R"(
+cbuffer Constants : register(b0)
+{
+	uint2 gRectSize;
+	uint2 gLowRectSize;
+	uint gDivisor;
+	uint gCount;
+	uint gNormalEncoding;
+	uint gHasNormal;
+};
+
+Texture2D<float> gViewZ : register(t0);
+Texture2D<float4> gNormal : register(t1);
+Texture2D<float> gLowViewZ : register(t2);
+Texture2D<float4> gLowNormal : register(t3);
+Texture2D<float4> gLow[8] : register(t4);
+
+RWTexture2D<float4> gOutputs[8] : register(u0);
+
+#define DEPTH_SCALE 0.05
+#define NORMAL_POWER 8.0
+
+float3 DecodeNormal(float4 packed)
+{
+	float3 n;
+	if (gNormalEncoding == 2)
+	{
+		float2 f = packed.xy * 2.0 - 1.0;
+		n = float3(f, 1.0 - abs(f.x) - abs(f.y));
+		float t = saturate(-n.z);
+		n.xy += n.xy >= 0.0 ? -t : t;
+	}
+	else if (gNormalEncoding == 1 || gNormalEncoding == 4)
+		n = packed.xyz;
+	else
+		n = packed.xyz * 2.0 - 1.0;
+
+	float len = length(n);
+	return len > 0.0 ? n / len : n;
+}
+
+[numthreads(8, 8, 1)]
+void main(uint2 id : SV_DispatchThreadID)
+{
+	if (any(id >= gRectSize))
+		return;
+
+	float z = abs(gViewZ[id]);
+	float3 n = gHasNormal ? DecodeNormal(gNormal[id]) : 0.0;
+
+	float2 uv = (float2(id) + 0.5) / (float)gDivisor - 0.5;
+	float2 origin = floor(uv);
+	float2 f = uv - origin;
+
+	int2 taps[4];
+	float weights[4];
+	float sum = 0.0;
+	[unroll]
+	for (int i = 0; i < 4; i++)
+	{
+		int2 d = int2(i & 1, i >> 1);
+		taps[i] = clamp(int2(origin) + d, 0, int2(gLowRectSize) - 1);
+
+		float w = (d.x ? f.x : 1.0 - f.x) * (d.y ? f.y : 1.0 - f.y);
+		w *= exp(-abs(abs(gLowViewZ[taps[i]]) - z) / (DEPTH_SCALE * max(z, 1e-6)));
+		if (gHasNormal)
+			w *= pow(saturate(dot(n, DecodeNormal(gLowNormal[taps[i]]))), NORMAL_POWER);
+
+		weights[i] = w;
+		sum += w;
+	}
+
+	// Every tap is on another surface — take the one closest in depth
+	if (sum < 1e-6)
+	{
+		int closest = 0;
+		float closestDelta = abs(abs(gLowViewZ[taps[0]]) - z);
+		[unroll]
+		for (int i = 1; i < 4; i++)
+		{
+			float delta = abs(abs(gLowViewZ[taps[i]]) - z);
+			if (delta < closestDelta)
+			{
+				closest = i;
+				closestDelta = delta;
+			}
+		}
+
+		[unroll]
+		for (int i = 0; i < 4; i++)
+			weights[i] = i == closest ? 1.0 : 0.0;
+		sum = 1.0;
+	}
+
+	[unroll]
+	for (uint k = 0; k < 8; k++)
+	{
+		if (k >= gCount)
+			continue;
+
+		float4 value = 0.0;
+		[unroll]
+		for (int i = 0; i < 4; i++)
+			value += weights[i] * gLow[k][taps[i]];
+		gOutputs[k][id] = value / sum;
+	}
+}
+)";
+
+
+bool D3D12DownsamplePass::Create(ID3D12Device* device)
+{
+	return D3D12ComputePass::Create(device, s_downsampleShader, "NRDDownsample", NRD_DOWNSAMPLE_SRV_COUNT, NRD_RESAMPLE_BATCH);
+}
+
+
+bool D3D12UpsamplePass::Create(ID3D12Device* device)
+{
+	return D3D12ComputePass::Create(device, s_upsampleShader, "NRDUpsample", NRD_UPSAMPLE_SRV_COUNT, NRD_RESAMPLE_BATCH);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "D3D12ComputePass.h"
+
+
+// Textures resampled per dispatch; slots with more are covered by several dispatches
+static const int NRD_RESAMPLE_BATCH = 8;
+
+// Downsample table: t0 = full-resolution view Z, t1.. = inputs, u0.. = their reduced copies
+static const int NRD_DOWNSAMPLE_SRV_COUNT = 1 + NRD_RESAMPLE_BATCH;
+
+// Upsample table: the four guides below, then t4.. = reduced outputs, u0.. = full-resolution outputs
+enum NRDUpsampleGuide
+{
+	NRD_UPSAMPLE_GUIDE_VIEWZ,
+	NRD_UPSAMPLE_GUIDE_NORMAL,     // IN_NORMAL_ROUGHNESS, optional
+	NRD_UPSAMPLE_GUIDE_LOW_VIEWZ,
+	NRD_UPSAMPLE_GUIDE_LOW_NORMAL,
+	NRD_UPSAMPLE_GUIDE_COUNT
+};
+
+static const int NRD_UPSAMPLE_SRV_COUNT = NRD_UPSAMPLE_GUIDE_COUNT + NRD_RESAMPLE_BATCH;
+
+
+// Constant buffer of one resample dispatch (layout matches both shaders' cbuffer)
+struct NRDResampleConstants
+{
+	uint32_t rectSize[2];    // Full-resolution render rect
+	uint32_t lowRectSize[2]; // Reduced render rect NRD runs on
+	uint32_t divisor;
+	uint32_t count;          // Textures bound in this dispatch
+	uint32_t normalEncoding; // nrd::NormalEncoding of the loaded NRD (upsample)
+	uint32_t hasNormal;      // Normal guides bound (upsample)
+};
+
+
+// Mixed-resolution inputs: one dispatch over the reduced rect copies each input from the nearest
+// texel of its block (GetDownsampleTexel, NRDUpsample.h)
+class D3D12DownsamplePass : public D3D12ComputePass
+{
+public:
+	bool Create(ID3D12Device* device);
+};
+
+
+// Mixed-resolution outputs: one dispatch over the full rect blends NRD's reduced outputs with
+// depth/normal-aware weights (EvaluateUpsample, NRDUpsample.h)
+class D3D12UpsamplePass : public D3D12ComputePass
+{
+public:
+	bool Create(ID3D12Device* device);
+};
@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "D3DCommandQueue.h"
+#include "D3DFenceEncoding.h"
 
 
 Direct3DQueue::Direct3DQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE commandType)
@@ -10,8 +11,8 @@ Direct3DQueue::Direct3DQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE comma
 	mQueueType = commandType;
 	mCommandQueue = NULL;
 	mFence = NULL;
-	mNextFenceValue = ((uint64_t)mQueueType << 56) + 1;
-	mLastCompletedFenceValue = ((uint64_t)mQueueType << 56);
+	mNextFenceValue = MakeQueueFenceValue(mQueueType, 1);
+	mLastCompletedFenceValue = MakeQueueFenceBase(mQueueType);
 
 	D3D12_COMMAND_QUEUE_DESC queueDesc = {};
 	queueDesc.Type = mQueueType;
@@ -141,13 +142,13 @@ Direct3DQueue* Direct3DQueueManager::GetQueue(D3D12_COMMAND_LIST_TYPE commandTyp
 
 bool Direct3DQueueManager::IsFenceComplete(UINT64 fenceValue)
 {
-	return GetQueue((D3D12_COMMAND_LIST_TYPE)(fenceValue >> 56))->IsFenceComplete(fenceValue);
+	return GetQueue((D3D12_COMMAND_LIST_TYPE)GetFenceQueueType(fenceValue))->IsFenceComplete(fenceValue);
 }
 
 
 void Direct3DQueueManager::WaitForFenceCPUBlocking(UINT64 fenceValue)
 {
-	Direct3DQueue* commandQueue = GetQueue((D3D12_COMMAND_LIST_TYPE)(fenceValue >> 56));
+	Direct3DQueue* commandQueue = GetQueue((D3D12_COMMAND_LIST_TYPE)GetFenceQueueType(fenceValue));
 	commandQueue->WaitForFenceCPUBlocking(fenceValue);
 }
 
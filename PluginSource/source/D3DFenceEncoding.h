@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+
+// Fence value encoding shared by Direct3DQueue and Direct3DQueueManager.
+// Each queue's fence values carry the queue's D3D12_COMMAND_LIST_TYPE in the top 8 bits, so a bare
+// fence value identifies the queue it belongs to and values from different queues never collide.
+// Kept free of D3D12 headers so it can be exercised on the host.
+
+static const int kFenceQueueTypeShift = 56;
+static const uint64_t kFenceCounterMask = (1ull << kFenceQueueTypeShift) - 1;
+
+// First value signaled by a queue of the given type (the "already completed" baseline)
+inline uint64_t MakeQueueFenceBase(uint32_t queueType)
+{
+	return (uint64_t)(queueType & 0xFF) << kFenceQueueTypeShift;
+}
+
+inline uint64_t MakeQueueFenceValue(uint32_t queueType, uint64_t counter)
+{
+	return MakeQueueFenceBase(queueType) | (counter & kFenceCounterMask);
+}
+
+inline uint32_t GetFenceQueueType(uint64_t fenceValue)
+{
+	return (uint32_t)(fenceValue >> kFenceQueueTypeShift);
+}
+
+inline uint64_t GetFenceCounter(uint64_t fenceValue)
+{
+	return fenceValue & kFenceCounterMask;
+}
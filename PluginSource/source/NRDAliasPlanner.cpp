@@ -0,0 +1,120 @@
+#include "NRDAliasPlanner.h"
+
+
+static bool LifetimesOverlap(const AliasRequest& a, const AliasRequest& b)
+{
+	return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+}
+
+
+static bool MemoryOverlaps(const AliasRequest& a, const AliasPlacement& pa, const AliasRequest& b, const AliasPlacement& pb)
+{
+	return a.size != 0 && b.size != 0 && pa.offset < pb.offset + b.size && pb.offset < pa.offset + a.size;
+}
+
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	if (alignment <= 1)
+		return value;
+
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+// Placement order: largest first, then earliest use, then input order (deterministic plans)
+static bool PlacesBefore(const AliasRequest* requests, int a, int b)
+{
+	if (requests[a].size != requests[b].size)
+		return requests[a].size > requests[b].size;
+	if (requests[a].firstUse != requests[b].firstUse)
+		return requests[a].firstUse < requests[b].firstUse;
+	return a < b;
+}
+
+
+uint64_t PlanAliasing(const AliasRequest* requests, int count, AliasPlacement* placements)
+{
+	if (count <= 0 || count > NRD_ALIAS_MAX_REQUESTS)
+		return 0;
+
+	int order[NRD_ALIAS_MAX_REQUESTS];
+	for (int i = 0; i < count; i++)
+	{
+		int j = i;
+		while (j > 0 && PlacesBefore(requests, i, order[j - 1]))
+		{
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = i;
+	}
+
+	uint64_t heapSize = 0;
+
+	for (int n = 0; n < count; n++)
+	{
+		int index = order[n];
+		const AliasRequest& request = requests[index];
+
+		// Already placed blocks live at the same time, sorted by offset
+		int conflicts[NRD_ALIAS_MAX_REQUESTS];
+		int conflictCount = 0;
+		for (int p = 0; p < n; p++)
+		{
+			int other = order[p];
+			if (!LifetimesOverlap(request, requests[other]) || requests[other].size == 0)
+				continue;
+
+			int j = conflictCount++;
+			while (j > 0 && placements[conflicts[j - 1]].offset > placements[other].offset)
+			{
+				conflicts[j] = conflicts[j - 1];
+				j--;
+			}
+			conflicts[j] = other;
+		}
+
+		// First fit: the lowest aligned offset below the next conflicting range, or past it
+		uint64_t offset = 0;
+		for (int c = 0; c < conflictCount; c++)
+		{
+			offset = AlignUp(offset, request.alignment);
+
+			uint64_t begin = placements[conflicts[c]].offset;
+			uint64_t end = begin + requests[conflicts[c]].size;
+			if (offset + request.size <= begin)
+				break;
+
+			if (end > offset)
+				offset = end;
+		}
+		offset = AlignUp(offset, request.alignment);
+
+		placements[index].offset = offset;
+		placements[index].aliasBefore = -1;
+
+		if (offset + request.size > heapSize)
+			heapSize = offset + request.size;
+	}
+
+	// Memory shared with a block means their lifetimes are disjoint; the latest earlier occupant
+	// is the one whose contents the aliasing barrier discards
+	for (int i = 0; i < count; i++)
+	{
+		for (int j = 0; j < count; j++)
+		{
+			if (i == j || requests[j].lastUse >= requests[i].firstUse)
+				continue;
+
+			if (!MemoryOverlaps(requests[i], placements[i], requests[j], placements[j]))
+				continue;
+
+			int current = placements[i].aliasBefore;
+			if (current < 0 || requests[j].lastUse > requests[current].lastUse)
+				placements[i].aliasBefore = j;
+		}
+	}
+
+	return heapSize;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Upper bound on blocks planned at once (one transient pool per live slot in practice)
+static const int NRD_ALIAS_MAX_REQUESTS = 64;
+
+
+// One memory block to place in a shared heap. Uses are positions in the frame's execution order;
+// the block is live from firstUse to lastUse inclusive.
+struct AliasRequest
+{
+	uint64_t size;
+	uint64_t alignment; // Power of two (0 or 1 = unaligned)
+	int firstUse;
+	int lastUse;
+};
+
+
+struct AliasPlacement
+{
+	uint64_t offset;
+	// Block whose memory this one reuses most recently (the "before" resource of the aliasing
+	// barrier to issue ahead of firstUse), or -1 when the range was never used earlier in the frame
+	int aliasBefore;
+};
+
+
+// Place every request in one heap so blocks with overlapping lifetimes never share bytes, while
+// blocks that are never live together may. This is interval coloring with sizes; it is solved
+// greedily (largest first, lowest aligned offset that fits), which is optimal when all lifetimes
+// are disjoint — the heap then equals the largest block. Not used by the backend yet: NRD's
+// integration layer allocates its pools itself and has no hook for placing them in a shared heap.
+//
+// Returns the heap size; placements[i] belongs to requests[i]. Returns 0 (and places nothing)
+// if count is out of range.
+uint64_t PlanAliasing(const AliasRequest* requests, int count, AliasPlacement* placements);
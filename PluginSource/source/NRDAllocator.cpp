@@ -0,0 +1,304 @@
+#include "NRDAllocator.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Precedes every payload. A block is what came from upstream; the payload sits `offset` bytes
+// into it — right after the header, or further in when the caller asked for more than 16-byte
+// alignment.
+struct BlockHeader
+{
+	uint32_t sizeClass; // NRD_ALLOCATOR_SIZE_CLASSES for large blocks
+	uint32_t offset;    // Payload offset from the start of the block
+	uint64_t size;      // Block size
+};
+
+static const size_t HEADER_SIZE = 16;
+static const size_t BLOCK_ALIGNMENT = 16;
+static_assert(sizeof(BlockHeader) == HEADER_SIZE, "payloads must stay 16-byte aligned");
+
+
+static std::atomic<uint64_t> s_upstreamAllocations(0);
+static std::atomic<uint64_t> s_renderThreadUpstreamAllocations(0);
+static std::atomic<uint64_t> s_reservedBytes(0);
+static thread_local bool s_isRenderThread = false;
+
+
+static void* CrtAllocate(void*, size_t size, size_t alignment)
+{
+#if _MSC_VER
+	return _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+
+static void CrtFree(void*, void* memory)
+{
+#if _MSC_VER
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+
+static int GetSizeClass(size_t size)
+{
+	int sizeClass = 0;
+	size_t classSize = 16;
+	while (classSize < size)
+	{
+		classSize <<= 1;
+		sizeClass++;
+	}
+
+	return sizeClass;
+}
+
+
+static BlockHeader* GetHeader(void* memory)
+{
+	return (BlockHeader*)((uint8_t*)memory - HEADER_SIZE);
+}
+
+
+// Place the payload in block and write its header
+static void* PlacePayload(void* block, size_t blockSize, uint32_t sizeClass, size_t alignment)
+{
+	uintptr_t payload = ((uintptr_t)block + HEADER_SIZE + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	BlockHeader* header = GetHeader((void*)payload);
+	header->sizeClass = sizeClass;
+	header->offset = (uint32_t)(payload - (uintptr_t)block);
+	header->size = blockSize;
+	return (void*)payload;
+}
+
+
+NRDAllocator::NRDAllocator(const NRDUpstreamAllocator* upstream)
+	: m_upstream()
+	, m_freeLists()
+	, m_largeBlocks()
+	, m_largeSizes()
+	, m_largeCount(0)
+	, m_reservedBytes(0)
+{
+	SetUpstream(upstream);
+}
+
+
+NRDAllocator::~NRDAllocator()
+{
+	Trim();
+}
+
+
+bool NRDAllocator::SetUpstream(const NRDUpstreamAllocator* upstream)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_reservedBytes != 0)
+		return false;
+
+	if (upstream)
+	{
+		m_upstream = *upstream;
+	}
+	else
+	{
+		m_upstream.allocate = CrtAllocate;
+		m_upstream.free = CrtFree;
+		m_upstream.userArg = nullptr;
+	}
+
+	return true;
+}
+
+
+void* NRDAllocator::AllocateUpstream(size_t size)
+{
+	void* block = m_upstream.allocate(m_upstream.userArg, size, BLOCK_ALIGNMENT);
+	if (block == nullptr)
+		return nullptr;
+
+	m_reservedBytes += size;
+	s_reservedBytes += size;
+	s_upstreamAllocations++;
+	if (s_isRenderThread)
+		s_renderThreadUpstreamAllocations++;
+
+	return block;
+}
+
+
+void NRDAllocator::FreeUpstream(void* block, size_t size)
+{
+	m_upstream.free(m_upstream.userArg, block);
+	m_reservedBytes -= size;
+	s_reservedBytes -= size;
+}
+
+
+// Smallest cached large block of at least size bytes, removed from the cache; size is updated
+// to the block's actual size
+void* NRDAllocator::TakeLargeBlock(size_t& size)
+{
+	int best = -1;
+	for (int i = 0; i < m_largeCount; i++)
+	{
+		if (m_largeSizes[i] >= size && (best < 0 || m_largeSizes[i] < m_largeSizes[best]))
+			best = i;
+	}
+
+	if (best < 0)
+		return nullptr;
+
+	void* block = m_largeBlocks[best];
+	size = (size_t)m_largeSizes[best];
+	m_largeCount--;
+	m_largeBlocks[best] = m_largeBlocks[m_largeCount];
+	m_largeSizes[best] = m_largeSizes[m_largeCount];
+	return block;
+}
+
+
+void* NRDAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (size == 0)
+		size = 1;
+	if (alignment < BLOCK_ALIGNMENT)
+		alignment = BLOCK_ALIGNMENT;
+
+	// Worst case the payload starts alignment - 16 bytes further in than the header requires
+	size_t needed = size + (alignment - BLOCK_ALIGNMENT);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (needed <= NRD_ALLOCATOR_MAX_POOLED_SIZE)
+	{
+		int sizeClass = GetSizeClass(needed);
+		size_t blockSize = HEADER_SIZE + ((size_t)16 << sizeClass);
+
+		void* block = m_freeLists[sizeClass];
+		if (block)
+			m_freeLists[sizeClass] = *(void**)block;
+		else if ((block = AllocateUpstream(blockSize)) == nullptr)
+			return nullptr;
+
+		return PlacePayload(block, blockSize, (uint32_t)sizeClass, alignment);
+	}
+
+	size_t blockSize = HEADER_SIZE + needed;
+	void* block = TakeLargeBlock(blockSize);
+	if (block == nullptr && (block = AllocateUpstream(blockSize)) == nullptr)
+		return nullptr;
+
+	return PlacePayload(block, blockSize, NRD_ALLOCATOR_SIZE_CLASSES, alignment);
+}
+
+
+void NRDAllocator::Free(void* memory)
+{
+	if (memory == nullptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	BlockHeader* header = GetHeader(memory);
+	void* block = (uint8_t*)memory - header->offset;
+	uint32_t sizeClass = header->sizeClass;
+	uint64_t blockSize = header->size;
+
+	if (sizeClass < NRD_ALLOCATOR_SIZE_CLASSES)
+	{
+		*(void**)block = m_freeLists[sizeClass];
+		m_freeLists[sizeClass] = block;
+		return;
+	}
+
+	if (m_largeCount == NRD_ALLOCATOR_LARGE_CACHE)
+	{
+		FreeUpstream(block, (size_t)blockSize);
+		return;
+	}
+
+	m_largeBlocks[m_largeCount] = block;
+	m_largeSizes[m_largeCount] = blockSize;
+	m_largeCount++;
+}
+
+
+void* NRDAllocator::Reallocate(void* memory, size_t size, size_t alignment)
+{
+	if (memory == nullptr)
+		return Allocate(size, alignment);
+
+	// Still fits (and keeps its alignment) — nothing to move
+	BlockHeader* header = GetHeader(memory);
+	size_t capacity = (size_t)(header->size - header->offset);
+	if (size <= capacity && (alignment <= 1 || ((uintptr_t)memory & (alignment - 1)) == 0))
+		return memory;
+
+	void* moved = Allocate(size, alignment);
+	if (moved == nullptr)
+		return nullptr;
+
+	memcpy(moved, memory, capacity < size ? capacity : size);
+	Free(memory);
+	return moved;
+}
+
+
+void NRDAllocator::Trim()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (int i = 0; i < NRD_ALLOCATOR_SIZE_CLASSES; i++)
+	{
+		while (m_freeLists[i])
+		{
+			void* block = m_freeLists[i];
+			m_freeLists[i] = *(void**)block;
+			FreeUpstream(block, HEADER_SIZE + ((size_t)16 << i));
+		}
+	}
+
+	for (int i = 0; i < m_largeCount; i++)
+		FreeUpstream(m_largeBlocks[i], (size_t)m_largeSizes[i]);
+	m_largeCount = 0;
+}
+
+
+void* NRDAllocator::AllocateCallback(void* userArg, size_t size, size_t alignment)
+{
+	return ((NRDAllocator*)userArg)->Allocate(size, alignment);
+}
+
+
+void* NRDAllocator::ReallocateCallback(void* userArg, void* memory, size_t size, size_t alignment)
+{
+	return ((NRDAllocator*)userArg)->Reallocate(memory, size, alignment);
+}
+
+
+void NRDAllocator::FreeCallback(void* userArg, void* memory)
+{
+	((NRDAllocator*)userArg)->Free(memory);
+}
+
+
+void NRDAllocator::MarkRenderThread()
+{
+	s_isRenderThread = true;
+}
+
+
+void NRDAllocator::GetStats(NRDAllocatorStats& stats)
+{
+	stats.upstreamAllocations = s_upstreamAllocations;
+	stats.renderThreadUpstreamAllocations = s_renderThreadUpstreamAllocations;
+	stats.reservedBytes = s_reservedBytes;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+
+// Pooled size classes: 16, 32, ... 64 KB (request size plus any over-alignment slack)
+static const int NRD_ALLOCATOR_SIZE_CLASSES = 13;
+static const size_t NRD_ALLOCATOR_MAX_POOLED_SIZE = (size_t)16 << (NRD_ALLOCATOR_SIZE_CLASSES - 1);
+
+// Freed blocks above the largest class kept for reuse; more are returned upstream right away
+static const int NRD_ALLOCATOR_LARGE_CACHE = 8;
+
+
+// Where pooled blocks come from — the CRT by default, or Unity's memory manager so the plugin's
+// CPU memory shows up in Unity's memory profiler
+struct NRDUpstreamAllocator
+{
+	void* (*allocate)(void* userArg, size_t size, size_t alignment);
+	void (*free)(void* userArg, void* memory);
+	void* userArg;
+};
+
+
+// Process-wide counters over every NRDAllocator (any thread)
+struct NRDAllocatorStats
+{
+	uint64_t upstreamAllocations;             // Blocks requested from the upstream allocator
+	uint64_t renderThreadUpstreamAllocations; // Part of them requested from the render thread
+	uint64_t reservedBytes;                   // Bytes currently held from upstream, pooled or in use
+};
+
+
+// Size-class pool behind the NRD and NRI allocation callbacks. Freed blocks go to a per-class
+// free list (or, above 64 KB, a small best-fit cache) and are handed out again, so once every
+// object NRD/NRI create and destroy per frame has been allocated once, a frame makes no upstream
+// allocations. Memory only returns upstream on Trim (or destruction).
+//
+// Thread safe — the shared NRI device allocates from the render thread and from background
+// initialization workers.
+class NRDAllocator
+{
+public:
+	explicit NRDAllocator(const NRDUpstreamAllocator* upstream = nullptr);
+	~NRDAllocator();
+
+	// Switch the upstream allocator (null = CRT). Only while nothing is reserved from the old one.
+	bool SetUpstream(const NRDUpstreamAllocator* upstream);
+
+	void* Allocate(size_t size, size_t alignment);
+	void* Reallocate(void* memory, size_t size, size_t alignment);
+	void Free(void* memory);
+
+	// Return every pooled (free) block upstream
+	void Trim();
+
+	// Adapters with the NRD / NRI callback signatures; userArg is the NRDAllocator
+	static void* AllocateCallback(void* userArg, size_t size, size_t alignment);
+	static void* ReallocateCallback(void* userArg, void* memory, size_t size, size_t alignment);
+	static void FreeCallback(void* userArg, void* memory);
+
+	// Tag the calling thread as the render thread for NRDAllocatorStats
+	static void MarkRenderThread();
+	static void GetStats(NRDAllocatorStats& stats);
+
+private:
+	NRDAllocator(const NRDAllocator&) = delete;
+	NRDAllocator& operator=(const NRDAllocator&) = delete;
+
+	void* AllocateUpstream(size_t size);
+	void FreeUpstream(void* block, size_t size);
+	void* TakeLargeBlock(size_t& size);
+
+	NRDUpstreamAllocator m_upstream;
+	std::mutex m_mutex;
+	void* m_freeLists[NRD_ALLOCATOR_SIZE_CLASSES]; // Free blocks, linked through their first bytes
+	void* m_largeBlocks[NRD_ALLOCATOR_LARGE_CACHE];
+	uint64_t m_largeSizes[NRD_ALLOCATOR_LARGE_CACHE];
+	int m_largeCount;
+	uint64_t m_reservedBytes;
+};
@@ -0,0 +1,42 @@
+#include "NRDCheckerboard.h"
+
+
+int GetCheckerboardPhase(int mode, uint32_t frameIndex, bool specular)
+{
+	if (mode != NRD_CHECKERBOARD_BLACK && mode != NRD_CHECKERBOARD_WHITE)
+		return -1;
+
+	// NRD: a pixel has data when ((x ^ y ^ frameIndex) & 1) equals 0 for the diffuse signal in
+	// BLACK mode and 1 in WHITE mode; specular takes the opposite pixels
+	uint32_t value = mode == NRD_CHECKERBOARD_BLACK ? 0 : 1;
+	if (specular)
+		value ^= 1;
+
+	return (int)((value ^ frameIndex) & 1);
+}
+
+
+bool IsCheckerboardInput(nrd::ResourceType type)
+{
+	switch (type)
+	{
+	case nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST:
+	case nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST:
+	case nrd::ResourceType::IN_DIFF_HITDIST:
+	case nrd::ResourceType::IN_SPEC_HITDIST:
+	case nrd::ResourceType::IN_DIFF_DIRECTION_HITDIST:
+	case nrd::ResourceType::IN_DIFF_SH0:
+	case nrd::ResourceType::IN_DIFF_SH1:
+	case nrd::ResourceType::IN_SPEC_SH0:
+	case nrd::ResourceType::IN_SPEC_SH1:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+int GetCheckerboardInputWidth(int mode, int renderWidth)
+{
+	return mode == NRD_CHECKERBOARD_OFF ? renderWidth : (renderWidth + 1) / 2;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "NRDDenoiserConfig.h"
+
+
+// Checkerboard (half-rate) input for REBLUR and RELAX — values match nrd::CheckerboardMode. Each
+// frame only half of the pixels carry a signal, packed into the left half of the signal inputs:
+// traced pixel (x, y) is stored at (x / 2, y). Diffuse and specular trace complementary pixels.
+enum NRDCheckerboardMode
+{
+	NRD_CHECKERBOARD_OFF = 0,
+	NRD_CHECKERBOARD_BLACK = 1, // Diffuse traces the pixels of NRD's "black" phase, specular the others
+	NRD_CHECKERBOARD_WHITE = 2
+};
+
+
+// The pixels traced this frame for one signal are those with ((x ^ y) & 1) == phase; -1 = every
+// pixel (OFF). Follows NRD's own reconstruction, which alternates with CommonSettings::frameIndex.
+int GetCheckerboardPhase(int mode, uint32_t frameIndex, bool specular);
+
+// Inputs holding a checkerboarded signal (the rest — guides, confidence — stay full size)
+bool IsCheckerboardInput(nrd::ResourceType type);
+
+// Width a checkerboarded input needs at least, for a render width
+int GetCheckerboardInputWidth(int mode, int renderWidth);
@@ -0,0 +1,64 @@
+#include "NRDCommandChannel.h"
+
+
+NRDCommandChannel::NRDCommandChannel()
+	: m_enqueuePos(0)
+	, m_dequeuePos(0)
+{
+	for (size_t i = 0; i < NRD_COMMAND_CHANNEL_CAPACITY; i++)
+		m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+
+bool NRDCommandChannel::TryPush(NRDCommand& command)
+{
+	size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+	Cell* cell;
+
+	for (;;)
+	{
+		cell = &m_cells[pos & kMask];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+		if (diff == 0)
+		{
+			// Cell is free for this position — claim it
+			if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			// Cell still holds an unconsumed command from one lap ago — queue is full
+			return false;
+		}
+		else
+		{
+			// Another producer claimed this position first
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Taken from the claimed position rather than before the push: two producers can claim in the
+	// opposite order to anything they numbered themselves
+	command.sequence = pos + 1;
+	cell->command = command;
+	cell->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+
+bool NRDCommandChannel::TryPop(NRDCommand& command)
+{
+	Cell& cell = m_cells[m_dequeuePos & kMask];
+	size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+	// Not yet published by its producer (or queue empty)
+	if ((intptr_t)sequence - (intptr_t)(m_dequeuePos + 1) < 0)
+		return false;
+
+	command = cell.command;
+	cell.sequence.store(m_dequeuePos + NRD_COMMAND_CHANNEL_CAPACITY, std::memory_order_release);
+	m_dequeuePos++;
+	return true;
+}
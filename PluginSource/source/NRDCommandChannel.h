@@ -0,0 +1,80 @@
+#pragma once
+
+#include "NRDSlotLimits.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Commands posted by the exported (main thread) API and applied on the render thread
+enum class NRDCommandType : uint32_t
+{
+	INITIALIZE,          // slot = denoiser type
+	INITIALIZE_GROUP,    // slot = NRD_DENOISER_COUNT + groupIndex
+	INITIALIZE_ASYNC,    // slot = denoiser type; instance is created on a worker thread
+	RELEASE,
+	RELEASE_ALL,         // slot unused
+	SET_LIGHT_DIRECTION, // slot unused
+	SET_QUEUE_MODE,
+	SET_MEMORY_POLICY,   // slot unused
+	SET_PREPARE_SOURCES, // resources = NRDPrepareSource textures
+	SET_INPUT_CONVENTIONS,
+	SET_COMPOSITE_TARGET, // resources = target, then NRDCompositeSource textures
+	SET_RESOLUTION_SCALE,
+	SET_CHECKERBOARD_MODE
+};
+
+
+// Self-contained copy of an API call's arguments — nothing in it points back into caller memory
+// except the native resource pointers themselves.
+struct NRDCommand
+{
+	NRDCommandType type;
+	int slot;
+	uint64_t sequence; // Assigned by TryPush in queue order; published per slot once the command has been applied
+
+	int renderWidth;
+	int renderHeight;
+	int denoiserTypes[MAX_GROUP_DENOISERS];
+	int denoiserCount;
+	void* resources[MAX_GROUP_RESOURCES];
+	int resourceCount;
+
+	float vector[3];
+	int value;
+	bool flag;
+	uint64_t bytes;
+};
+
+
+// Must be a power of 2
+static const int NRD_COMMAND_CHANNEL_CAPACITY = 128;
+
+
+// Bounded lock-free multi-producer / single-consumer command queue (D. Vyukov's bounded queue:
+// each cell carries a sequence number telling producers and the consumer whose turn it is).
+// Any thread may TryPush; only the render thread calls TryPop. Neither side ever blocks —
+// a full queue makes TryPush fail instead. TryPush stamps each command with its queue position
+// (counting from 1), so sequences rise in exactly the order the consumer pops them.
+class NRDCommandChannel
+{
+public:
+	NRDCommandChannel();
+
+	bool TryPush(NRDCommand& command);
+	bool TryPop(NRDCommand& command);
+
+private:
+	static const size_t kMask = NRD_COMMAND_CHANNEL_CAPACITY - 1;
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		NRDCommand command;
+	};
+
+	Cell m_cells[NRD_COMMAND_CHANNEL_CAPACITY];
+	alignas(64) std::atomic<size_t> m_enqueuePos;
+	alignas(64) size_t m_dequeuePos; // Consumer only
+};
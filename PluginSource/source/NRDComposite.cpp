@@ -0,0 +1,110 @@
+#include "NRDComposite.h"
+
+#include <math.h>
+
+
+static float Saturate(float x)
+{
+	return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+
+void LinearToYCoCg(const float color[3], float ycocg[3])
+{
+	ycocg[0] = 0.25f * color[0] + 0.5f * color[1] + 0.25f * color[2];
+	ycocg[1] = 0.5f * color[0] - 0.5f * color[2];
+	ycocg[2] = -0.25f * color[0] + 0.5f * color[1] - 0.25f * color[2];
+}
+
+
+void YCoCgToLinear(const float ycocg[3], float color[3])
+{
+	float t = ycocg[0] - ycocg[2];
+	color[0] = fmaxf(t + ycocg[1], 0.0f);
+	color[1] = fmaxf(ycocg[0] + ycocg[2], 0.0f);
+	color[2] = fmaxf(t - ycocg[1], 0.0f);
+}
+
+
+void ResolveSh(const float sh0[4], const float sh1[4], const float normal[3], float color[3])
+{
+	float y = sh0[0];
+	if (y <= 0.0f)
+	{
+		color[0] = color[1] = color[2] = 0.0f;
+		return;
+	}
+
+	// r = 0: flat lobe, the normal doesn't matter. r = 1: all light from one direction.
+	float length = sqrtf(sh1[0] * sh1[0] + sh1[1] * sh1[1] + sh1[2] * sh1[2]);
+	float r = Saturate(length / y);
+	float q = 0.5f;
+	if (length > 0.0f)
+		q = 0.5f + 0.5f * (sh1[0] * normal[0] + sh1[1] * normal[1] + sh1[2] * normal[2]) / length;
+
+	float p = 1.0f + 2.0f * r;
+	float a = (1.0f - r) / (1.0f + r);
+	float resolved = y * (a + (1.0f - a) * (p + 1.0f) * powf(Saturate(q), p));
+
+	float scale = resolved / y;
+	float ycocg[3] = { resolved, sh0[1] * scale, sh0[2] * scale };
+	YCoCgToLinear(ycocg, color);
+}
+
+
+// One signal (diffuse or specular) as linear RGB
+static void ResolveSignal(const float radiance[4], const float sh1[4], const float normal[3], bool sh, bool ycocg, float color[3])
+{
+	if (sh)
+		ResolveSh(radiance, sh1, normal, color);
+	else if (ycocg)
+		YCoCgToLinear(radiance, color);
+	else
+	{
+		color[0] = radiance[0];
+		color[1] = radiance[1];
+		color[2] = radiance[2];
+	}
+}
+
+
+void EvaluateComposite(const NRDCompositeTexel& texel, uint32_t flags, float result[4])
+{
+	bool remodulate = (flags & NRD_COMPOSITE_REMODULATE) != 0;
+	bool ycocg = (flags & NRD_COMPOSITE_YCOCG) != 0;
+
+	// Only SH resolves need the normal
+	float normal[3] = { 0.0f, 0.0f, 0.0f };
+	if (flags & (NRD_COMPOSITE_DIFFUSE_SH | NRD_COMPOSITE_SPECULAR_SH))
+	{
+		for (int i = 0; i < 3; i++)
+			normal[i] = texel.normal[i] * 2.0f - 1.0f;
+
+		float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		for (int i = 0; length > 0.0f && i < 3; i++)
+			normal[i] /= length;
+	}
+
+	float color[3] = { 0.0f, 0.0f, 0.0f };
+
+	if (flags & NRD_COMPOSITE_DIFFUSE)
+	{
+		float diffuse[3];
+		ResolveSignal(texel.diffuse, texel.diffuseSh1, normal, (flags & NRD_COMPOSITE_DIFFUSE_SH) != 0, ycocg, diffuse);
+		for (int i = 0; i < 3; i++)
+			color[i] += remodulate ? diffuse[i] * texel.albedo[i] : diffuse[i];
+	}
+
+	if (flags & NRD_COMPOSITE_SPECULAR)
+	{
+		float specular[3];
+		ResolveSignal(texel.specular, texel.specularSh1, normal, (flags & NRD_COMPOSITE_SPECULAR_SH) != 0, ycocg, specular);
+		for (int i = 0; i < 3; i++)
+			color[i] += remodulate ? specular[i] * texel.specularAlbedo[i] : specular[i];
+	}
+
+	bool add = (flags & NRD_COMPOSITE_ADD_BASE) != 0;
+	for (int i = 0; i < 3; i++)
+		result[i] = add ? texel.base[i] + color[i] : color[i];
+	result[3] = add ? texel.base[3] : 1.0f;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Composite stage flags. REMODULATE is the caller's option (NRDSetCompositeTarget); the rest
+// describe what is bound and are set by the plugin. The composite shader mirrors
+// EvaluateComposite bit for bit — keep both in sync.
+enum NRDCompositeFlags : uint32_t
+{
+	NRD_COMPOSITE_REMODULATE = 1 << 0,     // Multiply diffuse by albedo and specular by specular albedo
+	NRD_COMPOSITE_ADD_BASE = 1 << 1,       // Add the base texture's rgb (keeping its alpha) instead of writing alpha 1
+	NRD_COMPOSITE_OPTIONS = NRD_COMPOSITE_REMODULATE,
+
+	NRD_COMPOSITE_DIFFUSE = 1 << 2,        // OUT_DIFF_RADIANCE_HITDIST, or OUT_DIFF_SH0/SH1 with DIFFUSE_SH
+	NRD_COMPOSITE_SPECULAR = 1 << 3,       // OUT_SPEC_RADIANCE_HITDIST, or OUT_SPEC_SH0/SH1 with SPECULAR_SH
+	NRD_COMPOSITE_DIFFUSE_SH = 1 << 4,
+	NRD_COMPOSITE_SPECULAR_SH = 1 << 5,
+	NRD_COMPOSITE_YCOCG = 1 << 6           // Radiance outputs hold YCoCg (REBLUR); SH outputs always do
+};
+
+
+// One pixel's composite inputs, as read from their textures. Mirrors the C# struct passed to
+// NRDEvaluateComposite — keep the layout in sync.
+struct NRDCompositeTexel
+{
+	float diffuse[4];        // OUT_DIFF_RADIANCE_HITDIST or OUT_DIFF_SH0
+	float diffuseSh1[4];     // OUT_DIFF_SH1
+	float specular[4];       // OUT_SPEC_RADIANCE_HITDIST or OUT_SPEC_SH0
+	float specularSh1[4];    // OUT_SPEC_SH1
+	float albedo[4];         // Diffuse albedo (Unity GBuffer0.rgb)
+	float specularAlbedo[4]; // Specular albedo / F0 (Unity GBuffer1.rgb)
+	float normal[4];         // World normal * 0.5 + 0.5 (Unity GBuffer2.rgb)
+	float base[4];           // Base color the result is added to (e.g. direct lighting), with NRD_COMPOSITE_ADD_BASE
+};
+
+
+// NRD's YCoCg transform (NRD.hlsli _NRD_LinearToYCoCg / _NRD_YCoCgToLinear)
+void LinearToYCoCg(const float color[3], float ycocg[3]);
+void YCoCgToLinear(const float ycocg[3], float color[3]);
+
+// Radiance of an SH output pair toward normal (unit length). sh0 = (Y, Co, Cg, hit distance),
+// sh1.xyz = luminance-weighted average direction. The luminance is reconstructed from the L1
+// lobe with the Geomerics non-negative fit, and the chroma scaled along with it.
+void ResolveSh(const float sh0[4], const float sh1[4], const float normal[3], float color[3]);
+
+// Reference for the composite stage: the value it writes to the target for one pixel
+void EvaluateComposite(const NRDCompositeTexel& texel, uint32_t flags, float result[4]);
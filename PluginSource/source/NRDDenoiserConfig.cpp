@@ -1,8 +1,10 @@
 #include "NRDDenoiserConfig.h"
 
 // Master resource layout table for all 19 NRD denoiser types.
-// Resource order per entry: common inputs first, type-specific inputs, then outputs.
-// The C# caller must pack resources in this exact order.
+// Resource order per entry: common inputs first, type-specific inputs, outputs, then the
+// optional inputs added after the table was first published. The C# caller must pack resources
+// in this exact order, passing null for an optional slot it doesn't provide; the trailing run
+// of optional inputs may be left off entirely, so arrays packed for the older layout still work.
 //
 // Common inputs (used by most denoisers):
 //   IN_MV, IN_NORMAL_ROUGHNESS, IN_VIEWZ
@@ -10,44 +12,53 @@
 //   SIGMA_SHADOW/TRANSLUCENCY: IN_VIEWZ required (used in classify, blur, post-blur, temporal stabilization, split screen)
 //   REFERENCE: no common inputs
 //
-// IN_BASECOLOR_METALNESS is included for REBLUR/RELAX types that use stabilization.
+// Optional slots (isOptional) enable an NRD feature only when bound:
+//   IN_BASECOLOR_METALNESS        - isBaseColorMetalnessAvailable (kept in its original position)
+//   IN_DIFF/SPEC_CONFIDENCE       - isHistoryConfidenceAvailable
+//   IN_DISOCCLUSION_THRESHOLD_MIX - isDisocclusionThresholdMixAvailable
 
 const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 {
 	// [0] REBLUR_DIFFUSE
-	// INPUTS: IN_DIFF_RADIANCE_HITDIST (optional: IN_DIFF_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX)
+	// INPUTS: IN_DIFF_RADIANCE_HITDIST
 	// OUTPUTS: OUT_DIFF_RADIANCE_HITDIST
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_DIFF_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE, SettingsFamily::REBLUR, 6,
+		nrd::Denoiser::REBLUR_DIFFUSE, SettingsFamily::REBLUR, 8,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [1] REBLUR_DIFFUSE_OCCLUSION
 	// INPUTS: IN_DIFF_HITDIST
 	// OUTPUTS: OUT_DIFF_HITDIST
+	// OPTIONAL: IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_OCCLUSION, SettingsFamily::REBLUR, 5,
+		nrd::Denoiser::REBLUR_DIFFUSE_OCCLUSION, SettingsFamily::REBLUR, 6,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_HITDIST, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [2] REBLUR_DIFFUSE_SH
 	// INPUTS: IN_DIFF_SH0, IN_DIFF_SH1
 	// OUTPUTS: OUT_DIFF_SH0, OUT_DIFF_SH1
+	// OPTIONAL: IN_DIFF_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_SH, SettingsFamily::REBLUR, 7,
+		nrd::Denoiser::REBLUR_DIFFUSE_SH, SettingsFamily::REBLUR, 9,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -56,77 +67,92 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::IN_DIFF_SH1, false },
 			{ nrd::ResourceType::OUT_DIFF_SH0, true },
 			{ nrd::ResourceType::OUT_DIFF_SH1, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [3] REBLUR_SPECULAR
-	// INPUTS: IN_SPEC_RADIANCE_HITDIST (optional: IN_BASECOLOR_METALNESS)
+	// INPUTS: IN_SPEC_RADIANCE_HITDIST
 	// OUTPUTS: OUT_SPEC_RADIANCE_HITDIST
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_SPECULAR, SettingsFamily::REBLUR, 6,
+		nrd::Denoiser::REBLUR_SPECULAR, SettingsFamily::REBLUR, 8,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [4] REBLUR_SPECULAR_OCCLUSION
 	// INPUTS: IN_SPEC_HITDIST
 	// OUTPUTS: OUT_SPEC_HITDIST
+	// OPTIONAL: IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_SPECULAR_OCCLUSION, SettingsFamily::REBLUR, 5,
+		nrd::Denoiser::REBLUR_SPECULAR_OCCLUSION, SettingsFamily::REBLUR, 6,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_SPEC_HITDIST, false },
 			{ nrd::ResourceType::OUT_SPEC_HITDIST, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [5] REBLUR_SPECULAR_SH
-	// INPUTS: IN_SPEC_SH0, IN_SPEC_SH1 (optional: IN_BASECOLOR_METALNESS)
+	// INPUTS: IN_SPEC_SH0, IN_SPEC_SH1
 	// OUTPUTS: OUT_SPEC_SH0, OUT_SPEC_SH1
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_SPECULAR_SH, SettingsFamily::REBLUR, 8,
+		nrd::Denoiser::REBLUR_SPECULAR_SH, SettingsFamily::REBLUR, 10,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_SPEC_SH0, false },
 			{ nrd::ResourceType::IN_SPEC_SH1, false },
 			{ nrd::ResourceType::OUT_SPEC_SH0, true },
 			{ nrd::ResourceType::OUT_SPEC_SH1, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [6] REBLUR_DIFFUSE_SPECULAR
-	// INPUTS: IN_DIFF_RADIANCE_HITDIST, IN_SPEC_RADIANCE_HITDIST (optional: IN_BASECOLOR_METALNESS)
+	// INPUTS: IN_DIFF_RADIANCE_HITDIST, IN_SPEC_RADIANCE_HITDIST
 	// OUTPUTS: OUT_DIFF_RADIANCE_HITDIST, OUT_SPEC_RADIANCE_HITDIST
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_DIFF_CONFIDENCE, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, SettingsFamily::REBLUR, 8,
+		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, SettingsFamily::REBLUR, 11,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST, true },
 			{ nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [7] REBLUR_DIFFUSE_SPECULAR_OCCLUSION
 	// INPUTS: IN_DIFF_HITDIST, IN_SPEC_HITDIST
 	// OUTPUTS: OUT_DIFF_HITDIST, OUT_SPEC_HITDIST
+	// OPTIONAL: IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION, SettingsFamily::REBLUR, 7,
+		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION, SettingsFamily::REBLUR, 8,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -135,18 +161,20 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::IN_SPEC_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_HITDIST, true },
 			{ nrd::ResourceType::OUT_SPEC_HITDIST, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [8] REBLUR_DIFFUSE_SPECULAR_SH
-	// INPUTS: IN_DIFF_SH0, IN_DIFF_SH1, IN_SPEC_SH0, IN_SPEC_SH1 (optional: IN_BASECOLOR_METALNESS)
+	// INPUTS: IN_DIFF_SH0, IN_DIFF_SH1, IN_SPEC_SH0, IN_SPEC_SH1
 	// OUTPUTS: OUT_DIFF_SH0, OUT_DIFF_SH1, OUT_SPEC_SH0, OUT_SPEC_SH1
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_DIFF_CONFIDENCE, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_SH, SettingsFamily::REBLUR, 12,
+		nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_SH, SettingsFamily::REBLUR, 15,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_SH0, false },
 			{ nrd::ResourceType::IN_DIFF_SH1, false },
@@ -156,44 +184,53 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::OUT_DIFF_SH1, true },
 			{ nrd::ResourceType::OUT_SPEC_SH0, true },
 			{ nrd::ResourceType::OUT_SPEC_SH1, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [9] REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
 	// INPUTS: IN_DIFF_DIRECTION_HITDIST
 	// OUTPUTS: OUT_DIFF_DIRECTION_HITDIST
+	// OPTIONAL: IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION, SettingsFamily::REBLUR, 5,
+		nrd::Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION, SettingsFamily::REBLUR, 6,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_DIRECTION_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_DIRECTION_HITDIST, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [10] RELAX_DIFFUSE
 	// INPUTS: IN_DIFF_RADIANCE_HITDIST
 	// OUTPUTS: OUT_DIFF_RADIANCE_HITDIST
-	// IN_BASECOLOR_METALNESS included for legacy compatibility
+	// OPTIONAL: IN_BASECOLOR_METALNESS, IN_DIFF_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
+	// IN_BASECOLOR_METALNESS kept in its legacy position for compatibility
 	{
-		nrd::Denoiser::RELAX_DIFFUSE, SettingsFamily::RELAX, 6,
+		nrd::Denoiser::RELAX_DIFFUSE, SettingsFamily::RELAX, 8,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
-			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false },
+			{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [11] RELAX_DIFFUSE_SH
 	// INPUTS: IN_DIFF_SH0, IN_DIFF_SH1
 	// OUTPUTS: OUT_DIFF_SH0, OUT_DIFF_SH1
+	// OPTIONAL: IN_DIFF_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::RELAX_DIFFUSE_SH, SettingsFamily::RELAX, 7,
+		nrd::Denoiser::RELAX_DIFFUSE_SH, SettingsFamily::RELAX, 9,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -202,28 +239,34 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::IN_DIFF_SH1, false },
 			{ nrd::ResourceType::OUT_DIFF_SH0, true },
 			{ nrd::ResourceType::OUT_DIFF_SH1, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [12] RELAX_SPECULAR
 	// INPUTS: IN_SPEC_RADIANCE_HITDIST
 	// OUTPUTS: OUT_SPEC_RADIANCE_HITDIST
+	// OPTIONAL: IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::RELAX_SPECULAR, SettingsFamily::RELAX, 5,
+		nrd::Denoiser::RELAX_SPECULAR, SettingsFamily::RELAX, 7,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
 			{ nrd::ResourceType::IN_VIEWZ, false },
 			{ nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [13] RELAX_SPECULAR_SH
 	// INPUTS: IN_SPEC_SH0, IN_SPEC_SH1
 	// OUTPUTS: OUT_SPEC_SH0, OUT_SPEC_SH1
+	// OPTIONAL: IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::RELAX_SPECULAR_SH, SettingsFamily::RELAX, 7,
+		nrd::Denoiser::RELAX_SPECULAR_SH, SettingsFamily::RELAX, 9,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -232,14 +275,17 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::IN_SPEC_SH1, false },
 			{ nrd::ResourceType::OUT_SPEC_SH0, true },
 			{ nrd::ResourceType::OUT_SPEC_SH1, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [14] RELAX_DIFFUSE_SPECULAR
 	// INPUTS: IN_DIFF_RADIANCE_HITDIST, IN_SPEC_RADIANCE_HITDIST
 	// OUTPUTS: OUT_DIFF_RADIANCE_HITDIST, OUT_SPEC_RADIANCE_HITDIST
+	// OPTIONAL: IN_DIFF_CONFIDENCE, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::RELAX_DIFFUSE_SPECULAR, SettingsFamily::RELAX, 7,
+		nrd::Denoiser::RELAX_DIFFUSE_SPECULAR, SettingsFamily::RELAX, 10,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -248,14 +294,18 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST, false },
 			{ nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST, true },
 			{ nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
 	// [15] RELAX_DIFFUSE_SPECULAR_SH
 	// INPUTS: IN_DIFF_SH0, IN_DIFF_SH1, IN_SPEC_SH0, IN_SPEC_SH1
 	// OUTPUTS: OUT_DIFF_SH0, OUT_DIFF_SH1, OUT_SPEC_SH0, OUT_SPEC_SH1
+	// OPTIONAL: IN_DIFF_CONFIDENCE, IN_SPEC_CONFIDENCE, IN_DISOCCLUSION_THRESHOLD_MIX
 	{
-		nrd::Denoiser::RELAX_DIFFUSE_SPECULAR_SH, SettingsFamily::RELAX, 11,
+		nrd::Denoiser::RELAX_DIFFUSE_SPECULAR_SH, SettingsFamily::RELAX, 14,
 		{
 			{ nrd::ResourceType::IN_MV, false },
 			{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false },
@@ -268,6 +318,9 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 			{ nrd::ResourceType::OUT_DIFF_SH1, true },
 			{ nrd::ResourceType::OUT_SPEC_SH0, true },
 			{ nrd::ResourceType::OUT_SPEC_SH1, true },
+			{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+			{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
 		}
 	},
 
@@ -315,3 +368,198 @@ const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT] =
 		}
 	},
 };
+
+
+// Index where the trailing run of optional inputs starts (count if there is none)
+static int GetTrailingOptionalStart(const ResourceSlotDesc* slots, int count)
+{
+	int start = count;
+	while (start > 0 && slots[start - 1].isOptional)
+		start--;
+
+	return start;
+}
+
+
+// Appends slots to the layout, sharing inputs already present
+static GroupLayoutResult MergeSlots(const ResourceSlotDesc* slots, int count, DenoiserGroupLayout& layout)
+{
+	// NRD's resource snapshot is keyed by resource type, so members can share an input
+	// texture but never an output — the second writer would clobber the first.
+	for (int r = 0; r < count; r++)
+	{
+		const ResourceSlotDesc& slotDesc = slots[r];
+
+		bool shared = false;
+		for (int k = 0; k < layout.resourceCount; k++)
+		{
+			ResourceSlotDesc& existing = layout.resources[k];
+			if (existing.type != slotDesc.type)
+				continue;
+
+			if (slotDesc.isOutput || existing.isOutput)
+				return GroupLayoutResult::RESOURCE_CONFLICT;
+
+			// Required by any member makes it required for the group
+			existing.isOptional = existing.isOptional && slotDesc.isOptional;
+			shared = true;
+			break;
+		}
+
+		if (shared)
+			continue;
+
+		if (layout.resourceCount >= MAX_GROUP_RESOURCES)
+			return GroupLayoutResult::TOO_MANY_RESOURCES;
+
+		layout.resources[layout.resourceCount++] = slotDesc;
+	}
+
+	return GroupLayoutResult::OK;
+}
+
+
+GroupLayoutResult BuildDenoiserGroupLayout(const int* denoiserTypes, int denoiserCount, DenoiserGroupLayout& layout)
+{
+	layout = {};
+
+	if (denoiserTypes == nullptr || denoiserCount <= 0)
+		return GroupLayoutResult::EMPTY;
+
+	if (denoiserCount > MAX_GROUP_DENOISERS)
+		return GroupLayoutResult::TOO_MANY_DENOISERS;
+
+	for (int i = 0; i < denoiserCount; i++)
+	{
+		int type = denoiserTypes[i];
+		if (type < 0 || type >= NRD_DENOISER_COUNT)
+			return GroupLayoutResult::INVALID_DENOISER_TYPE;
+
+		for (int j = 0; j < i; j++)
+		{
+			if (denoiserTypes[j] == type)
+				return GroupLayoutResult::DUPLICATE_DENOISER_TYPE;
+		}
+
+		layout.denoiserTypes[layout.denoiserCount++] = type;
+	}
+
+	// Two passes: every member's slots up to its trailing optional inputs, then those trailing
+	// inputs. Layouts of groups without optional slots keep the order they always had.
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < layout.denoiserCount; i++)
+		{
+			const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[layout.denoiserTypes[i]];
+			int split = GetTrailingOptionalStart(desc.resources, desc.resourceCount);
+			int begin = pass == 0 ? 0 : split;
+			int end = pass == 0 ? split : desc.resourceCount;
+
+			GroupLayoutResult result = MergeSlots(desc.resources + begin, end - begin, layout);
+			if (result != GroupLayoutResult::OK)
+				return result;
+		}
+	}
+
+	return GroupLayoutResult::OK;
+}
+
+
+int GetRequiredResourceCount(const DenoiserGroupLayout& layout)
+{
+	return GetTrailingOptionalStart(layout.resources, layout.resourceCount);
+}
+
+
+bool ValidateLayoutResources(const DenoiserGroupLayout& layout, void* const* resources, int resourceCount)
+{
+	if (resourceCount < GetRequiredResourceCount(layout) || resourceCount > layout.resourceCount)
+		return false;
+
+	for (int i = 0; i < resourceCount; i++)
+	{
+		if (resources[i] == nullptr && !layout.resources[i].isOptional)
+			return false;
+	}
+
+	return true;
+}
+
+#define NRD_FORMAT(f) (1ull << (uint32_t)nrd::Format::f)
+
+// Every slot still accepts the RGBA16F textures earlier versions required (and RGBA32F)
+static const NRDFormatMask NRD_FORMATS_WIDE = NRD_FORMAT(RGBA16_SFLOAT) | NRD_FORMAT(RGBA32_SFLOAT);
+// Single channel: view Z, penumbra, hit distance
+static const NRDFormatMask NRD_FORMATS_SCALAR = NRD_FORMAT(R16_SFLOAT) | NRD_FORMAT(R32_SFLOAT) | NRD_FORMATS_WIDE;
+// Single channel in [0, 1]: confidence, disocclusion threshold mix
+static const NRDFormatMask NRD_FORMATS_UNIT = NRD_FORMAT(R8_UNORM) | NRD_FORMAT(R16_UNORM) | NRD_FORMAT(R16_SFLOAT) | NRD_FORMATS_WIDE;
+// Color without hit distance
+static const NRDFormatMask NRD_FORMATS_COLOR = NRD_FORMAT(R11_G11_B10_UFLOAT) | NRD_FORMATS_WIDE;
+
+
+static NRDFormatMask GetNormalFormats(nrd::NormalEncoding normalEncoding)
+{
+	switch (normalEncoding)
+	{
+	case nrd::NormalEncoding::RGBA8_UNORM:          return NRD_FORMAT(RGBA8_UNORM);
+	case nrd::NormalEncoding::RGBA8_SNORM:          return NRD_FORMAT(RGBA8_SNORM);
+	case nrd::NormalEncoding::R10_G10_B10_A2_UNORM: return NRD_FORMAT(R10_G10_B10_A2_UNORM);
+	case nrd::NormalEncoding::RGBA16_UNORM:         return NRD_FORMAT(RGBA16_UNORM);
+	// The encoding this plugin's NRD is built with (see NRD_BUILD_CONFIG.md)
+	case nrd::NormalEncoding::RGBA16_SNORM:         return NRD_FORMAT(RGBA16_SNORM) | NRD_FORMATS_WIDE;
+	default:                                        return 0;
+	}
+}
+
+
+NRDFormatMask GetAllowedFormats(nrd::ResourceType type, nrd::NormalEncoding normalEncoding)
+{
+	switch (type)
+	{
+	case nrd::ResourceType::IN_MV:
+		return NRD_FORMAT(RG16_SFLOAT) | NRD_FORMAT(RG32_SFLOAT) | NRD_FORMATS_WIDE;
+
+	case nrd::ResourceType::IN_NORMAL_ROUGHNESS:
+		return GetNormalFormats(normalEncoding);
+
+	case nrd::ResourceType::IN_BASECOLOR_METALNESS:
+		return NRD_FORMAT(RGBA8_UNORM) | NRD_FORMAT(RGBA8_SRGB) | NRD_FORMATS_WIDE;
+
+	case nrd::ResourceType::IN_VIEWZ:
+	case nrd::ResourceType::IN_PENUMBRA:
+	case nrd::ResourceType::IN_DIFF_HITDIST:
+	case nrd::ResourceType::IN_SPEC_HITDIST:
+	case nrd::ResourceType::OUT_DIFF_HITDIST:
+	case nrd::ResourceType::OUT_SPEC_HITDIST:
+		return NRD_FORMATS_SCALAR;
+
+	case nrd::ResourceType::IN_DIFF_CONFIDENCE:
+	case nrd::ResourceType::IN_SPEC_CONFIDENCE:
+	case nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX:
+		return NRD_FORMATS_UNIT;
+
+	case nrd::ResourceType::IN_TRANSLUCENCY:
+		return NRD_FORMAT(RGBA8_UNORM) | NRD_FORMATS_COLOR;
+
+	case nrd::ResourceType::IN_SIGNAL:
+	case nrd::ResourceType::OUT_SIGNAL:
+		return NRD_FORMATS_COLOR;
+
+	case nrd::ResourceType::OUT_SHADOW_TRANSLUCENCY:
+		return NRD_FORMAT(R8_UNORM) | NRD_FORMAT(RGBA8_UNORM) | NRD_FORMAT(R16_SFLOAT) | NRD_FORMATS_WIDE;
+
+	// Radiance + hit distance, SH and direction: four channels, hit distance in alpha.
+	// R11G11B10 would drop it.
+	default:
+		return NRD_FORMATS_WIDE;
+	}
+}
+
+
+bool IsFormatAllowed(nrd::ResourceType type, nrd::Format format, nrd::NormalEncoding normalEncoding)
+{
+	if ((uint32_t)format >= (uint32_t)nrd::Format::MAX_NUM)
+		return false;
+
+	return (GetAllowedFormats(type, normalEncoding) & (1ull << (uint32_t)format)) != 0;
+}
@@ -1,15 +1,18 @@
 #pragma once
 
 #include "../NRD/Include/NRD.h"
+#include "NRDSlotLimits.h"
+
+static_assert(NRD_DENOISER_COUNT == (int)nrd::Denoiser::MAX_NUM, "NRDSlotLimits.h is out of date with NRD");
 
 // Maximum number of resource slots a single denoiser type can use
-static constexpr int MAX_DENOISER_RESOURCES = 12;
+static constexpr int MAX_DENOISER_RESOURCES = 16;
 
 // Maximum number of output resources for Unity resource state tracking
 static constexpr int MAX_OUTPUT_RESOURCES = 4;
 
-// Total number of denoiser types (matches nrd::Denoiser::MAX_NUM)
-static constexpr int NRD_DENOISER_COUNT = (int)nrd::Denoiser::MAX_NUM;
+// Maximum number of output resources across all denoisers of a group
+static constexpr int MAX_GROUP_OUTPUT_RESOURCES = MAX_GROUP_DENOISERS * MAX_OUTPUT_RESOURCES;
 
 // Settings family for grouping denoiser-specific settings
 enum class SettingsFamily : uint32_t
@@ -25,6 +28,7 @@ struct ResourceSlotDesc
 {
 	nrd::ResourceType type;
 	bool isOutput;
+	bool isOptional; // Input the caller may leave null; NRD skips the feature it enables
 };
 
 // Describes the complete resource layout for a denoiser type
@@ -38,3 +42,50 @@ struct DenoiserTypeDesc
 
 // Master table of all denoiser type descriptors (indexed by nrd::Denoiser enum value)
 extern const DenoiserTypeDesc g_DenoiserTypeDescs[NRD_DENOISER_COUNT];
+
+// Merged resource layout for one NRD instance hosting one or more denoisers.
+// Members share common inputs (IN_MV, IN_NORMAL_ROUGHNESS, IN_VIEWZ, ...): a resource type used by
+// several members appears once, in order of first appearance across the member list. The optional
+// inputs each entry lists after its outputs are merged after every member's required layout, so
+// they form a trailing run here too. A shared slot is optional only if it is for every member.
+struct DenoiserGroupLayout
+{
+	int denoiserCount;
+	int denoiserTypes[MAX_GROUP_DENOISERS];
+	int resourceCount;
+	ResourceSlotDesc resources[MAX_GROUP_RESOURCES];
+};
+
+enum class GroupLayoutResult : uint32_t
+{
+	OK,
+	EMPTY,
+	TOO_MANY_DENOISERS,
+	INVALID_DENOISER_TYPE,
+	DUPLICATE_DENOISER_TYPE,
+	RESOURCE_CONFLICT,   // two members write the same output type, or one reads what another writes
+	TOO_MANY_RESOURCES
+};
+
+// Builds the merged layout for a group of denoiser types. Pure table logic — no device required.
+// A single denoiser type yields a layout identical to its g_DenoiserTypeDescs entry.
+GroupLayoutResult BuildDenoiserGroupLayout(const int* denoiserTypes, int denoiserCount, DenoiserGroupLayout& layout);
+
+// Number of leading slots a caller must pass: the layout minus its trailing run of optional inputs
+int GetRequiredResourceCount(const DenoiserGroupLayout& layout);
+
+// Checks a caller's resource array against a layout: resourceCount lies between
+// GetRequiredResourceCount and the full count, and every non-optional slot is non-null.
+// Slots past resourceCount are treated as null.
+bool ValidateLayoutResources(const DenoiserGroupLayout& layout, void* const* resources, int resourceCount);
+
+// Set of nrd::Format values, one bit per format
+typedef uint64_t NRDFormatMask;
+static_assert((uint32_t)nrd::Format::MAX_NUM <= 64, "nrd::Format no longer fits NRDFormatMask");
+
+// Formats a resource of the given type may be bound with, after typeless formats are resolved.
+// IN_NORMAL_ROUGHNESS depends on the NRD_NORMAL_ENCODING NRD was built with. Same for every
+// denoiser type — a slot's allowed set is the one of its resource type.
+NRDFormatMask GetAllowedFormats(nrd::ResourceType type, nrd::NormalEncoding normalEncoding);
+
+bool IsFormatAllowed(nrd::ResourceType type, nrd::Format format, nrd::NormalEncoding normalEncoding);
@@ -0,0 +1,130 @@
+#include "NRDDescriptorArena.h"
+
+
+NRDDescriptorArena::NRDDescriptorArena()
+	: m_fenceSource(nullptr)
+	, m_capacity(0)
+	, m_head(0)
+	, m_used(0)
+	, m_openUsed(0)
+	, m_highWaterMark(0)
+	, m_frames()
+	, m_frameCount(0)
+	, m_failedAllocations(0)
+	, m_forcedWaits(0)
+{
+}
+
+
+void NRDDescriptorArena::Reset(uint32_t capacity)
+{
+	m_capacity = capacity;
+	m_head = 0;
+	m_used = 0;
+	m_openUsed = 0;
+	m_frameCount = 0;
+}
+
+
+bool NRDDescriptorArena::IsComplete(const Frame& frame)
+{
+	if (frame.fence == nullptr || frame.fenceValue == 0 || m_fenceSource == nullptr)
+		return true;
+
+	return m_fenceSource->GetCompletedValue(frame.fence) >= frame.fenceValue;
+}
+
+
+void NRDDescriptorArena::RecycleOldest()
+{
+	m_used -= m_frames[0].used;
+
+	for (int i = 1; i < m_frameCount; i++)
+		m_frames[i - 1] = m_frames[i];
+	m_frameCount--;
+
+	// Nothing left in the ring — start over at 0 so the next frame gets the whole heap unwrapped
+	if (m_used == 0)
+		m_head = 0;
+}
+
+
+int NRDDescriptorArena::Collect()
+{
+	// Frames complete in submission order, so stop at the first one still in flight
+	int recycled = 0;
+	while (m_frameCount > 0 && IsComplete(m_frames[0]))
+	{
+		RecycleOldest();
+		recycled++;
+	}
+
+	return recycled;
+}
+
+
+int64_t NRDDescriptorArena::Allocate(uint32_t count)
+{
+	if (count == 0 || count > m_capacity)
+	{
+		m_failedAllocations++;
+		return -1;
+	}
+
+	Collect();
+
+	// The free space starts at m_head and is (capacity - used) long, wrapping past the end.
+	// A block never straddles the end: the tail of the heap is skipped as padding instead.
+	uint32_t free = m_capacity - m_used;
+	uint32_t toEnd = m_capacity - m_head;
+	uint32_t padding = 0;
+
+	if (count > toEnd)
+		padding = toEnd;
+
+	if (padding + count > free)
+	{
+		m_failedAllocations++;
+		return -1;
+	}
+
+	uint32_t base = padding ? 0 : m_head;
+	m_head = base + count;
+	if (m_head == m_capacity)
+		m_head = 0;
+
+	m_used += padding + count;
+	m_openUsed += padding + count;
+	if (m_used > m_highWaterMark)
+		m_highWaterMark = m_used;
+
+	return base;
+}
+
+
+void NRDDescriptorArena::EndFrame(void* fence, uint64_t fenceValue)
+{
+	if (m_openUsed == 0)
+		return;
+
+	if (m_frameCount == NRD_DESCRIPTOR_ARENA_MAX_FRAMES)
+	{
+		Collect();
+
+		// Still full: the GPU is far behind. Wait for the oldest frame rather than grow.
+		if (m_frameCount == NRD_DESCRIPTOR_ARENA_MAX_FRAMES)
+		{
+			m_forcedWaits++;
+			const Frame& oldest = m_frames[0];
+			if (!IsComplete(oldest))
+				m_fenceSource->WaitForValue(oldest.fence, oldest.fenceValue);
+			RecycleOldest();
+		}
+	}
+
+	Frame& frame = m_frames[m_frameCount++];
+	frame.fence = fence;
+	frame.fenceValue = fenceValue;
+	frame.used = m_openUsed;
+	m_openUsed = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "NRDRetireQueue.h"
+
+#include <stdint.h>
+
+
+// Frames whose descriptors can be in flight at once. Closing a frame with all of them still
+// pending blocks on the oldest, like a full NRDRetireQueue.
+static const int NRD_DESCRIPTOR_ARENA_MAX_FRAMES = 8;
+
+
+// Descriptor ring over one shader-visible heap (a D3D12ComputePass's tables). Each frame
+// sub-allocates linearly from the ring; a closed frame's descriptors are recycled once the fence of
+// its last submission has passed. Only indices are managed here — the pass maps them onto its
+// CBV/SRV/UAV heap — so the allocator builds and runs without a graphics API.
+//
+// Not thread safe — the caller serializes access (render thread).
+class NRDDescriptorArena
+{
+public:
+	NRDDescriptorArena();
+
+	void SetFenceSource(RetireFenceSource* fenceSource) { m_fenceSource = fenceSource; }
+
+	// Set the heap size in descriptors and forget every allocation (the heap was recreated)
+	void Reset(uint32_t capacity);
+
+	// count contiguous descriptors for the open frame. Returns the first index, or -1 if they
+	// don't fit even after recycling every completed frame.
+	int64_t Allocate(uint32_t count);
+
+	// Close the open frame; its descriptors are recycled once fence reaches fenceValue
+	void EndFrame(void* fence, uint64_t fenceValue);
+
+	// Recycle every closed frame whose fence has completed. Returns the number recycled.
+	int Collect();
+
+	uint32_t GetCapacity() const { return m_capacity; }
+	// Descriptors in use by the open frame and frames still in flight (including wrap padding)
+	uint32_t GetOccupancy() const { return m_used; }
+	uint32_t GetHighWaterMark() const { return m_highWaterMark; }
+	uint64_t GetFailedAllocationCount() const { return m_failedAllocations; }
+	// Number of EndFrame calls that had to block because every frame slot was in flight
+	uint64_t GetForcedWaitCount() const { return m_forcedWaits; }
+
+private:
+	struct Frame
+	{
+		void* fence;
+		uint64_t fenceValue;
+		uint32_t used; // Descriptors (and wrap padding) to give back when the frame completes
+	};
+
+	bool IsComplete(const Frame& frame);
+	void RecycleOldest();
+
+	RetireFenceSource* m_fenceSource;
+	uint32_t m_capacity;
+	uint32_t m_head;      // Next free index
+	uint32_t m_used;      // Allocated descriptors from the oldest frame up to m_head
+	uint32_t m_openUsed;  // Part of m_used owned by the open frame
+	uint32_t m_highWaterMark;
+	Frame m_frames[NRD_DESCRIPTOR_ARENA_MAX_FRAMES]; // Closed frames, oldest first
+	int m_frameCount;
+	uint64_t m_failedAllocations;
+	uint64_t m_forcedWaits;
+};
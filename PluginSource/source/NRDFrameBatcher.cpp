@@ -0,0 +1,105 @@
+#include "NRDFrameBatcher.h"
+#include "RenderAPI.h"
+
+
+NRDFrameBatcher::NRDFrameBatcher()
+	: m_api(nullptr)
+	, m_pending()
+	, m_queued()
+	, m_pendingCount(0)
+	, m_frameSlot(-1)
+{
+}
+
+
+void NRDFrameBatcher::SetRenderAPI(RenderAPI* api)
+{
+	Clear();
+	m_api = api;
+}
+
+
+void NRDFrameBatcher::Enqueue(int denoiserType, int frameSlot)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return;
+
+	// Auto-coalescing: a new frame slot means the previous frame's batch was never flushed.
+	// Submit it now rather than mixing two frames' work in one command list.
+	if (m_pendingCount > 0 && frameSlot != m_frameSlot)
+		Flush();
+
+	if (m_queued[denoiserType])
+		return;
+
+	m_frameSlot = frameSlot;
+	m_queued[denoiserType] = true;
+	m_pending[m_pendingCount++] = denoiserType;
+}
+
+
+int NRDFrameBatcher::Flush()
+{
+	if (m_pendingCount == 0 || m_api == nullptr)
+	{
+		Clear();
+		return 0;
+	}
+
+	// Record in issue order so NRD sees the same sequence as unbatched execution
+	m_api->NRDBeginBatch();
+	for (int i = 0; i < m_pendingCount; i++)
+		m_api->NRDRecord(m_pending[i], m_frameSlot);
+	m_api->NRDSubmitBatch();
+
+	int submitted = m_pendingCount;
+	Clear();
+	return submitted;
+}
+
+
+void NRDFrameBatcher::Execute(int denoiserType, int frameSlot)
+{
+	if (m_api == nullptr)
+		return;
+
+	Flush();
+	m_api->NRDDenoise(denoiserType, frameSlot);
+}
+
+
+void NRDFrameBatcher::SyncAsyncCompute()
+{
+	if (m_api == nullptr)
+		return;
+
+	Flush();
+	m_api->NRDSyncAsyncCompute();
+}
+
+
+void NRDFrameBatcher::Remove(int denoiserType)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT || !m_queued[denoiserType])
+		return;
+
+	int write = 0;
+	for (int i = 0; i < m_pendingCount; i++)
+	{
+		if (m_pending[i] != denoiserType)
+			m_pending[write++] = m_pending[i];
+	}
+
+	m_pendingCount = write;
+	m_queued[denoiserType] = false;
+}
+
+
+void NRDFrameBatcher::Clear()
+{
+	for (int i = 0; i < m_pendingCount; i++)
+		m_queued[m_pending[i]] = false;
+
+	m_pendingCount = 0;
+	m_frameSlot = -1;
+}
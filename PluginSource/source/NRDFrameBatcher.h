@@ -0,0 +1,53 @@
+#pragma once
+
+#include "NRDSlotLimits.h"
+
+class RenderAPI;
+
+
+// Coalesces execute events issued for the same frame into a single backend submission.
+//
+// Batched execute events are queued instead of dispatched. The queue is handed to the backend
+// as one NRDBeginBatch / NRDRecord... / NRDSubmitBatch sequence either when an explicit flush
+// event arrives, or automatically when an event for a different frame slot shows up (so a
+// missing flush never loses work, it only delays it to the next frame). Immediate work goes
+// through Execute / SyncAsyncCompute, which submit the pending batch first so the backend sees
+// submissions in the order their events were issued.
+//
+// Render thread only — no internal locking.
+class NRDFrameBatcher
+{
+public:
+	NRDFrameBatcher();
+
+	void SetRenderAPI(RenderAPI* api);
+
+	// Queue a slot (denoiser type or group slot) for the pending batch.
+	// Re-queuing a slot already in the batch is ignored.
+	void Enqueue(int denoiserType, int frameSlot);
+
+	// Record and submit everything queued. Returns the number of denoisers submitted.
+	int Flush();
+
+	// Execute a slot outside the batch, after submitting anything pending.
+	void Execute(int denoiserType, int frameSlot);
+
+	// Make the graphics queue wait for async compute work, including the pending batch's.
+	void SyncAsyncCompute();
+
+	// Drop a denoiser from the pending batch (e.g. it was released before the flush).
+	void Remove(int denoiserType);
+
+	// Drop the pending batch without submitting.
+	void Clear();
+
+	int GetPendingCount() const { return m_pendingCount; }
+	int GetPendingFrameSlot() const { return m_frameSlot; }
+
+private:
+	RenderAPI* m_api;
+	int m_pending[NRD_SLOT_COUNT];
+	bool m_queued[NRD_SLOT_COUNT];
+	int m_pendingCount;
+	int m_frameSlot;
+};
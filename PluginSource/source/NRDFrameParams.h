@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Layout version of NRDFrameParams. Fields are only ever appended; bump this when they are.
+static const uint32_t NRD_FRAME_PARAMS_VERSION = 1;
+
+// NRDFrameParams::overrideMask bits — each selects one optional field of the block
+enum NRDFrameOverride
+{
+	NRD_FRAME_OVERRIDE_LIGHT_DIRECTION = 1 << 0,         // lightDirection (else the NRDSetLightDirection value)
+	NRD_FRAME_OVERRIDE_ACCUMULATION_MODE = 1 << 1,       // accumulationMode (nrd::AccumulationMode)
+	NRD_FRAME_OVERRIDE_DENOISING_RANGE = 1 << 2,         // denoisingRange
+	NRD_FRAME_OVERRIDE_DISOCCLUSION_THRESHOLD = 1 << 3,  // disocclusionThreshold
+	NRD_FRAME_OVERRIDE_SPLIT_SCREEN = 1 << 4             // splitScreen
+};
+
+
+// Per-frame parameter block passed with CommandBuffer.IssuePluginEventAndData to the callback
+// returned by NRDGetExecuteCallbackWithData. Mirrored in C# with [StructLayout(LayoutKind.Sequential)].
+//
+// The block travels with the event, so the render thread always sees the parameters of the frame
+// that issued it — however far it lags behind the main thread. The plugin copies it when the event
+// executes; the caller's memory only has to stay valid until then.
+struct NRDFrameParams
+{
+	uint32_t size;              // sizeof(NRDFrameParams) as seen by the caller
+	uint32_t version;           // NRD_FRAME_PARAMS_VERSION the caller was built against
+
+	int32_t frameIndex;
+	float deltaTime;            // Seconds
+
+	// Same conventions as NRDSetMatrix: column-major, non-jittered,
+	// GL.GetGPUProjectionMatrix(proj, false) — the plugin applies the D3D12 Y-flip
+	float viewToClip[16];
+	float worldToView[16];
+
+	// Active render rect (see NRDSetRenderRect); 0 uses the full initialized size
+	int32_t rectWidth;
+	int32_t rectHeight;
+
+	// Optional overrides, applied only when their NRDFrameOverride bit is set
+	uint32_t overrideMask;
+	float lightDirection[3];    // Direction TO the light, world space (SIGMA)
+	uint32_t accumulationMode;
+	float denoisingRange;
+	float disocclusionThreshold;
+	float splitScreen;
+};
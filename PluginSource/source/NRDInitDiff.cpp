@@ -0,0 +1,30 @@
+#include "NRDInitDiff.h"
+
+
+InitAction ClassifyInit(const SlotInitKey* live, const SlotInitKey& requested)
+{
+	if (live == nullptr)
+		return InitAction::RECREATE;
+
+	if (live->denoiserCount != requested.denoiserCount
+		|| live->width != requested.width
+		|| live->height != requested.height
+		|| live->queueMode != requested.queueMode
+		|| live->resourceCount != requested.resourceCount)
+		return InitAction::RECREATE;
+
+	// Order matters — it defines the identifiers and the merged resource layout
+	for (int i = 0; i < requested.denoiserCount; i++)
+	{
+		if (live->denoiserTypes[i] != requested.denoiserTypes[i])
+			return InitAction::RECREATE;
+	}
+
+	for (int i = 0; i < requested.resourceCount; i++)
+	{
+		if (live->resources[i] != requested.resources[i] || live->formats[i] != requested.formats[i])
+			return InitAction::REBIND;
+	}
+
+	return InitAction::NO_OP;
+}
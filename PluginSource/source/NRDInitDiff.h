@@ -0,0 +1,36 @@
+#pragma once
+
+#include "NRDDenoiserConfig.h"
+
+#include <stdint.h>
+
+
+// What a repeated initialization of a live slot actually has to do
+enum class InitAction : uint32_t
+{
+	NO_OP,    // Same denoisers, dimensions, queue and resources — nothing to do
+	REBIND,   // Only texture pointers/formats changed — swap them in, keep the NRD instance
+	RECREATE, // Denoiser set, dimensions or queue changed (or nothing live) — new NRD instance
+
+	COUNT
+};
+
+
+// Everything an initialization request is compared on. Formats are opaque (DXGI_FORMAT on D3D12).
+struct SlotInitKey
+{
+	int denoiserCount;
+	int denoiserTypes[MAX_GROUP_DENOISERS];
+	int width;
+	int height;
+	int queueMode;
+	int resourceCount;
+	const void* resources[MAX_GROUP_RESOURCES];
+	uint32_t formats[MAX_GROUP_RESOURCES];
+};
+
+
+// Compare a request against the slot's live state (null when the slot has no instance).
+// NRD's pools and pipelines depend only on the denoiser set, the dimensions and the queue;
+// user textures are bound per frame, so pointer or format changes only need a rebind.
+InitAction ClassifyInit(const SlotInitKey* live, const SlotInitKey& requested);
@@ -0,0 +1,132 @@
+#include "NRDLibrary.h"
+
+#include "../NRD/Include/NRD.h"
+
+#if defined(_WIN32)
+
+#include <windows.h>
+#include <delayimp.h>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+
+// Recursive: the delay-load hook runs inside the first NRD call, which SelectNrdLibrary may make
+static std::recursive_mutex s_mutex;
+static int s_selectedEncoding = -1;
+static HMODULE s_module = nullptr;
+static bool s_loadFailed = false;
+
+
+// Full path of the NRD binary for an encoding, in the plugin's own directory
+static bool GetLibraryPath(int normalEncoding, wchar_t* path, DWORD size)
+{
+	HMODULE plugin = nullptr;
+	DWORD flags = GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT;
+	if (!GetModuleHandleExW(flags, (LPCWSTR)&GetLibraryPath, &plugin))
+		return false;
+
+	DWORD length = GetModuleFileNameW(plugin, path, size);
+	if (length == 0 || length == size)
+		return false;
+
+	wchar_t* name = wcsrchr(path, L'\\');
+	name = name ? name + 1 : path;
+	size_t room = size - (name - path);
+
+	int written = normalEncoding < 0
+		? swprintf(name, room, L"NRD.dll")
+		: swprintf(name, room, L"NRD_enc%d.dll", normalEncoding);
+	return written > 0;
+}
+
+
+// Under s_mutex. A failed load isn't retried until the selection changes.
+static HMODULE LoadSelectedLibrary()
+{
+	if (s_module != nullptr || s_loadFailed)
+		return s_module;
+
+	wchar_t path[MAX_PATH];
+	if (GetLibraryPath(s_selectedEncoding, path, MAX_PATH))
+		s_module = LoadLibraryExW(path, nullptr, LOAD_WITH_ALTERED_SEARCH_PATH);
+
+	// The default build may also come from the regular DLL search path
+	if (s_module == nullptr && s_selectedEncoding < 0)
+		s_module = LoadLibraryW(L"NRD.dll");
+
+	s_loadFailed = s_module == nullptr;
+	return s_module;
+}
+
+
+// NRD.dll is delay-loaded: the helper asks here before loading it, and binds NRD's imports to
+// whichever binary is returned
+static FARPROC WINAPI DelayLoadHook(unsigned notification, PDelayLoadInfo info)
+{
+	if (notification != dliNotePreLoadLibrary || _stricmp(info->szDll, "NRD.dll") != 0)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(s_mutex);
+	return (FARPROC)LoadSelectedLibrary();
+}
+
+extern "C" const PfnDliHook __pfnDliNotifyHook2 = DelayLoadHook;
+
+
+bool SelectNrdLibrary(int normalEncoding)
+{
+	if (normalEncoding < -1 || normalEncoding >= (int)nrd::NormalEncoding::MAX_NUM)
+		return false;
+
+	std::lock_guard<std::recursive_mutex> lock(s_mutex);
+
+	// Too late to switch — but asking for what is already loaded is fine
+	if (s_module != nullptr)
+		return normalEncoding == s_selectedEncoding || normalEncoding == (int)nrd::GetLibraryDesc()->normalEncoding;
+
+	wchar_t path[MAX_PATH];
+	if (normalEncoding >= 0)
+	{
+		if (!GetLibraryPath(normalEncoding, path, MAX_PATH) || GetFileAttributesW(path) == INVALID_FILE_ATTRIBUTES)
+			return false;
+	}
+
+	s_selectedEncoding = normalEncoding;
+	s_loadFailed = false;
+	return true;
+}
+
+
+bool EnsureNrdLibrary()
+{
+	std::lock_guard<std::recursive_mutex> lock(s_mutex);
+	return LoadSelectedLibrary() != nullptr;
+}
+
+#else
+
+// NRD is linked directly — only the build the plugin was linked against is available
+
+bool SelectNrdLibrary(int normalEncoding)
+{
+	return normalEncoding == -1 || normalEncoding == GetNrdNormalEncoding();
+}
+
+
+bool EnsureNrdLibrary()
+{
+	return true;
+}
+
+#endif
+
+
+int GetNrdNormalEncoding()
+{
+	if (!EnsureNrdLibrary())
+		return -1;
+
+	return (int)nrd::GetLibraryDesc()->normalEncoding;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+
+// Which NRD binary the plugin runs on. NRD bakes NRD_NORMAL_ENCODING into its shaders, so each
+// encoding is a separate build: NRD.dll is the default one, NRD_enc<N>.dll next to the plugin is
+// one built with -DNRD_NORMAL_ENCODING=<N>. NRD.dll is delay-loaded; the first NRD call (first
+// initialization or memory estimate) loads the selected binary, and the choice is fixed from then
+// on. Thread safe.
+
+// Select the binary for a normal encoding (nrd::NormalEncoding value), or -1 for NRD.dll.
+// Returns false if its DLL isn't there, or if a different binary is already loaded.
+bool SelectNrdLibrary(int normalEncoding);
+
+// Loads the selected binary if nothing is loaded yet. Returns false if it can't be loaded —
+// NRD must not be called then.
+bool EnsureNrdLibrary();
+
+// Normal encoding of the loaded binary (loading it if needed), -1 if none can be loaded
+int GetNrdNormalEncoding();
@@ -0,0 +1,113 @@
+#include "NRDMemoryEstimate.h"
+#include "NRDDenoiserConfig.h"
+
+
+// D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT / D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT,
+// spelled out so the estimate builds without a graphics API
+static const uint64_t NRD_TEXTURE_PLACEMENT_ALIGNMENT = 64 * 1024;
+static const uint64_t NRD_CONSTANT_BUFFER_ALIGNMENT = 256;
+
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+static uint64_t GetNrdFormatBytes(nrd::Format format)
+{
+	switch (format)
+	{
+	case nrd::Format::R8_UNORM:
+	case nrd::Format::R8_SNORM:
+	case nrd::Format::R8_UINT:
+	case nrd::Format::R8_SINT:
+		return 1;
+	case nrd::Format::RG8_UNORM:
+	case nrd::Format::RG8_SNORM:
+	case nrd::Format::RG8_UINT:
+	case nrd::Format::RG8_SINT:
+	case nrd::Format::R16_UNORM:
+	case nrd::Format::R16_SNORM:
+	case nrd::Format::R16_UINT:
+	case nrd::Format::R16_SINT:
+	case nrd::Format::R16_SFLOAT:
+		return 2;
+	case nrd::Format::RGBA16_UNORM:
+	case nrd::Format::RGBA16_SNORM:
+	case nrd::Format::RGBA16_UINT:
+	case nrd::Format::RGBA16_SINT:
+	case nrd::Format::RGBA16_SFLOAT:
+	case nrd::Format::RG32_UINT:
+	case nrd::Format::RG32_SINT:
+	case nrd::Format::RG32_SFLOAT:
+		return 8;
+	case nrd::Format::RGB32_UINT:
+	case nrd::Format::RGB32_SINT:
+	case nrd::Format::RGB32_SFLOAT:
+		return 12;
+	case nrd::Format::RGBA32_UINT:
+	case nrd::Format::RGBA32_SINT:
+	case nrd::Format::RGBA32_SFLOAT:
+		return 16;
+	default: // RGBA8, RG16, R32 and the packed 32-bit formats
+		return 4;
+	}
+}
+
+
+static uint64_t MeasurePool(const nrd::TextureDesc* pool, uint32_t poolSize, int width, int height)
+{
+	uint64_t bytes = 0;
+	for (uint32_t i = 0; i < poolSize; i++)
+	{
+		uint64_t w = (width + pool[i].downsampleFactor - 1) / pool[i].downsampleFactor;
+		uint64_t h = (height + pool[i].downsampleFactor - 1) / pool[i].downsampleFactor;
+		bytes += AlignUp(w * h * GetNrdFormatBytes(pool[i].format), NRD_TEXTURE_PLACEMENT_ALIGNMENT);
+	}
+
+	return bytes;
+}
+
+
+bool EstimateInstanceMemory(const nrd::InstanceCreationDesc& instanceDesc, int width, int height,
+	uint32_t queuedFrameNum, uint32_t descriptorSize, NRDMemoryFootprint& footprint)
+{
+	footprint = {};
+
+	nrd::Instance* instance = nullptr;
+	if (nrd::CreateInstance(instanceDesc, instance) != nrd::Result::SUCCESS)
+		return false;
+
+	const nrd::InstanceDesc* desc = nrd::GetInstanceDesc(*instance);
+	footprint.permanentBytes = MeasurePool(desc->permanentPool, desc->permanentPoolSize, width, height);
+	footprint.transientBytes = MeasurePool(desc->transientPool, desc->transientPoolSize, width, height);
+
+	// NRDIntegration reserves NRD's per-frame descriptor limits and one constant view per set,
+	// for every queued frame
+	const nrd::DescriptorPoolDesc& limits = desc->descriptorPoolDesc;
+	uint64_t descriptors = (uint64_t)limits.constantBuffersMaxNum + limits.texturesMaxNum + limits.storageTexturesMaxNum;
+	footprint.descriptorBytes = descriptors * descriptorSize * queuedFrameNum;
+	footprint.uploadBytes = AlignUp(desc->constantBufferMaxDataSize, NRD_CONSTANT_BUFFER_ALIGNMENT) * limits.setsMaxNum * queuedFrameNum;
+
+	nrd::DestroyInstance(*instance);
+	return true;
+}
+
+
+bool EstimateDenoiserMemory(const int* denoiserTypes, int denoiserCount, int width, int height,
+	uint32_t queuedFrameNum, uint32_t descriptorSize, NRDMemoryFootprint& footprint)
+{
+	nrd::DenoiserDesc denoiserDescs[MAX_GROUP_DENOISERS] = {};
+	for (int i = 0; i < denoiserCount; i++)
+	{
+		denoiserDescs[i].identifier = (nrd::Identifier)i;
+		denoiserDescs[i].denoiser = g_DenoiserTypeDescs[denoiserTypes[i]].denoiser;
+	}
+
+	nrd::InstanceCreationDesc instanceDesc = {};
+	instanceDesc.denoisers = denoiserDescs;
+	instanceDesc.denoisersNum = (uint32_t)denoiserCount;
+
+	return EstimateInstanceMemory(instanceDesc, width, height, queuedFrameNum, descriptorSize, footprint);
+}
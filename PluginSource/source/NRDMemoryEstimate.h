@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace nrd { struct InstanceCreationDesc; }
+
+
+// Typical CBV/SRV/UAV descriptor size, used when no device is available to ask
+static const uint32_t NRD_TYPICAL_DESCRIPTOR_SIZE = 32;
+
+// Frames an integration multi-buffers its descriptors and constants for (the D3D12 backend's
+// NRD_FRAMES_IN_FLIGHT), used by headless estimates
+static const uint32_t NRD_ESTIMATE_QUEUED_FRAMES = 3;
+
+
+// GPU memory of one NRD instance, in bytes. Mirrors the C# struct passed to NRDEstimateMemory
+// and NRDGetMemoryReport — keep the layout in sync.
+struct NRDMemoryFootprint
+{
+	uint64_t permanentBytes;  // Permanent pool textures (history, kept across frames)
+	uint64_t transientBytes;  // Transient pool textures (live only inside a dispatch)
+	uint64_t descriptorBytes; // Shader-visible descriptors reserved by the integration
+	uint64_t uploadBytes;     // Constant upload buffer of the integration
+};
+
+
+// Footprint of an instance created from instanceDesc at width x height, from NRD's own pool and
+// limit descriptions (a CPU-only instance — no device, callable headless). Textures are rounded
+// to the 64 KB placement alignment and row padding is ignored; descriptors and constants are
+// sized the way NRDIntegration sizes them, once per queued frame. Returns false (and a zero
+// footprint) if NRD rejects the description.
+bool EstimateInstanceMemory(const nrd::InstanceCreationDesc& instanceDesc, int width, int height,
+	uint32_t queuedFrameNum, uint32_t descriptorSize, NRDMemoryFootprint& footprint);
+
+// Same, for the instance the plugin creates for a slot hosting denoiserTypes (one type, or a
+// group). The caller validates the types.
+bool EstimateDenoiserMemory(const int* denoiserTypes, int denoiserCount, int width, int height,
+	uint32_t queuedFrameNum, uint32_t descriptorSize, NRDMemoryFootprint& footprint);
+
+inline uint64_t GetFootprintTotal(const NRDMemoryFootprint& footprint)
+{
+	return footprint.permanentBytes + footprint.transientBytes + footprint.descriptorBytes + footprint.uploadBytes;
+}
@@ -0,0 +1,70 @@
+#include "NRDResidencyPolicy.h"
+
+
+// Least recently used first, then lower slot
+static bool EvictsBefore(const ResidencyEntry& a, const ResidencyEntry& b)
+{
+	if (a.lastUsedFrame != b.lastUsedFrame)
+		return a.lastUsedFrame < b.lastUsedFrame;
+	return a.slot < b.slot;
+}
+
+
+int SelectEvictions(const ResidencyEntry* entries, int count, uint64_t currentFrame, uint64_t idleFrames,
+	uint64_t usage, uint64_t budget, int* outSlots)
+{
+	int selected = 0;
+	uint64_t freed = 0;
+
+	// Remaining candidates (by index into entries), sorted for LRU eviction
+	int candidates[NRD_RESIDENCY_MAX_ENTRIES];
+	int candidateCount = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		const ResidencyEntry& entry = entries[i];
+		bool idle = idleFrames != 0 && currentFrame > entry.lastUsedFrame && currentFrame - entry.lastUsedFrame > idleFrames;
+		if (idle)
+		{
+			outSlots[selected++] = entry.slot;
+			freed += entry.bytes;
+			continue;
+		}
+
+		if (entry.lastUsedFrame + 1 >= currentFrame || candidateCount == NRD_RESIDENCY_MAX_ENTRIES)
+			continue;
+
+		int j = candidateCount++;
+		while (j > 0 && EvictsBefore(entry, entries[candidates[j - 1]]))
+		{
+			candidates[j] = candidates[j - 1];
+			j--;
+		}
+		candidates[j] = i;
+	}
+
+	// Sort idle suspensions by slot too, so the output never depends on input order
+	for (int i = 1; i < selected; i++)
+	{
+		int slot = outSlots[i];
+		int j = i;
+		while (j > 0 && outSlots[j - 1] > slot)
+		{
+			outSlots[j] = outSlots[j - 1];
+			j--;
+		}
+		outSlots[j] = slot;
+	}
+
+	if (budget == 0)
+		return selected;
+
+	for (int c = 0; c < candidateCount && usage > budget && usage - budget > freed; c++)
+	{
+		const ResidencyEntry& entry = entries[candidates[c]];
+		outSlots[selected++] = entry.slot;
+		freed += entry.bytes;
+	}
+
+	return selected;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Upper bound on entries considered for pressure eviction (one per live slot in practice)
+static const int NRD_RESIDENCY_MAX_ENTRIES = 64;
+
+
+// One live (resident) NRD instance as seen by the residency policy
+struct ResidencyEntry
+{
+	int slot;
+	uint64_t lastUsedFrame; // Frame of its last execute
+	uint64_t bytes;         // Pool memory freed by suspending it
+};
+
+
+// Which resident instances to suspend this frame. Frames are any monotonic counter.
+//
+// - Idle: every instance not executed for more than idleFrames frames (0 = never idle-suspend).
+// - Pressure: while usage exceeds budget (0 = no budget), the least recently used of the rest,
+//   oldest first, until enough bytes are freed. Instances executed in this or the previous frame
+//   are never chosen — they would be rebuilt immediately. (The policy runs before a frame's
+//   dispatches, so an instance executed every frame was last used in the previous one.)
+//
+// Writes the chosen slots to outSlots (idle ones first, then in eviction order; room for count
+// entries) and returns how many. Only the first NRD_RESIDENCY_MAX_ENTRIES entries are
+// considered for pressure eviction. Deterministic: ties go to the lower slot.
+int SelectEvictions(const ResidencyEntry* entries, int count, uint64_t currentFrame, uint64_t idleFrames,
+	uint64_t usage, uint64_t budget, int* outSlots);
@@ -0,0 +1,89 @@
+#include "NRDRetireQueue.h"
+
+
+NRDRetireQueue::NRDRetireQueue()
+	: m_fenceSource(nullptr)
+	, m_entries()
+	, m_count(0)
+	, m_forcedWaits(0)
+{
+}
+
+
+bool NRDRetireQueue::IsComplete(const Entry& entry)
+{
+	if (entry.fence == nullptr || entry.fenceValue == 0 || m_fenceSource == nullptr)
+		return true;
+
+	return m_fenceSource->GetCompletedValue(entry.fence) >= entry.fenceValue;
+}
+
+
+void NRDRetireQueue::DestroyAt(int index)
+{
+	Entry entry = m_entries[index];
+
+	// Keep retirement order for the remaining entries
+	for (int i = index + 1; i < m_count; i++)
+		m_entries[i - 1] = m_entries[i];
+	m_count--;
+
+	if (entry.destroy)
+		entry.destroy(entry.object);
+}
+
+
+void NRDRetireQueue::Retire(void* fence, uint64_t fenceValue, DestroyFunc destroy, void* object)
+{
+	if (m_count == NRD_RETIRE_QUEUE_CAPACITY)
+	{
+		Collect();
+
+		// Still full: the GPU is far behind. Wait for the oldest entry rather than grow.
+		if (m_count == NRD_RETIRE_QUEUE_CAPACITY)
+		{
+			m_forcedWaits++;
+			const Entry& oldest = m_entries[0];
+			if (!IsComplete(oldest))
+				m_fenceSource->WaitForValue(oldest.fence, oldest.fenceValue);
+			DestroyAt(0);
+		}
+	}
+
+	Entry& entry = m_entries[m_count++];
+	entry.fence = fence;
+	entry.fenceValue = fenceValue;
+	entry.destroy = destroy;
+	entry.object = object;
+}
+
+
+int NRDRetireQueue::Collect()
+{
+	int destroyed = 0;
+	int i = 0;
+	while (i < m_count)
+	{
+		if (IsComplete(m_entries[i]))
+		{
+			DestroyAt(i);
+			destroyed++;
+		}
+		else
+			i++;
+	}
+
+	return destroyed;
+}
+
+
+void NRDRetireQueue::Drain()
+{
+	while (m_count > 0)
+	{
+		const Entry& entry = m_entries[0];
+		if (!IsComplete(entry))
+			m_fenceSource->WaitForValue(entry.fence, entry.fenceValue);
+		DestroyAt(0);
+	}
+}
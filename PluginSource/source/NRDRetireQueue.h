@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+
+
+// Fence access used by NRDRetireQueue. The D3D12 backend implements it on ID3D12Fence;
+// fences are opaque here so the queue builds and runs without a graphics API.
+class RetireFenceSource
+{
+public:
+	virtual ~RetireFenceSource() { }
+
+	virtual uint64_t GetCompletedValue(void* fence) = 0;
+	// Block until fence reaches value (implementations may time out)
+	virtual void WaitForValue(void* fence, uint64_t value) = 0;
+};
+
+
+// Maximum number of objects awaiting destruction. Retiring into a full queue blocks on the
+// oldest entry, which bounds memory if the GPU stalls or Collect is not called.
+static const int NRD_RETIRE_QUEUE_CAPACITY = 64;
+
+
+// Deferred, GPU-safe destruction. Objects the GPU may still reference are handed over together
+// with the fence value of their last submission and destroyed once that value has completed,
+// so releasing or resizing a denoiser never blocks the calling thread on the GPU.
+//
+// Not thread safe — the caller serializes access.
+class NRDRetireQueue
+{
+public:
+	typedef void (*DestroyFunc)(void* object);
+
+	NRDRetireQueue();
+
+	void SetFenceSource(RetireFenceSource* fenceSource) { m_fenceSource = fenceSource; }
+
+	// Destroy object once fence reaches fenceValue. A null fence or zero value means the GPU
+	// never used the object; it is destroyed by the next Collect.
+	void Retire(void* fence, uint64_t fenceValue, DestroyFunc destroy, void* object);
+
+	// Destroy every entry whose fence has completed. Returns the number destroyed.
+	int Collect();
+
+	// Block until every entry's fence has completed and destroy them all (shutdown)
+	void Drain();
+
+	int GetPendingCount() const { return m_count; }
+	// Number of Retire calls that had to block because the queue was full
+	uint64_t GetForcedWaitCount() const { return m_forcedWaits; }
+
+private:
+	struct Entry
+	{
+		void* fence;
+		uint64_t fenceValue;
+		DestroyFunc destroy;
+		void* object;
+	};
+
+	bool IsComplete(const Entry& entry);
+	void DestroyAt(int index);
+
+	RetireFenceSource* m_fenceSource;
+	Entry m_entries[NRD_RETIRE_QUEUE_CAPACITY];
+	int m_count;
+	uint64_t m_forcedWaits;
+};
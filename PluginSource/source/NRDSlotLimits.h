@@ -0,0 +1,19 @@
+#pragma once
+
+// Slot and group sizes shared by modules that don't need NRD's headers (command channel, frame batcher).
+// NRDDenoiserConfig.h checks NRD_DENOISER_COUNT against nrd::Denoiser::MAX_NUM.
+
+// Total number of denoiser types
+static constexpr int NRD_DENOISER_COUNT = 19;
+
+// Maximum number of denoisers hosted by one shared NRD instance (denoiser group)
+static constexpr int MAX_GROUP_DENOISERS = 4;
+
+// Maximum number of resource slots in a merged group layout
+static constexpr int MAX_GROUP_RESOURCES = 24;
+
+// Number of denoiser groups that can be live at once
+static constexpr int NRD_MAX_GROUPS = 4;
+
+// Total number of runtime slots: one per denoiser type (0..18), then one per group
+static constexpr int NRD_SLOT_COUNT = NRD_DENOISER_COUNT + NRD_MAX_GROUPS;
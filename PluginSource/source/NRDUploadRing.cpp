@@ -0,0 +1,152 @@
+#include "NRDUploadRing.h"
+
+
+NRDUploadRing::NRDUploadRing()
+	: m_fenceSource(nullptr)
+	, m_capacity(0)
+	, m_head(0)
+	, m_used(0)
+	, m_openUsed(0)
+	, m_highWaterMark(0)
+	, m_bytesAllocated(0)
+	, m_growCount(0)
+	, m_forcedWaits(0)
+	, m_submissions()
+	, m_submissionCount(0)
+{
+}
+
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+	if (alignment <= 1)
+		return value;
+
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+
+void NRDUploadRing::Reset(uint64_t capacity)
+{
+	m_capacity = capacity;
+	m_head = 0;
+	m_used = 0;
+	m_openUsed = 0;
+	m_submissionCount = 0;
+}
+
+
+bool NRDUploadRing::IsComplete(const Submission& submission)
+{
+	if (submission.fence == nullptr || submission.fenceValue == 0 || m_fenceSource == nullptr)
+		return true;
+
+	return m_fenceSource->GetCompletedValue(submission.fence) >= submission.fenceValue;
+}
+
+
+void NRDUploadRing::ReclaimOldest()
+{
+	m_used -= m_submissions[0].used;
+
+	for (int i = 1; i < m_submissionCount; i++)
+		m_submissions[i - 1] = m_submissions[i];
+	m_submissionCount--;
+
+	// Empty ring — restart at 0 so the next submission gets the whole buffer unwrapped
+	if (m_used == 0)
+		m_head = 0;
+}
+
+
+int NRDUploadRing::Collect()
+{
+	// Submissions complete in order, so stop at the first one still in flight
+	int reclaimed = 0;
+	while (m_submissionCount > 0 && IsComplete(m_submissions[0]))
+	{
+		ReclaimOldest();
+		reclaimed++;
+	}
+
+	return reclaimed;
+}
+
+
+uint64_t NRDUploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+	if (size == 0 || m_capacity == 0)
+		return NRD_UPLOAD_RING_FULL;
+
+	Collect();
+
+	// The free space starts at m_head and is (capacity - used) long, wrapping past the end.
+	// An allocation never straddles the end: the rest of the buffer is skipped as padding.
+	uint64_t free = m_capacity - m_used;
+	uint64_t offset = AlignUp(m_head, alignment);
+	if (offset + size > m_capacity)
+		offset = 0;
+
+	uint64_t padding = offset >= m_head ? offset - m_head : m_capacity - m_head;
+	if (padding + size > free)
+		return NRD_UPLOAD_RING_FULL;
+
+	m_head = offset + size;
+	if (m_head == m_capacity)
+		m_head = 0;
+
+	m_used += padding + size;
+	m_openUsed += padding + size;
+	m_bytesAllocated += size;
+	if (m_used > m_highWaterMark)
+		m_highWaterMark = m_used;
+
+	return offset;
+}
+
+
+void NRDUploadRing::Grow(uint64_t size, uint64_t alignment)
+{
+	uint64_t needed = size + (alignment > 1 ? alignment : 0);
+	uint64_t capacity = m_capacity ? m_capacity : 1;
+	while (capacity < needed || capacity <= m_capacity)
+		capacity *= 2;
+
+	Reset(capacity);
+	m_growCount++;
+}
+
+
+void NRDUploadRing::EndSubmission(void* fence, uint64_t fenceValue)
+{
+	if (m_openUsed == 0)
+		return;
+
+	if (m_submissionCount == NRD_UPLOAD_RING_MAX_SUBMISSIONS)
+	{
+		Collect();
+
+		// Still full: the GPU is far behind. Wait for the oldest submission rather than grow.
+		if (m_submissionCount == NRD_UPLOAD_RING_MAX_SUBMISSIONS)
+		{
+			m_forcedWaits++;
+			const Submission& oldest = m_submissions[0];
+			if (!IsComplete(oldest))
+				m_fenceSource->WaitForValue(oldest.fence, oldest.fenceValue);
+			ReclaimOldest();
+		}
+	}
+
+	Submission& submission = m_submissions[m_submissionCount++];
+	submission.fence = fence;
+	submission.fenceValue = fenceValue;
+	submission.used = m_openUsed;
+	m_openUsed = 0;
+}
+
+
+void NRDUploadRing::GetPendingSubmission(int index, void** fence, uint64_t* fenceValue) const
+{
+	*fence = m_submissions[index].fence;
+	*fenceValue = m_submissions[index].fenceValue;
+}
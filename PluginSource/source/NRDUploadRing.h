@@ -0,0 +1,86 @@
+#pragma once
+
+#include "NRDRetireQueue.h"
+
+#include <stdint.h>
+
+
+// Submissions whose uploads can be in flight at once. Closing one with all of them still
+// pending blocks on the oldest, like a full NRDRetireQueue.
+static const int NRD_UPLOAD_RING_MAX_SUBMISSIONS = 16;
+
+// Allocate() result when the request doesn't fit
+static const uint64_t NRD_UPLOAD_RING_FULL = ~0ull;
+
+
+// Byte ring over one persistently mapped upload buffer shared by the plugin's own compute passes
+// (NRD writes its constants through its integration layer's buffers). Each submission sub-allocates linearly; its bytes are reclaimed once the fence of the
+// submission has passed. Only offsets are managed here — the D3D12 backend owns the buffer — so
+// the ring builds and runs without a graphics API.
+//
+// When a request doesn't fit even after reclaiming, the caller grows the ring: it retires the
+// old buffer against the pending submissions (GetPendingSubmission), calls Grow and maps a new
+// buffer of GetCapacity() bytes.
+//
+// Not thread safe — the caller serializes access (render thread).
+class NRDUploadRing
+{
+public:
+	NRDUploadRing();
+
+	void SetFenceSource(RetireFenceSource* fenceSource) { m_fenceSource = fenceSource; }
+
+	// Set the buffer size and forget every allocation (the buffer was recreated)
+	void Reset(uint64_t capacity);
+
+	// size bytes at an offset aligned to alignment (power of two) for the open submission.
+	// Returns the offset, or NRD_UPLOAD_RING_FULL.
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	// Start over with a larger buffer: the capacity doubles until size bytes at the given alignment
+	// fit. Pending submissions and the open one are forgotten — they belong to the old buffer.
+	void Grow(uint64_t size, uint64_t alignment);
+
+	// Close the open submission; its bytes are reclaimed once fence reaches fenceValue
+	void EndSubmission(void* fence, uint64_t fenceValue);
+
+	// Reclaim every closed submission whose fence has completed. Returns the number reclaimed.
+	int Collect();
+
+	int GetPendingSubmissionCount() const { return m_submissionCount; }
+	void GetPendingSubmission(int index, void** fence, uint64_t* fenceValue) const;
+	bool HasOpenAllocations() const { return m_openUsed != 0; }
+
+	uint64_t GetCapacity() const { return m_capacity; }
+	// Bytes in use by the open submission and submissions still in flight (including padding)
+	uint64_t GetOccupancy() const { return m_used; }
+	uint64_t GetHighWaterMark() const { return m_highWaterMark; }
+	// Payload bytes handed out since creation — the plugin passes' constant traffic, not NRD's
+	uint64_t GetBytesAllocated() const { return m_bytesAllocated; }
+	uint64_t GetGrowCount() const { return m_growCount; }
+	// Number of EndSubmission calls that had to block because every slot was in flight
+	uint64_t GetForcedWaitCount() const { return m_forcedWaits; }
+
+private:
+	struct Submission
+	{
+		void* fence;
+		uint64_t fenceValue;
+		uint64_t used; // Bytes (and padding) to give back when the submission completes
+	};
+
+	bool IsComplete(const Submission& submission);
+	void ReclaimOldest();
+
+	RetireFenceSource* m_fenceSource;
+	uint64_t m_capacity;
+	uint64_t m_head;     // Next free byte
+	uint64_t m_used;     // Allocated bytes from the oldest submission up to m_head
+	uint64_t m_openUsed; // Part of m_used owned by the open submission
+	uint64_t m_highWaterMark;
+	uint64_t m_bytesAllocated;
+	uint64_t m_growCount;
+	uint64_t m_forcedWaits;
+	Submission m_submissions[NRD_UPLOAD_RING_MAX_SUBMISSIONS]; // Closed submissions, oldest first
+	int m_submissionCount;
+};
@@ -0,0 +1,133 @@
+#include "NRDUpsample.h"
+
+#include <math.h>
+
+
+static int Clamp(int x, int lo, int hi)
+{
+	return x < lo ? lo : (x > hi ? hi : x);
+}
+
+
+void GetDownsampleTexel(const float* viewZ, int pitch, int x, int y, int divisor, int rectWidth, int rectHeight, int texel[2])
+{
+	texel[0] = x * divisor;
+	texel[1] = y * divisor;
+	float nearest = fabsf(viewZ[texel[1] * pitch + texel[0]]);
+
+	for (int j = 0; j < divisor; j++)
+	{
+		for (int i = 0; i < divisor; i++)
+		{
+			int sx = x * divisor + i;
+			int sy = y * divisor + j;
+			if (sx >= rectWidth || sy >= rectHeight)
+				continue;
+
+			float z = fabsf(viewZ[sy * pitch + sx]);
+			if (z < nearest)
+			{
+				nearest = z;
+				texel[0] = sx;
+				texel[1] = sy;
+			}
+		}
+	}
+}
+
+
+void GetUpsampleFootprint(int x, int y, int divisor, int lowRectWidth, int lowRectHeight, int taps[4][2], float weights[4])
+{
+	// Reduced texel centers sit at (i + 0.5) * divisor in full-resolution pixels
+	float u = ((float)x + 0.5f) / (float)divisor - 0.5f;
+	float v = ((float)y + 0.5f) / (float)divisor - 0.5f;
+	float originX = floorf(u);
+	float originY = floorf(v);
+	float fx = u - originX;
+	float fy = v - originY;
+
+	for (int i = 0; i < 4; i++)
+	{
+		int dx = i & 1;
+		int dy = i >> 1;
+		taps[i][0] = Clamp((int)originX + dx, 0, lowRectWidth - 1);
+		taps[i][1] = Clamp((int)originY + dy, 0, lowRectHeight - 1);
+		weights[i] = (dx ? fx : 1.0f - fx) * (dy ? fy : 1.0f - fy);
+	}
+}
+
+
+void EvaluateUpsample(const NRDUpsampleTexel& texel, float result[4])
+{
+	float z = fabsf(texel.viewZ);
+	float weights[4];
+	float sum = 0.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		float w = texel.tapWeight[i] * expf(-fabsf(fabsf(texel.tapViewZ[i]) - z) / (NRD_UPSAMPLE_DEPTH_SCALE * fmaxf(z, 1e-6f)));
+		if (texel.hasNormal)
+		{
+			float d = texel.normal[0] * texel.tapNormal[i][0] + texel.normal[1] * texel.tapNormal[i][1] + texel.normal[2] * texel.tapNormal[i][2];
+			w *= powf(fminf(fmaxf(d, 0.0f), 1.0f), NRD_UPSAMPLE_NORMAL_POWER);
+		}
+		weights[i] = w;
+		sum += w;
+	}
+
+	// Every tap is on another surface — take the one closest in depth rather than blur across the edge
+	if (sum < 1e-6f)
+	{
+		int closest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (fabsf(fabsf(texel.tapViewZ[i]) - z) < fabsf(fabsf(texel.tapViewZ[closest]) - z))
+				closest = i;
+		}
+
+		for (int i = 0; i < 4; i++)
+			weights[i] = i == closest ? 1.0f : 0.0f;
+		sum = 1.0f;
+	}
+
+	for (int c = 0; c < 4; c++)
+	{
+		float value = 0.0f;
+		for (int i = 0; i < 4; i++)
+			value += weights[i] * texel.tapValue[i][c];
+		result[c] = value / sum;
+	}
+}
+
+
+void UpsampleImage(const float* lowValue, const float* lowViewZ, const float* lowNormal, int lowWidth, int lowHeight,
+	const float* viewZ, const float* normal, int width, int height, int divisor, float* result)
+{
+	bool hasNormal = normal != nullptr && lowNormal != nullptr;
+
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			int pixel = y * width + x;
+			NRDUpsampleTexel texel = {};
+			texel.viewZ = viewZ[pixel];
+			texel.hasNormal = hasNormal ? 1 : 0;
+			for (int c = 0; hasNormal && c < 3; c++)
+				texel.normal[c] = normal[pixel * 3 + c];
+
+			int taps[4][2];
+			GetUpsampleFootprint(x, y, divisor, lowWidth, lowHeight, taps, texel.tapWeight);
+			for (int i = 0; i < 4; i++)
+			{
+				int tap = taps[i][1] * lowWidth + taps[i][0];
+				texel.tapViewZ[i] = lowViewZ[tap];
+				for (int c = 0; hasNormal && c < 3; c++)
+					texel.tapNormal[i][c] = lowNormal[tap * 3 + c];
+				for (int c = 0; c < 4; c++)
+					texel.tapValue[i][c] = lowValue[tap * 4 + c];
+			}
+
+			EvaluateUpsample(texel, result + pixel * 4);
+		}
+	}
+}
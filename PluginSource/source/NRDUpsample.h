@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Mixed-resolution denoising: a slot with divisor d runs NRD at ceil(width / d) x ceil(height / d).
+// Each reduced pixel copies every input from the texel of its d x d block nearest to the camera
+// (smallest |viewZ|, first in row order on ties), so guides and signals stay consistent. Outputs
+// are brought back with a joint-bilateral upsample guided by the full-resolution view Z and normal.
+// The D3D12 resample shaders mirror these functions — keep both in sync.
+static const int NRD_RESOLUTION_DIVISOR_MAX = 4;
+
+// Depth weight exp(-|z - zTap| / (scale * |z|)): a tap 5% nearer or farther keeps 1/e of its weight
+static const float NRD_UPSAMPLE_DEPTH_SCALE = 0.05f;
+
+// Normal weight saturate(dot(n, nTap))^power
+static const float NRD_UPSAMPLE_NORMAL_POWER = 8.0f;
+
+
+// One full-resolution pixel's upsample inputs: its guides and the 2x2 reduced taps around it
+struct NRDUpsampleTexel
+{
+	float viewZ;
+	float normal[3];          // Unit world normal; ignored without hasNormal
+	uint32_t hasNormal;       // 0 = depth weights only
+	float tapWeight[4];       // Bilinear weights (GetUpsampleFootprint)
+	float tapViewZ[4];
+	float tapNormal[4][3];
+	float tapValue[4][4];
+};
+
+
+// Reduced texel whose block (x, y) of a full-resolution view Z image (row pitch in floats) is copied
+void GetDownsampleTexel(const float* viewZ, int pitch, int x, int y, int divisor, int rectWidth, int rectHeight, int texel[2]);
+
+// The 2x2 reduced taps (clamped to the reduced rect) and bilinear weights of full-resolution pixel (x, y)
+void GetUpsampleFootprint(int x, int y, int divisor, int lowRectWidth, int lowRectHeight, int taps[4][2], float weights[4]);
+
+// Bilateral blend of the taps. If depth and normal reject every tap, the tap closest in depth is used.
+void EvaluateUpsample(const NRDUpsampleTexel& texel, float result[4]);
+
+// Reference for the upsample pass over whole images (row-major, tightly packed): value is RGBA,
+// normals are unit XYZ (null = depth weights only). result is width x height RGBA.
+void UpsampleImage(const float* lowValue, const float* lowViewZ, const float* lowNormal, int lowWidth, int lowHeight,
+	const float* viewZ, const float* normal, int width, int height, int divisor, float* result);
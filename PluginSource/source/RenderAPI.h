@@ -1,11 +1,12 @@
 #pragma once
 
 #include "Unity/IUnityGraphics.h"
+#include "NRDMemoryEstimate.h"
 
 #include <stddef.h>
-#include <d3d12.h>
 
 struct IUnityInterfaces;
+struct NRDFrameParams;
 
 
 // Ring buffer size for per-frame matrix data. Must be power of 2.
@@ -13,6 +14,78 @@ struct IUnityInterfaces;
 static const int MATRIX_RING_SIZE = 4;
 static const int MATRIX_RING_MASK = MATRIX_RING_SIZE - 1;
 
+// Frame slots with this bit set refer to a frame delivered as an NRDFrameParams block
+// (SetFrameParams) instead of a matrix ring entry; the low bits hold its frame index.
+static const int NRD_FRAME_PARAMS_SLOT_BIT = 1 << 30;
+static const int NRD_FRAME_PARAMS_INDEX_MASK = NRD_FRAME_PARAMS_SLOT_BIT - 1;
+
+// Queue a denoiser slot's work is submitted to (see NRDSetQueueMode)
+enum NRDQueueMode
+{
+	NRD_QUEUE_GRAPHICS = 0,      // Unity's graphics queue via ExecuteCommandList (default)
+	NRD_QUEUE_ASYNC_COMPUTE = 1  // Plugin-owned compute queue, overlapping Unity's graphics work
+};
+
+// What a slot's IN_VIEWZ texture holds (see NRDSetInputConventions)
+enum NRDViewZMode
+{
+	NRD_VIEWZ_LINEAR = 0,       // Linear view depth, read by NRD directly (default)
+	NRD_VIEWZ_DEVICE_DEPTH = 1  // Raw device depth — converted by the plugin's prepare pass
+};
+
+// Unity textures read by the input-preparation pass, in NRDSetPrepareSources order
+enum NRDPrepareSource
+{
+	NRD_PREPARE_MOTION_VECTORS,  // _CameraMotionVectorsTexture (currentUv - previousUv)
+	NRD_PREPARE_DEPTH,           // Camera depth, as projected by the NRDSetMatrix projection
+	NRD_PREPARE_GBUFFER0,        // Albedo (rgb)
+	NRD_PREPARE_GBUFFER1,        // Specular (rgb), smoothness (a)
+	NRD_PREPARE_GBUFFER2,        // World normal * 0.5 + 0.5 (rgb)
+	NRD_PREPARE_DIFFUSE,         // Diffuse radiance (rgb), hit distance in world units (a)
+	NRD_PREPARE_SPECULAR,        // Specular radiance (rgb), hit distance in world units (a)
+	NRD_PREPARE_SOURCE_COUNT
+};
+
+// Textures read by the composite pass besides NRD's outputs, in NRDSetCompositeTarget order
+enum NRDCompositeSource
+{
+	NRD_COMPOSITE_ALBEDO,           // Diffuse albedo (GBuffer0); null = the NRD_PREPARE_GBUFFER0 source
+	NRD_COMPOSITE_SPECULAR_ALBEDO,  // Specular albedo (GBuffer1); null = the NRD_PREPARE_GBUFFER1 source
+	NRD_COMPOSITE_NORMAL,           // World normal * 0.5 + 0.5 (GBuffer2); null = the NRD_PREPARE_GBUFFER2 source
+	NRD_COMPOSITE_BASE,             // Color the result is added to (e.g. direct lighting); null = none
+	NRD_COMPOSITE_SOURCE_COUNT
+};
+
+
+// Outcome of a background initialization, reported at the frame boundary it was swapped in
+struct NRDAsyncInitResult
+{
+	int slot;
+	bool succeeded;
+	int error;   // GetLastInitError code when !succeeded
+	unsigned long long ticket; // Caller-supplied id passed to NRDInitializeAsync
+};
+
+
+// A slot whose dispatch was skipped for a reason the caller has to hear about, reported once
+struct NRDDispatchFailure
+{
+	int slot;
+	int error;   // GetLastInitError code
+};
+
+
+// One initialized slot in NRDGetMemoryReport. Suspended slots (NRDSetMemoryPolicy) are listed
+// with a zero footprint.
+struct NRDMemoryReportEntry
+{
+	int slot;
+	int width;
+	int height;
+	bool suspended;
+	NRDMemoryFootprint memory;
+};
+
 
 // Super-simple "graphics abstraction". This is nothing like how a proper platform abstraction layer would look like;
 // all this does is a base interface for whatever our plugin sample needs. Which is only "draw some triangles"
@@ -29,14 +102,109 @@ public:
 
 	virtual void ReleaseResources() = 0;
 
-	// Generic NRD interface — denoiserType maps to nrd::Denoiser enum value (0..18)
+	// Generic NRD interface — denoiserType maps to nrd::Denoiser enum value (0..18).
+	// NRDDenoise/NRDRelease/NRDRecord also accept group slots (NRD_DENOISER_COUNT + groupIndex).
 	virtual bool NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount) = 0;
+	virtual bool NRDInitializeGroup(int groupIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount) { return false; }
 	virtual void NRDDenoise(int denoiserType, int frameSlot) = 0;
 	virtual void NRDRelease(int denoiserType) = 0;
 	virtual void NRDReleaseAllSlots() {}
+
+	// Background initialization — the slot's current instance (if any) keeps running while the new
+	// one is created on a worker thread. NRDPollAsyncInitialize swaps finished builds in and reports
+	// them; call it at a frame boundary on the render thread.
+	virtual bool NRDInitializeAsync(int slotIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount, unsigned long long ticket) { return false; }
+	virtual int NRDPollAsyncInitialize(NRDAsyncInitResult* results, int maxResults) { return 0; }
+
+	// Slots whose dispatch failed since the last call (e.g. error 11). Call it on the render thread
+	// after NRDPollAsyncInitialize; the caller releases the reported slots.
+	virtual int NRDPollDispatchFailures(NRDDispatchFailure* failures, int maxFailures) { return 0; }
+
+	// Batched execution — denoisers recorded between NRDBeginBatch and NRDSubmitBatch share one
+	// command list and one submission. Backends without batching execute each record immediately.
+	virtual void NRDBeginBatch() {}
+	virtual void NRDRecord(int denoiserType, int frameSlot) { NRDDenoise(denoiserType, frameSlot); }
+	virtual void NRDSubmitBatch() {}
+
+	// Async compute — the queue mode is applied by the slot's next (re)initialization.
+	// NRDSyncAsyncCompute makes the graphics queue wait (GPU-side) for outstanding compute work.
+	virtual bool SetQueueMode(int denoiserType, int queueMode) { return queueMode == NRD_QUEUE_GRAPHICS; }
+	virtual void NRDSyncAsyncCompute() {}
+
+	// Input preparation — sources (NRDPrepareSource order, null = absent) the slot's NRD inputs are
+	// written from right before each dispatch. sourceCount 0 turns the pass off.
+	virtual void SetPrepareSources(int denoiserType, void* const* sources, int sourceCount) {}
+	// How the slot's bound IN_MV and IN_VIEWZ are encoded; NRD is told instead of the inputs being converted
+	virtual void SetInputConventions(int denoiserType, float motionVectorScaleX, float motionVectorScaleY, bool motionVectorsInPixels, int viewZMode) {}
+	// Output composite — after each dispatch, the slot's outputs are resolved into target (null = off)
+	virtual void SetCompositeTarget(int denoiserType, void* target, void* const* sources, int sourceCount, int options) {}
+
+	// Mixed resolution — NRD runs at 1 / divisor of the size per axis, applied by the slot's next
+	// (re)initialization. Inputs are downsampled before and outputs upsampled after each dispatch.
+	virtual bool SetResolutionScale(int denoiserType, int divisor) { return divisor == 1; }
+
+	// Checkerboard input — NRDCheckerboardMode for the slot's REBLUR/RELAX members, validated and
+	// applied by the slot's next (re)initialization
+	virtual bool SetCheckerboardMode(int denoiserType, int mode) { return mode == 0; }
+
 	virtual void SetMatrix(int frameIndex, float viewToClipMatrix[16], float worldToViewMatrix[16], float deltaTime) = 0;
 	virtual void SetLightDirection(float x, float y, float z) {}
+	// Dynamic resolution — active render rect for frameIndex (same ring as SetMatrix)
+	virtual void SetRenderRect(int frameIndex, int width, int height) {}
+	// Per-frame parameter block (render thread) — referenced by NRD_FRAME_PARAMS_SLOT_BIT frame slots
+	virtual void SetFrameParams(const NRDFrameParams& params) {}
 	virtual int GetLastInitError() { return 6; }
+	// Resource index and DXGI format behind the last error 9 (format not allowed for its slot)
+	virtual bool GetFormatMismatch(int* resourceIndex, int* format) { return false; }
+
+	// Number of times recording had to wait for the GPU to release a command allocator
+	virtual unsigned long long GetCommandRingStallCount() { return 0; }
+
+	// Committed initializations by outcome: new NRD instance / texture rebind only / nothing changed
+	virtual void GetInitCounters(unsigned long long* recreates, unsigned long long* rebinds, unsigned long long* noOps)
+	{
+		if (recreates) *recreates = 0;
+		if (rebinds) *rebinds = 0;
+		if (noOps) *noOps = 0;
+	}
+
+	// Constant upload ring of the plugin's own passes: buffer size, payload bytes uploaded since
+	// creation, peak occupancy
+	virtual void GetUploadRingStats(unsigned long long* capacity, unsigned long long* bytesUploaded, unsigned long long* highWaterMark)
+	{
+		if (capacity) *capacity = 0;
+		if (bytesUploaded) *bytesUploaded = 0;
+		if (highWaterMark) *highWaterMark = 0;
+	}
+
+	// Deferred destruction: objects waiting for their fence, and retirements that had to block on the
+	// oldest one because the queue was full
+	virtual void GetRetireQueueStats(int* pending, unsigned long long* forcedWaits)
+	{
+		if (pending) *pending = 0;
+		if (forcedWaits) *forcedWaits = 0;
+	}
+
+	// VRAM residency — live instances idle for more than idleFrames frames (0 = never), or the least
+	// recently used ones while the adapter is over its budget minus reserveBytes, are suspended:
+	// their instance is destroyed and rebuilt on a worker once executed again. UpdateResidency runs
+	// on the render thread at the start of every execute event.
+	virtual void SetMemoryPolicy(int idleFrames, bool evictUnderPressure, unsigned long long reserveBytes) {}
+	virtual void UpdateResidency() {}
+	virtual void GetResidencyStats(unsigned long long* residentBytes, unsigned long long* suspensions, unsigned long long* resumes)
+	{
+		if (residentBytes) *residentBytes = 0;
+		if (suspensions) *suspensions = 0;
+		if (resumes) *resumes = 0;
+	}
+
+	// Footprint of every initialized slot (up to maxEntries, returns the number written) and of the
+	// plugin passes' descriptor heaps and upload ring (shared, may be null)
+	virtual int GetMemoryReport(NRDMemoryReportEntry* entries, int maxEntries, NRDMemoryFootprint* shared)
+	{
+		if (shared) *shared = {};
+		return 0;
+	}
 };
 
 
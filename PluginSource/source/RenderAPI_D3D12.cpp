@@ -1,13 +1,19 @@
 #define NOMINMAX
 
 #pragma comment(lib, "d3d12")
+#pragma comment(lib, "dxgi")
 
 #include "RenderAPI.h"
 #include "PlatformBase.h"
 #include "NRDDenoiserConfig.h"
 
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 // Direct3D 12 implementation of RenderAPI.
 
@@ -16,9 +22,26 @@
 
 #include <cassert>
 #include <d3d12.h>
+#include <dxgi1_4.h>
 #include "Unity/IUnityGraphicsD3D12.h"
+#include "Unity/IUnityMemoryManager.h"
 
 #include "D3DCommandQueue.h"
+#include "D3D12CommandRing.h"
+#include "D3D12PreparePass.h"
+#include "D3D12CompositePass.h"
+#include "D3D12ResamplePass.h"
+#include "NRDRetireQueue.h"
+#include "NRDInitDiff.h"
+#include "NRDFrameParams.h"
+#include "NRDUploadRing.h"
+#include "NRDResidencyPolicy.h"
+#include "NRDMemoryEstimate.h"
+#include "NRDAllocator.h"
+#include "NRDLibrary.h"
+#include "NRDComposite.h"
+#include "NRDUpsample.h"
+#include "NRDCheckerboard.h"
 
 // Gameworks - NRI headers (must be included before NRD integration
 // so that NRI_WRAPPER_D3D12_H is defined when NRDIntegration.hpp is parsed)
@@ -60,6 +83,55 @@ static DXGI_FORMAT ResolveTypelessFormat(DXGI_FORMAT format)
 	}
 }
 
+// The NRD format a typed DXGI format reads as, for slot format validation (MAX_NUM = unsupported)
+static nrd::Format GetNrdFormat(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R8_UNORM:             return nrd::Format::R8_UNORM;
+	case DXGI_FORMAT_R8G8B8A8_UNORM:       return nrd::Format::RGBA8_UNORM;
+	case DXGI_FORMAT_R8G8B8A8_SNORM:       return nrd::Format::RGBA8_SNORM;
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:  return nrd::Format::RGBA8_SRGB;
+	case DXGI_FORMAT_R16_UNORM:            return nrd::Format::R16_UNORM;
+	case DXGI_FORMAT_R16_FLOAT:            return nrd::Format::R16_SFLOAT;
+	case DXGI_FORMAT_R16G16_FLOAT:         return nrd::Format::RG16_SFLOAT;
+	case DXGI_FORMAT_R16G16B16A16_UNORM:   return nrd::Format::RGBA16_UNORM;
+	case DXGI_FORMAT_R16G16B16A16_SNORM:   return nrd::Format::RGBA16_SNORM;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:   return nrd::Format::RGBA16_SFLOAT;
+	case DXGI_FORMAT_R32_FLOAT:            return nrd::Format::R32_SFLOAT;
+	case DXGI_FORMAT_R32G32_FLOAT:         return nrd::Format::RG32_SFLOAT;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:   return nrd::Format::RGBA32_SFLOAT;
+	case DXGI_FORMAT_R10G10B10A2_UNORM:    return nrd::Format::R10_G10_B10_A2_UNORM;
+	case DXGI_FORMAT_R11G11B10_FLOAT:      return nrd::Format::R11_G11_B10_UFLOAT;
+	default:                               return nrd::Format::MAX_NUM;
+	}
+}
+
+// Typed SRV format for reading a resource in a shader — depth formats read their depth plane
+static DXGI_FORMAT ResolveReadFormat(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_R32_TYPELESS:
+	case DXGI_FORMAT_D32_FLOAT:             return DXGI_FORMAT_R32_FLOAT;
+	case DXGI_FORMAT_R24G8_TYPELESS:
+	case DXGI_FORMAT_D24_UNORM_S8_UINT:     return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+	case DXGI_FORMAT_R32G8X24_TYPELESS:
+	case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:  return DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
+	case DXGI_FORMAT_R16_TYPELESS:
+	case DXGI_FORMAT_D16_UNORM:             return DXGI_FORMAT_R16_UNORM;
+	default:                                return ResolveTypelessFormat(format);
+	}
+}
+
+// View format for copying texels between resources in a shader — sRGB is copied as raw UNORM bits,
+// since sRGB has no UAV support
+static DXGI_FORMAT ResolveCopyFormat(DXGI_FORMAT format)
+{
+	format = ResolveReadFormat(format);
+	return format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB ? DXGI_FORMAT_R8G8B8A8_UNORM : format;
+}
+
 // Helper: create an nrd::Resource from a D3D12 resource pointer
 static nrd::Resource MakeD3D12Resource(void* ptr)
 {
@@ -79,27 +151,175 @@ static nrd::Resource MakeD3D12Resource(void* ptr)
 }
 
 
-// Per-denoiser runtime state — lazily initialized
+// Back the NRD/NRI allocators with Unity's memory manager (visible in Unity's memory profiler)
+// when the interface is available. 0 = always the CRT heap.
+#define NRD_USE_UNITY_MEMORY_MANAGER 1
+
+
+// An integration with its own allocator for the NRD instance's CPU memory. Destroy() runs
+// before delete, so the allocator outlives everything NRD frees through it.
+struct PluginIntegration : public nrd::Integration
+{
+	explicit PluginIntegration(const NRDUpstreamAllocator* upstream) : allocator(upstream) { }
+
+	NRDAllocator allocator;
+};
+
+
+// Everything needed to create a slot's integration. Self-contained (the NRD/NRI descs point
+// into it), so creation can run on a worker thread while the render thread keeps denoising.
+struct SlotBuild
+{
+	int slotIndex = 0;
+	DenoiserGroupLayout layout = {};
+	int width = 0;
+	int height = 0;
+	void* resources[MAX_GROUP_RESOURCES] = {};
+	uint32_t formats[MAX_GROUP_RESOURCES] = {};
+	bool useCompute = false;
+	int divisor = 1; // Resolution divisor — the instance is created at the reduced size
+	int checkerboard = NRD_CHECKERBOARD_OFF;
+	int viewZMode = NRD_VIEWZ_LINEAR;
+	unsigned long long ticket = 0;
+	bool resume = false; // Rebuild of a suspended slot (ResumeSlot) — committed without being reported
+	InitAction action = InitAction::RECREATE; // NO_OP/REBIND builds never create an integration
+
+	nrd::DenoiserDesc denoiserDescs[MAX_GROUP_DENOISERS] = {};
+	nrd::InstanceCreationDesc instanceDesc = {};
+	nrd::IntegrationCreationDesc integrationDesc = {};
+	nri::Device* nriDevice = nullptr;        // The backend's shared wrapper — outlives every build
+	const NRDUpstreamAllocator* upstream = nullptr; // For the instance's allocator (null = CRT)
+	uint32_t descriptorSize = NRD_TYPICAL_DESCRIPTOR_SIZE;
+
+	nrd::Integration* integration = nullptr; // Result — null if creation failed
+	nrd::Result result = nrd::Result::FAILURE;
+	NRDMemoryFootprint memory = {};          // Measured footprint of the new instance
+	std::future<void> task;                  // Valid while (or after) the build ran on a worker
+};
+
+
+// Creates a build's integration; defined with the init functions below
+static void RunSlotBuild(SlotBuild* build);
+
+
+// Frames a suspended slot waits before retrying a failed rebuild; doubles with each consecutive
+// failure, up to NRD_RESUME_RETRY_FRAMES << NRD_RESUME_RETRY_MAX_SHIFT
+static const UINT64 NRD_RESUME_RETRY_FRAMES = 30;
+static const int NRD_RESUME_RETRY_MAX_SHIFT = 5;
+
+
+// Initial size of the plugin passes' constant upload ring (NRDUploadRing); it doubles when a frame outgrows it
+static const UINT64 NRD_UPLOAD_RING_INITIAL_SIZE = 256 * 1024;
+
+
+// Resource states handed to Unity per slot: its outputs, the prepare pass's sources and targets,
+// and the composite pass's sources and target
+static const int NRD_SLOT_MAX_STATES = MAX_GROUP_OUTPUT_RESOURCES + NRD_PREPARE_SOURCE_COUNT + NRD_PREPARE_TARGET_COUNT
+	+ NRD_COMPOSITE_SOURCE_COUNT + 1;
+
+
+// Per-slot runtime state — lazily initialized.
+// Slots 0..18 host a single denoiser type; group slots host several denoisers in one NRD instance.
 struct DenoiserSlot
 {
-	nrd::Integration integration;
-	ID3D12CommandAllocator* cmdAlloc = nullptr;
-	ID3D12GraphicsCommandList* cmdList = nullptr;
-	void* resources[MAX_DENOISER_RESOURCES] = {};
-	UnityGraphicsD3D12ResourceState outputStates[MAX_OUTPUT_RESOURCES] = {};
+	nrd::Integration* integration = nullptr; // Heap-allocated so a released instance can outlive the slot in the retire queue
+	DenoiserGroupLayout layout = {};
+	D3D12CommandRing cmdRing;
+	void* resources[MAX_GROUP_RESOURCES] = {};
+	uint32_t resourceFormats[MAX_GROUP_RESOURCES] = {}; // DXGI_FORMAT of each resource when bound (init diffing)
+	UnityGraphicsD3D12ResourceState outputStates[NRD_SLOT_MAX_STATES] = {};
 	int outputStateCount = 0;
-	int width = 0;
+	void* prepareSources[NRD_PREPARE_SOURCE_COUNT] = {}; // NRDSetPrepareSources textures (NRDPrepareSource order)
+	bool prepareEnabled = false;                          // Run the input-preparation pass before each dispatch
+	float motionVectorScale[2] = { 1.0f, 1.0f };          // NRDSetInputConventions: IN_MV as bound -> NRD's backward UV motion
+	bool motionVectorsInPixels = false;                   // Scale is additionally divided by the render rect
+	int viewZMode = NRD_VIEWZ_LINEAR;                     // Requested via SetInputConventions, applied by the next InitializeSlot
+	bool viewZIsDepth = false;                            // IN_VIEWZ of the live instance holds device depth, converted into viewZTexture
+	ID3D12Resource* viewZTexture = nullptr;               // Plugin-owned R32_FLOAT view Z NRD reads in device depth mode
+	void* compositeTarget = nullptr;                      // NRDSetCompositeTarget: written after each dispatch (null = off)
+	void* compositeSources[NRD_COMPOSITE_SOURCE_COUNT] = {}; // NRDCompositeSource order
+	uint32_t compositeOptions = 0;                        // NRD_COMPOSITE_OPTIONS bits
+	int resolutionDivisor = 1;                            // Requested via SetResolutionScale, applied by the next InitializeSlot
+	int divisor = 1;                                      // Divisor of the live instance: NRD runs at width / divisor
+	ID3D12Resource* reducedTextures[MAX_GROUP_RESOURCES] = {}; // Plugin-owned reduced copies NRD binds when divisor > 1
+	int checkerboardMode = NRD_CHECKERBOARD_OFF;          // Requested via SetCheckerboardMode, applied by the next InitializeSlot
+	int checkerboard = NRD_CHECKERBOARD_OFF;              // NRDCheckerboardMode of the live instance (REBLUR/RELAX members)
+	int width = 0;  // Resource (allocation) size — the maximum render rect in dynamic resolution mode
 	int height = 0;
-	bool cmdObjectsCreated = false;
+	int prevRectWidth = 0;  // Render rect of the last dispatch (NRD's rectSizePrev), 0 = none yet
+	int prevRectHeight = 0;
 	UINT64 lastFenceValue = 0; // Fence value from last ExecuteCommandList — used to wait for GPU completion before release
+	int queueMode = NRD_QUEUE_GRAPHICS; // Requested via SetQueueMode, applied by the next InitializeSlot
+	bool onComputeQueue = false;        // Queue the current integration/command ring were built for
+	SlotBuild* pendingBuild = nullptr;  // Background NRDInitializeAsync build, swapped in when ready
+	NRDMemoryFootprint memory = {};     // Footprint of the live instance (EstimateInstanceMemory)
+	UINT64 lastUsedFrame = 0;           // Unity frame (next frame fence value) of the last dispatch or commit
+	bool suspended = false;             // Instance dropped by the memory policy — its next execute starts a rebuild
+	int resumeFailures = 0;             // Consecutive failed rebuilds of the suspended instance
+	UINT64 resumeRetryFrame = 0;        // Unity frame before which no rebuild is attempted after a failure
+	int dispatchError = 0;              // Error that made a dispatch skip the slot, until NRDPollDispatchFailures reports it
+};
+
+
+// Block until fence reaches fenceValue. D3D12 forbids resetting a command allocator
+// or destroying resources while the GPU may still be reading from them.
+static void WaitForFence(ID3D12Fence* fence, UINT64 fenceValue, DWORD timeoutMs)
+{
+	if (fence == nullptr || fenceValue == 0)
+		return;
+
+	if (fence->GetCompletedValue() < fenceValue)
+	{
+		HANDLE event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+		if (event)
+		{
+			fence->SetEventOnCompletion(fenceValue, event);
+			WaitForSingleObject(event, timeoutMs); // timeout to avoid infinite hang
+			CloseHandle(event);
+		}
+	}
+}
+
+
+// ID3D12Fence access for the retire queue
+class D3D12RetireFenceSource : public RetireFenceSource
+{
+public:
+	uint64_t GetCompletedValue(void* fence) override
+	{
+		return ((ID3D12Fence*)fence)->GetCompletedValue();
+	}
+
+	void WaitForValue(void* fence, uint64_t value) override
+	{
+		WaitForFence((ID3D12Fence*)fence, value, 5000);
+	}
 };
 
 
-const UINT kNodeMask = 0;
+static void DestroyRetiredIntegration(void* object)
+{
+	PluginIntegration* integration = (PluginIntegration*)object;
+	integration->Destroy();
+	delete integration;
+}
+
+
+static void DestroyRetiredCommandRing(void* object)
+{
+	delete (D3D12CommandRing*)object;
+}
+
+
+// One reference per retire entry — a buffer read by several pending submissions is retired once per fence
+static void DestroyRetiredResource(void* object)
+{
+	((ID3D12Resource*)object)->Release();
+}
 
 
-// Per-frame matrix snapshot stored in a ring buffer.
-// The main thread writes via SetMatrix; the render thread reads via NRDDenoise.
+// Per-frame matrix snapshot. Legacy callers fill a ring entry from the main thread via SetMatrix;
+// NRDFrameParams blocks fill the render-thread frame arena via SetFrameParams.
 struct FrameMatrixData
 {
 	float viewToClip[16];
@@ -108,9 +328,35 @@ struct FrameMatrixData
 	float worldToViewPrev[16];
 	int frameIndex;
 	float deltaTime;
+
+	// Dynamic resolution: active render rect, valid only while rectFrameIndex == frameIndex
+	// (so a frame without NRDSetRenderRect falls back to the full resource size)
+	int rectFrameIndex;
+	int rectWidth;
+	int rectHeight;
+
+	// NRDFrameOverride bits and the values they select (always 0 for ring entries)
+	uint32_t overrideMask;
+	float lightDirection[3];
+	uint32_t accumulationMode;
+	float denoisingRange;
+	float disocclusionThreshold;
+	float splitScreen;
 };
 
 
+// Unity passes GL.GetGPUProjectionMatrix(proj, false) — standard GPU projection
+// without RT Y-flip. Apply the render-texture Y-flip for D3D12 convention.
+// In column-major layout: elements 4,5,6,7 are column 1 (the Y row values).
+static void FlipViewToClipY(float viewToClip[16])
+{
+	viewToClip[4] = -viewToClip[4];
+	viewToClip[5] = -viewToClip[5];
+	viewToClip[6] = -viewToClip[6];
+	viewToClip[7] = -viewToClip[7];
+}
+
+
 class RenderAPI_D3D12 : public RenderAPI
 {
 public:
@@ -122,28 +368,190 @@ public:
 private:
 	void ReleaseResources();
 	bool NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount);
-	void NRDDenoise(int denoiserType, int frameSlot);
-	void NRDRelease(int denoiserType);
+	bool NRDInitializeGroup(int groupIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount) override;
+	void NRDDenoise(int slotIndex, int frameSlot);
+	void NRDRelease(int slotIndex);
 	void NRDReleaseAllSlots();
+	void NRDBeginBatch() override;
+	void NRDRecord(int slotIndex, int frameSlot) override;
+	void NRDSubmitBatch() override;
+	bool SetQueueMode(int slotIndex, int queueMode) override;
+	void NRDSyncAsyncCompute() override;
 	void SetMatrix(int frameIndex, float _viewToClipMatrix[16], float _worldToViewMatrix[16], float deltaTime);
 	void SetLightDirection(float x, float y, float z) override;
-
-	bool CreateCommandObjects(DenoiserSlot& slot);
-	void ApplyDenoiserSettings(int type, DenoiserSlot& slot);
+	void SetRenderRect(int frameIndex, int width, int height) override;
+	void SetFrameParams(const NRDFrameParams& params) override;
+	const FrameMatrixData* ResolveFrame(int frameSlot) const;
+
+	void WaitForFrameFence(UINT64 fenceValue, DWORD timeoutMs);
+	void RetireIntegration(DenoiserSlot& slot);
+	bool EnsureComputeQueue();
+	void DenoiseOnComputeQueue(int slotIndex, int frameSlot);
+	bool InitializeSlot(int slotIndex, const DenoiserGroupLayout& layout, int renderWidth, int renderHeight, void** resources, int resourceCount);
+	bool NRDInitializeAsync(int slotIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount, unsigned long long ticket) override;
+	int NRDPollAsyncInitialize(NRDAsyncInitResult* results, int maxResults) override;
+	int NRDPollDispatchFailures(NRDDispatchFailure* failures, int maxFailures) override;
+	SlotBuild* PrepareSlotBuild(int slotIndex, const DenoiserGroupLayout& layout, int renderWidth, int renderHeight, void** resources, int resourceCount);
+	bool CommitSlotBuild(SlotBuild* build);
+	void CancelPendingBuild(DenoiserSlot& slot);
+	void CollectAbandonedBuilds();
+	void BuildOutputStates(DenoiserSlot& slot);
+	void GetInitCounters(unsigned long long* recreates, unsigned long long* rebinds, unsigned long long* noOps) override;
+	void RecordDenoise(int slotIndex, int frameSlot, ID3D12GraphicsCommandList* cmdList, ID3D12CommandAllocator* cmdAlloc);
+	void SetPrepareSources(int slotIndex, void* const* sources, int sourceCount) override;
+	void SetInputConventions(int slotIndex, float motionVectorScaleX, float motionVectorScaleY, bool motionVectorsInPixels, int viewZMode) override;
+	int GetPrepareBindings(const DenoiserSlot& slot, ID3D12Resource** sources, ID3D12Resource** targets);
+	bool EnsureViewZTexture(DenoiserSlot& slot);
+	void SetCompositeTarget(int slotIndex, void* target, void* const* sources, int sourceCount, int options) override;
+	uint32_t GetCompositeBindings(const DenoiserSlot& slot, ID3D12Resource** inputs);
+	void RecordComposite(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList);
+	void RecordPrepare(DenoiserSlot& slot, const FrameMatrixData& frame, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList);
+	template <typename Pass> bool EnsurePass(Pass& pass, ID3D12Device* device);
+	bool SetResolutionScale(int slotIndex, int divisor) override;
+	ID3D12Resource* GetDenoiseResource(const DenoiserSlot& slot, int resourceIndex) const;
+	bool EnsureReducedTextures(DenoiserSlot& slot);
+	bool PrepareDispatch(DenoiserSlot& slot);
+	void RetireSlotTexture(DenoiserSlot& slot, ID3D12Resource*& texture);
+	void RetireReducedTextures(DenoiserSlot& slot);
+	void RecordDownsample(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList);
+	void RecordUpsample(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList);
+	void ApplyDenoiserSettings(DenoiserSlot& slot, const float lightDirection[3]);
 	void SetCommonSettings();
 	int GetLastInitError() override { return m_lastInitError; }
+	bool GetFormatMismatch(int* resourceIndex, int* format) override;
+	bool ValidateResourceFormats(const DenoiserGroupLayout& layout, void** resources, int resourceCount, bool viewZIsDepth);
+	bool ValidateCheckerboardLayout(const DenoiserGroupLayout& layout, void** resources, int resourceCount, int renderWidth, int renderHeight, int mode, int divisor);
+	bool SetCheckerboardMode(int slotIndex, int mode) override;
+	unsigned long long GetCommandRingStallCount() override;
+	bool EnsureNriDevice();
+	void DestroyNriDevice();
+	void CreateUnityAllocator(IUnityInterfaces* interfaces);
+	void DestroyUnityAllocator();
+	bool CreateUploadBuffer(UINT64 size);
+	void RetireUploadBuffer();
+	bool AllocateUpload(UINT64 size, void** cpuAddress, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress);
+	void CloseSubmission(ID3D12Fence* fence, UINT64 fenceValue);
+	void GetUploadRingStats(unsigned long long* capacity, unsigned long long* bytesUploaded, unsigned long long* highWaterMark) override;
+	void GetRetireQueueStats(int* pending, unsigned long long* forcedWaits) override;
+	void SetMemoryPolicy(int idleFrames, bool evictUnderPressure, unsigned long long reserveBytes) override;
+	void UpdateResidency() override;
+	void GetResidencyStats(unsigned long long* residentBytes, unsigned long long* suspensions, unsigned long long* resumes) override;
+	void PublishMemoryReport();
+	int GetMemoryReport(NRDMemoryReportEntry* entries, int maxEntries, NRDMemoryFootprint* shared) override;
+	bool QueryVideoMemory(UINT64* usage, UINT64* budget);
+	void SetUnityMemoryReservation(UINT64 pluginBytes);
+	void SuspendSlot(int slotIndex);
+	void ResumeSlot(int slotIndex);
+	void DeferResume(DenoiserSlot& slot);
 
 private:
 	int m_lastInitError = 0;
+	// Set with error 9 on the render thread, read from script threads (-1 = none yet)
+	std::atomic<int> m_formatMismatchIndex{ -1 };
+	std::atomic<int> m_formatMismatchFormat{ 0 };
 	IUnityGraphicsD3D12v4* s_D3D12;
+
+	// One NRI device wrapper around Unity's device, shared by every integration (its descriptor
+	// heaps and allocators included). Created at device initialize, destroyed at shutdown after
+	// every integration using it.
+	nri::Device* m_nriDevice = nullptr;
+	ID3D12CommandQueue* m_nriQueue = nullptr;
+	nri::QueueFamilyD3D12Desc m_nriQueueFamily = {};
+
+	// CPU memory of NRI (the shared device) and of every NRD instance comes from pooled
+	// NRDAllocators, so steady-state frames make no heap allocations. Their upstream is Unity's
+	// memory manager when available (m_upstream, set at device initialize), otherwise the CRT.
+	NRDAllocator m_deviceAllocator;
+	IUnityMemoryManager* m_unityMemory = nullptr;
+	UnityAllocator* m_unityAllocator = nullptr;
+	NRDUpstreamAllocator m_unityUpstream = {};
+	const NRDUpstreamAllocator* m_upstream = nullptr;
 	nrd::CommonSettings commonSettings;
-	DenoiserSlot m_slots[NRD_DENOISER_COUNT];
+	DenoiserSlot m_slots[NRD_SLOT_COUNT];
+
+	// Shared command list ring for batched execution (one submission for every denoiser in the batch).
+	// Async compute slots recorded into an open batch are submitted right after it, so descriptors
+	// and constants allocated while the batch is open all belong to the batch's submission.
+	D3D12CommandRing m_batchRing;
+	bool m_batchOpen = false;
+	int m_batchSlots[NRD_SLOT_COUNT] = {};
+	int m_batchSlotCount = 0;
+	int m_batchComputeSlots[NRD_SLOT_COUNT] = {};
+	int m_batchComputeFrameSlots[NRD_SLOT_COUNT] = {};
+	int m_batchComputeCount = 0;
+	UnityGraphicsD3D12ResourceState m_batchStates[NRD_SLOT_COUNT * NRD_SLOT_MAX_STATES] = {};
+	int m_batchStateCount = 0;
+
+	// Async compute path — created on first use by a slot in NRD_QUEUE_ASYNC_COMPUTE mode.
+	// Only the manager's compute queue is used; Unity's queue stays the graphics queue.
+	Direct3DQueueManager* m_queueManager = nullptr;
+	ID3D12Fence* m_graphicsSyncFence = nullptr; // Signaled on Unity's queue, waited on by the compute queue
+	UINT64 m_graphicsSyncValue = 0;
+	D3D12CommandRing m_stateRing;               // Empty graphics lists carrying resource states to Unity
+	UINT64 m_computeSubmitted = 0;              // Last compute fence value submitted
+	UINT64 m_computeSynced = 0;                 // Last compute fence value the graphics queue waits on
+	int m_computeFrameSlot = -1;
+
+	// Released integrations and command rings, destroyed once the GPU has passed their last submission
+	D3D12RetireFenceSource m_retireFences;
+	NRDRetireQueue m_retireQueue;
+
+	// Persistently mapped upload buffer for the plugin passes' per-dispatch constants, shared by every
+	// slot and reclaimed per submission. NRD's constants stay in its integration layer's buffers. Created on first use; grown buffers whose previous contents the
+	// open submission still reads wait in m_uploadOrphans until it is submitted.
+	ID3D12Resource* m_uploadBuffer = nullptr;
+	uint8_t* m_uploadMapped = nullptr;
+	NRDUploadRing m_uploadRing;
+	std::vector<ID3D12Resource*> m_uploadOrphans;
+
+	// Fused input-preparation and output composite dispatches (NRDSetPrepareSources,
+	// NRDSetCompositeTarget) and the reduced-resolution resample passes, created on first use.
+	// Each owns its descriptor heap; NRD's dispatches use the integration's own pools.
+	D3D12PreparePass m_preparePass;
+	D3D12CompositePass m_compositePass;
+	D3D12DownsamplePass m_downsamplePass;
+	D3D12UpsamplePass m_upsamplePass;
+
+	// Cancelled background builds still running on their worker — destroyed once finished
+	std::vector<SlotBuild*> m_abandonedBuilds;
+
+	// Committed initializations by InitAction (written on the render thread, read from any thread)
+	std::atomic<unsigned long long> m_initActionCounts[(int)InitAction::COUNT] = {};
+
+	// Memory policy (SetMemoryPolicy) and the residency bookkeeping behind NRDGetResidencyStats.
+	// The adapter is looked up on first budget query; m_unityReservation is the value last passed
+	// to SetPhysicalVideoMemoryControlValues (0 = Unity's values untouched) and m_unityMemoryBase
+	// Unity's own values, cached before the first override and restored when it is lifted.
+	int m_idleFrames = 0;
+	bool m_evictUnderPressure = false;
+	UINT64 m_reserveBytes = 0;
+	UINT64 m_residencyFrame = 0;
+	IDXGIAdapter3* m_adapter = nullptr;
+	UINT64 m_unityReservation = 0;
+	UnityGraphicsD3D12PhysicalVideoMemoryControlValues m_unityMemoryBase = {};
+	bool m_unityMemoryBaseCached = false;
+	std::atomic<unsigned long long> m_residentBytes{0};
+	std::atomic<unsigned long long> m_suspensions{0};
+	std::atomic<unsigned long long> m_resumes{0};
+
+	// Snapshot of every initialized slot's footprint and the shared heap/ring, republished on the
+	// render thread whenever one changes and copied out by NRDGetMemoryReport on any thread
+	std::mutex m_reportMutex;
+	NRDMemoryReportEntry m_report[NRD_SLOT_COUNT] = {};
+	int m_reportCount = 0;
+	NRDMemoryFootprint m_reportShared = {};
 
 	// Ring buffer for thread-safe matrix passing (main thread → render thread)
 	FrameMatrixData m_matrixRing[MATRIX_RING_SIZE];
 	float m_viewToClipMatrixPrev[16];
 	float m_worldToViewMatrixPrev[16];
 
+	// Render-thread frame arena for NRDFrameParams blocks: the current frame and the one before it
+	// (batched work is recorded after the next frame's block may already have arrived)
+	FrameMatrixData m_paramsFrames[2] = {};
+	int m_paramsCurrent = 0;
+	int m_paramsFrameCount = 0;
+
 	// Light direction for SIGMA shadow denoisers (direction TO the light source)
 	float m_lightDirection[3] = {};
 };
@@ -163,404 +571,2431 @@ RenderAPI_D3D12::RenderAPI_D3D12()
 	, m_viewToClipMatrixPrev()
 	, m_worldToViewMatrixPrev()
 {
+	m_retireQueue.SetFenceSource(&m_retireFences);
+	m_preparePass.SetFenceSource(&m_retireFences);
+	m_compositePass.SetFenceSource(&m_retireFences);
+	m_downsamplePass.SetFenceSource(&m_retireFences);
+	m_upsamplePass.SetFenceSource(&m_retireFences);
+	m_uploadRing.SetFenceSource(&m_retireFences);
 }
 
 
-bool RenderAPI_D3D12::CreateCommandObjects(DenoiserSlot& slot)
+void RenderAPI_D3D12::WaitForFrameFence(UINT64 fenceValue, DWORD timeoutMs)
 {
-	ID3D12Device* device = s_D3D12->GetDevice();
-	HRESULT hr;
+	if (s_D3D12 == nullptr)
+		return;
 
-	hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&slot.cmdAlloc));
-	if (FAILED(hr))
-	{
-		OutputDebugStringA("Failed to CreateCommandAllocator.\n");
-		return false;
-	}
+	WaitForFence(s_D3D12->GetFrameFence(), fenceValue, timeoutMs);
+}
 
-	hr = device->CreateCommandList(kNodeMask, D3D12_COMMAND_LIST_TYPE_DIRECT, slot.cmdAlloc, nullptr, IID_PPV_ARGS(&slot.cmdList));
-	if (FAILED(hr))
-	{
-		OutputDebugStringA("Failed to CreateCommandList.\n");
-		SAFE_RELEASE(slot.cmdAlloc);
-		return false;
-	}
 
-	slot.cmdList->Close();
-	slot.cmdObjectsCreated = true;
-	return true;
+// Hand the slot's integration to the retire queue, tagged with the fence of its last submission:
+// the compute queue's fence (via the slot's ring) in async compute mode, otherwise the frame fence
+// (lastFenceValue also covers batched submissions, which don't go through the slot's ring).
+void RenderAPI_D3D12::RetireIntegration(DenoiserSlot& slot)
+{
+	if (slot.integration == nullptr)
+		return;
+
+	if (slot.onComputeQueue)
+		m_retireQueue.Retire(slot.cmdRing.GetLastFence(), slot.cmdRing.GetLastFenceValue(), DestroyRetiredIntegration, slot.integration);
+	else
+		m_retireQueue.Retire(s_D3D12->GetFrameFence(), slot.lastFenceValue, DestroyRetiredIntegration, slot.integration);
+
+	// The plugin's own textures may be read by the same submissions
+	RetireSlotTexture(slot, slot.viewZTexture);
+	RetireReducedTextures(slot);
+
+	slot.integration = nullptr;
+	slot.lastFenceValue = 0;
+	slot.memory = {};
+	PublishMemoryReport();
 }
 
 
-void RenderAPI_D3D12::SetCommonSettings()
+// Retire a plugin-owned texture of the slot behind its last submission (see RetireIntegration)
+void RenderAPI_D3D12::RetireSlotTexture(DenoiserSlot& slot, ID3D12Resource*& texture)
 {
-	// Don't zero commonSettings — it may contain matrices from SetMatrix()
-	commonSettings.isBaseColorMetalnessAvailable = true;
-	commonSettings.isMotionVectorInWorldSpace = false;
-	commonSettings.motionVectorScale[0] = 1.0f;
-	commonSettings.motionVectorScale[1] = 1.0f;
-	commonSettings.motionVectorScale[2] = 0.0f;
+	if (texture == nullptr)
+		return;
+
+	if (slot.onComputeQueue)
+		m_retireQueue.Retire(slot.cmdRing.GetLastFence(), slot.cmdRing.GetLastFenceValue(), DestroyRetiredResource, texture);
+	else
+		m_retireQueue.Retire(s_D3D12->GetFrameFence(), slot.lastFenceValue, DestroyRetiredResource, texture);
+	texture = nullptr;
 }
 
 
-void RenderAPI_D3D12::ApplyDenoiserSettings(int type, DenoiserSlot& slot)
+void RenderAPI_D3D12::RetireReducedTextures(DenoiserSlot& slot)
 {
-	const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[type];
-
-	switch (desc.settingsFamily)
-	{
-	case SettingsFamily::REBLUR:
-	{
-		nrd::ReblurSettings settings = {};
-		settings.enableAntiFirefly = false;
-		settings.hitDistanceReconstructionMode = nrd::HitDistanceReconstructionMode::AREA_3X3;
-		slot.integration.SetDenoiserSettings(0, &settings);
-		break;
-	}
-	case SettingsFamily::RELAX:
-	{
-		nrd::RelaxSettings settings = {};
-		settings.enableAntiFirefly = true;
-		settings.hitDistanceReconstructionMode = nrd::HitDistanceReconstructionMode::AREA_3X3;
-		slot.integration.SetDenoiserSettings(0, &settings);
-		break;
-	}
-	case SettingsFamily::SIGMA:
-	{
-		nrd::SigmaSettings settings = {};
-		settings.lightDirection[0] = m_lightDirection[0];
-		settings.lightDirection[1] = m_lightDirection[1];
-		settings.lightDirection[2] = m_lightDirection[2];
-		slot.integration.SetDenoiserSettings(0, &settings);
-		break;
-	}
-	case SettingsFamily::REFERENCE:
-	{
-		nrd::ReferenceSettings settings = {};
-		slot.integration.SetDenoiserSettings(0, &settings);
-		break;
-	}
-	}
+	for (int i = 0; i < MAX_GROUP_RESOURCES; i++)
+		RetireSlotTexture(slot, slot.reducedTextures[i]);
 }
 
 
-bool RenderAPI_D3D12::NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount)
+bool RenderAPI_D3D12::CreateUploadBuffer(UINT64 size)
 {
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
-	{
-		m_lastInitError = 1;
+	D3D12_HEAP_PROPERTIES heapProps = {};
+	heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+	D3D12_RESOURCE_DESC bufferDesc = {};
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Width = size;
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+	if (FAILED(s_D3D12->GetDevice()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_uploadBuffer))))
 		return false;
-	}
 
-	const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[denoiserType];
-	if (resourceCount != desc.resourceCount)
+	// Upload heaps may stay mapped for the buffer's lifetime; the CPU never reads them back
+	D3D12_RANGE readRange = {};
+	if (FAILED(m_uploadBuffer->Map(0, &readRange, (void**)&m_uploadMapped)))
 	{
-		m_lastInitError = 3;
+		SAFE_RELEASE(m_uploadBuffer);
+		m_uploadMapped = nullptr;
 		return false;
 	}
 
-	DenoiserSlot& slot = m_slots[denoiserType];
+	PublishMemoryReport();
+	return true;
+}
+
 
-	// Lazy-create command objects on first use
-	if (!slot.cmdObjectsCreated)
+// Hand the current buffer to the retire queue, once per pending submission that reads it
+void RenderAPI_D3D12::RetireUploadBuffer()
+{
+	if (m_uploadBuffer == nullptr)
+		return;
+
+	for (int i = 0; i < m_uploadRing.GetPendingSubmissionCount(); i++)
 	{
-		if (!CreateCommandObjects(slot))
-		{
-			m_lastInitError = 4;
-			return false;
-		}
-	}
+		void* fence = nullptr;
+		uint64_t fenceValue = 0;
+		m_uploadRing.GetPendingSubmission(i, &fence, &fenceValue);
 
-	// Store dimensions and resource pointers
-	slot.width = renderWidth;
-	slot.height = renderHeight;
-	for (int i = 0; i < resourceCount; i++)
-		slot.resources[i] = resources[i];
+		m_uploadBuffer->AddRef();
+		m_retireQueue.Retire(fence, fenceValue, DestroyRetiredResource, m_uploadBuffer);
+	}
 
-	// Configure denoiser
-	nrd::DenoiserDesc denoiserDesc = {};
-	denoiserDesc.identifier = 0;
-	denoiserDesc.denoiser = desc.denoiser;
+	if (m_uploadRing.HasOpenAllocations())
+		m_uploadOrphans.push_back(m_uploadBuffer);
+	else
+		m_uploadBuffer->Release();
 
-	nrd::InstanceCreationDesc instanceDesc = {};
-	instanceDesc.denoisers = &denoiserDesc;
-	instanceDesc.denoisersNum = 1;
+	m_uploadBuffer = nullptr;
+	m_uploadMapped = nullptr;
+}
 
-	nrd::IntegrationCreationDesc integrationDesc = {};
-	integrationDesc.resourceWidth = (uint16_t)renderWidth;
-	integrationDesc.resourceHeight = (uint16_t)renderHeight;
 
-	// Set up D3D12 device with queue family
-	ID3D12CommandQueue* queue = s_D3D12->GetCommandQueue();
-	nri::QueueFamilyD3D12Desc queueFamily = {};
-	queueFamily.d3d12Queues = &queue;
-	queueFamily.queueNum = 1;
-	queueFamily.queueType = nri::QueueType::GRAPHICS;
+// size bytes of constants for the next submission, aligned for a CBV. They stay valid until
+// its fence passes (every submission path calls CloseSubmission).
+bool RenderAPI_D3D12::AllocateUpload(UINT64 size, void** cpuAddress, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress)
+{
+	if (s_D3D12 == nullptr)
+		return false;
 
-	nri::DeviceCreationD3D12Desc deviceDesc = {};
-	deviceDesc.d3d12Device = s_D3D12->GetDevice();
-	deviceDesc.queueFamilies = &queueFamily;
-	deviceDesc.queueFamilyNum = 1;
-	deviceDesc.enableNRIValidation = false;
-	deviceDesc.disableD3D12EnhancedBarriers = true; // Unity uses legacy barriers
+	const UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
 
-	nrd::Result result = slot.integration.RecreateD3D12(integrationDesc, instanceDesc, deviceDesc);
-	if (result != nrd::Result::SUCCESS)
+	if (m_uploadBuffer == nullptr)
 	{
-		m_lastInitError = 5;
-		return false;
+		if (m_uploadRing.GetCapacity() == 0)
+			m_uploadRing.Reset(NRD_UPLOAD_RING_INITIAL_SIZE);
+		if (!CreateUploadBuffer(m_uploadRing.GetCapacity()))
+			return false;
 	}
-	m_lastInitError = 0;
 
-	SetCommonSettings();
-	ApplyDenoiserSettings(denoiserType, slot);
-
-	// Build output resource states for Unity
-	slot.outputStateCount = 0;
-	for (int i = 0; i < desc.resourceCount; i++)
+	UINT64 offset = m_uploadRing.Allocate(size, alignment);
+	if (offset == NRD_UPLOAD_RING_FULL)
 	{
-		if (desc.resources[i].isOutput)
-		{
-			UnityGraphicsD3D12ResourceState& state = slot.outputStates[slot.outputStateCount++];
-			state = {};
-			state.resource = (ID3D12Resource*)resources[i];
-			state.expected = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-			state.current = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-		}
+		// Outgrown: continue in a buffer twice the size, the old one lives until its readers complete
+		RetireUploadBuffer();
+		m_uploadRing.Grow(size, alignment);
+		if (!CreateUploadBuffer(m_uploadRing.GetCapacity()))
+			return false;
+
+		offset = m_uploadRing.Allocate(size, alignment);
+		if (offset == NRD_UPLOAD_RING_FULL)
+			return false;
 	}
 
+	*cpuAddress = m_uploadMapped + offset;
+	*gpuAddress = m_uploadBuffer->GetGPUVirtualAddress() + offset;
 	return true;
 }
 
 
-void RenderAPI_D3D12::NRDDenoise(int denoiserType, int frameSlot)
+// Every submission path ends here: the passes' descriptor tables and the constants allocated since
+// the previous submission are reclaimed once fence reaches fenceValue. Never called while a batch is open —
+// NRDDenoise records into the batch instead and compute slots wait for NRDSubmitBatch — so the
+// batch's allocations are never closed against another submission's fence.
+void RenderAPI_D3D12::CloseSubmission(ID3D12Fence* fence, UINT64 fenceValue)
 {
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
-		return;
+	m_preparePass.EndSubmission(fence, fenceValue);
+	m_compositePass.EndSubmission(fence, fenceValue);
+	m_downsamplePass.EndSubmission(fence, fenceValue);
+	m_upsamplePass.EndSubmission(fence, fenceValue);
+	m_uploadRing.EndSubmission(fence, fenceValue);
+
+	for (size_t i = 0; i < m_uploadOrphans.size(); i++)
+		m_retireQueue.Retire(fence, fenceValue, DestroyRetiredResource, m_uploadOrphans[i]);
+	m_uploadOrphans.clear();
+}
 
-	DenoiserSlot& slot = m_slots[denoiserType];
 
-	// Ensure the GPU has finished executing the previous command list for
-	// this slot before resetting the allocator. D3D12 forbids resetting a
-	// command allocator while the GPU is still reading from it — doing so
-	// corrupts in-flight commands and causes a device hang (TDR).
-	// IMPORTANT: we WAIT instead of skipping. Skipping causes the NRD
-	// integration's internal history to go stale, producing temporal drift
-	// (the reprojection overshoots because history is 2+ frames old).
-	if (slot.lastFenceValue > 0 && s_D3D12 != nullptr)
-	{
-		ID3D12Fence* frameFence = s_D3D12->GetFrameFence();
-		if (frameFence && frameFence->GetCompletedValue() < slot.lastFenceValue)
-		{
-			HANDLE event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
-			if (event)
-			{
-				frameFence->SetEventOnCompletion(slot.lastFenceValue, event);
-				WaitForSingleObject(event, 2000); // 2s timeout to avoid infinite hang
-				CloseHandle(event);
-			}
-		}
-	}
+void RenderAPI_D3D12::GetUploadRingStats(unsigned long long* capacity, unsigned long long* bytesUploaded, unsigned long long* highWaterMark)
+{
+	if (capacity)
+		*capacity = m_uploadRing.GetCapacity();
+	if (bytesUploaded)
+		*bytesUploaded = m_uploadRing.GetBytesAllocated();
+	if (highWaterMark)
+		*highWaterMark = m_uploadRing.GetHighWaterMark();
+}
 
-	// Apply matrices from the ring buffer for this frame's slot.
-	// This ensures we use the matrices that were set by the main thread
-	// for THIS frame, not a future frame that may have already overwritten
-	// commonSettings in a multithreaded rendering scenario.
-	const FrameMatrixData& frame = m_matrixRing[frameSlot & MATRIX_RING_MASK];
-	commonSettings.frameIndex = frame.frameIndex;
-	memcpy(commonSettings.viewToClipMatrix, frame.viewToClip, sizeof(float) * 16);
-	memcpy(commonSettings.viewToClipMatrixPrev, frame.viewToClipPrev, sizeof(float) * 16);
-	memcpy(commonSettings.worldToViewMatrix, frame.worldToView, sizeof(float) * 16);
-	memcpy(commonSettings.worldToViewMatrixPrev, frame.worldToViewPrev, sizeof(float) * 16);
 
-	// Reset and begin recording
-	slot.cmdAlloc->Reset();
-	slot.cmdList->Reset(slot.cmdAlloc, NULL);
+void RenderAPI_D3D12::GetRetireQueueStats(int* pending, unsigned long long* forcedWaits)
+{
+	if (pending)
+		*pending = m_retireQueue.GetPendingCount();
+	if (forcedWaits)
+		*forcedWaits = m_retireQueue.GetForcedWaitCount();
+}
+
 
-	// Update NRD per frame
-	slot.integration.NewFrame();
+void RenderAPI_D3D12::SetMemoryPolicy(int idleFrames, bool evictUnderPressure, unsigned long long reserveBytes)
+{
+	m_idleFrames = idleFrames;
+	m_evictUnderPressure = evictUnderPressure;
+	m_reserveBytes = reserveBytes;
+
+	// Policy off — hand Unity back its defaults
+	if (!evictUnderPressure)
+		SetUnityMemoryReservation(0);
+}
 
-	// Build resource snapshot from table
-	const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[denoiserType];
 
-	// Check if this denoiser actually provides basecolor/metalness data.
-	// Setting isBaseColorMetalnessAvailable = true when the resource isn't
-	// bound causes NRD to read uninitialised data, corrupting reprojection.
-	bool hasBCM = false;
-	for (int i = 0; i < desc.resourceCount; i++)
+// Local (video) memory usage and budget of Unity's adapter, as granted by the OS
+bool RenderAPI_D3D12::QueryVideoMemory(UINT64* usage, UINT64* budget)
+{
+	if (m_adapter == nullptr)
 	{
-		if (desc.resources[i].type == nrd::ResourceType::IN_BASECOLOR_METALNESS)
+		IDXGIFactory4* factory = nullptr;
+		if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory))))
+			return false;
+
+		HRESULT hr = factory->EnumAdapterByLuid(s_D3D12->GetDevice()->GetAdapterLuid(), IID_PPV_ARGS(&m_adapter));
+		factory->Release();
+		if (FAILED(hr))
 		{
-			hasBCM = true;
-			break;
+			m_adapter = nullptr;
+			return false;
 		}
 	}
 
-	// Make local copy of common settings with per-slot dimensions
-	nrd::CommonSettings localSettings = commonSettings;
-	localSettings.timeDeltaBetweenFrames = frame.deltaTime * 1000.0f; // NRD expects milliseconds
-	localSettings.isBaseColorMetalnessAvailable = hasBCM;
-	localSettings.resourceSize[0] = (uint16_t)slot.width;
-	localSettings.resourceSize[1] = (uint16_t)slot.height;
-	localSettings.resourceSizePrev[0] = (uint16_t)slot.width;
-	localSettings.resourceSizePrev[1] = (uint16_t)slot.height;
-	localSettings.rectSize[0] = (uint16_t)slot.width;
-	localSettings.rectSize[1] = (uint16_t)slot.height;
-	localSettings.rectSizePrev[0] = (uint16_t)slot.width;
-	localSettings.rectSizePrev[1] = (uint16_t)slot.height;
+	DXGI_QUERY_VIDEO_MEMORY_INFO info = {};
+	if (FAILED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info)))
+		return false;
 
-	slot.integration.SetCommonSettings(localSettings);
+	*usage = info.CurrentUsage;
+	*budget = info.Budget;
+	return true;
+}
 
-	// Update per-denoiser settings each frame (e.g. SIGMA lightDirection)
-	ApplyDenoiserSettings(denoiserType, slot);
 
-	nrd::ResourceSnapshot snapshot;
-	snapshot.restoreInitialState = true;
+// Unity's residency manager demotes its own resources to system memory once free video memory
+// drops below its thresholds. Adding the plugin's resident pools to Unity's reservation keeps the
+// two from evicting each other's working sets. pluginBytes = 0 restores Unity's values.
+void RenderAPI_D3D12::SetUnityMemoryReservation(UINT64 pluginBytes)
+{
+	if (s_D3D12 == nullptr || (pluginBytes == 0 && m_unityReservation == 0))
+		return;
 
-	for (int i = 0; i < desc.resourceCount; i++)
-		snapshot.SetResource(desc.resources[i].type, MakeD3D12Resource(slot.resources[i]));
+	// IUnityGraphicsD3D12 can set the control values but not read them back, so the values Unity
+	// runs with until a plugin overrides them (its documented defaults) are cached once, before
+	// the first override. Only the reservation is ever raised; both thresholds stay Unity's.
+	if (!m_unityMemoryBaseCached)
+	{
+		const UINT64 MB = 1024 * 1024;
+		m_unityMemoryBase.reservation = 64 * MB;
+		m_unityMemoryBase.systemMemoryThreshold = 64 * MB;
+		m_unityMemoryBase.residencyThreshold = 128 * MB;
+		m_unityMemoryBaseCached = true;
+	}
 
-	// Build command buffer desc
-	nri::CommandBufferD3D12Desc cmdBufferDesc = {};
-	cmdBufferDesc.d3d12CommandList = slot.cmdList;
-	cmdBufferDesc.d3d12CommandAllocator = slot.cmdAlloc;
+	UINT64 reservation = pluginBytes ? m_unityMemoryBase.reservation + pluginBytes : 0;
+	if (reservation == m_unityReservation)
+		return;
+
+	UnityGraphicsD3D12PhysicalVideoMemoryControlValues values = m_unityMemoryBase;
+	if (reservation != 0)
+		values.reservation = reservation;
+	s_D3D12->SetPhysicalVideoMemoryControlValues(&values);
+	m_unityReservation = reservation;
+}
 
-	// Denoise
-	nrd::Identifier id = 0;
-	slot.integration.DenoiseD3D12(&id, 1, cmdBufferDesc, snapshot);
 
-	slot.cmdList->Close();
-	slot.lastFenceValue = s_D3D12->ExecuteCommandList(slot.cmdList, slot.outputStateCount, slot.outputStates);
+// Drop the slot's instance but keep its layout, size and textures for ResumeSlot. The pools are
+// owned by NRDIntegration, so destroying the instance (retired against its last submission) is
+// what returns their memory.
+void RenderAPI_D3D12::SuspendSlot(int slotIndex)
+{
+	DenoiserSlot& slot = m_slots[slotIndex];
+	slot.suspended = true;
+	RetireIntegration(slot);
+	m_suspensions++;
 }
 
 
-void RenderAPI_D3D12::SetMatrix(int frameIndex, float _viewToClipMatrix[16], float _worldToViewMatrix[16], float deltaTime)
+// Rebuild a suspended slot's instance from its stored inputs on a worker, like NRDInitializeAsync,
+// so an execute never stalls on pipeline creation. The build is swapped in by the next
+// NRDPollAsyncInitialize; until then the slot's executes are skipped. History starts over.
+// A failed rebuild leaves the slot suspended (and sets the last init error) and is retried after
+// a backoff (DeferResume).
+void RenderAPI_D3D12::ResumeSlot(int slotIndex)
 {
-	// Unity passes GL.GetGPUProjectionMatrix(proj, false) — standard GPU projection
-	// without RT Y-flip. Apply the render-texture Y-flip here for D3D12 convention.
-	// In column-major layout: elements 4,5,6,7 are column 1 (the Y row values).
-	_viewToClipMatrix[4] = -_viewToClipMatrix[4];
-	_viewToClipMatrix[5] = -_viewToClipMatrix[5];
-	_viewToClipMatrix[6] = -_viewToClipMatrix[6];
-	_viewToClipMatrix[7] = -_viewToClipMatrix[7];
+	DenoiserSlot& slot = m_slots[slotIndex];
+	if (!slot.suspended || slot.pendingBuild != nullptr)
+		return;
 
-	// Write to ring buffer slot so the render thread can read the correct
-	// frame's matrices even if the main thread has already moved ahead.
-	int slot = frameIndex & MATRIX_RING_MASK;
-	FrameMatrixData& frame = m_matrixRing[slot];
+	if (s_D3D12->GetNextFrameFenceValue() < slot.resumeRetryFrame)
+		return;
 
-	frame.frameIndex = frameIndex;
-	frame.deltaTime = deltaTime;
-	for (int i = 0; i < 16; ++i)
-	{
-		frame.viewToClipPrev[i] = m_viewToClipMatrixPrev[i];
-		frame.viewToClip[i] = _viewToClipMatrix[i];
+	DenoiserGroupLayout layout = slot.layout;
+	void* resources[MAX_GROUP_RESOURCES];
+	for (int i = 0; i < layout.resourceCount; i++)
+		resources[i] = slot.resources[i];
 
-		frame.worldToViewPrev[i] = m_worldToViewMatrixPrev[i];
-		frame.worldToView[i] = _worldToViewMatrix[i];
+	SlotBuild* build = PrepareSlotBuild(slotIndex, layout, slot.width, slot.height, resources, layout.resourceCount);
+	if (build == nullptr)
+	{
+		DeferResume(slot);
+		return;
 	}
 
-	// Save current as prev for the next frame's SetMatrix call
-	memcpy(m_viewToClipMatrixPrev, _viewToClipMatrix, sizeof(float) * 16);
-	memcpy(m_worldToViewMatrixPrev, _worldToViewMatrix, sizeof(float) * 16);
+	// The instance is gone, so this is always a RECREATE
+	build->resume = true;
+	build->task = std::async(std::launch::async, RunSlotBuild, build);
+	slot.pendingBuild = build;
 }
 
 
-void RenderAPI_D3D12::SetLightDirection(float x, float y, float z)
+void RenderAPI_D3D12::DeferResume(DenoiserSlot& slot)
 {
-	m_lightDirection[0] = x;
-	m_lightDirection[1] = y;
-	m_lightDirection[2] = z;
+	int shift = slot.resumeFailures < NRD_RESUME_RETRY_MAX_SHIFT ? slot.resumeFailures : NRD_RESUME_RETRY_MAX_SHIFT;
+	slot.resumeRetryFrame = s_D3D12->GetNextFrameFenceValue() + (NRD_RESUME_RETRY_FRAMES << shift);
+	slot.resumeFailures++;
 }
 
 
-void RenderAPI_D3D12::NRDRelease(int denoiserType)
+// Once per Unity frame: publish the resident pool footprint and, with a policy set, suspend idle
+// instances and (over budget) the least recently used ones. Slots with a background build in
+// flight are left alone — the build replaces their instance anyway.
+void RenderAPI_D3D12::UpdateResidency()
 {
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	if (s_D3D12 == nullptr)
+		return;
+
+	UINT64 frame = s_D3D12->GetNextFrameFenceValue();
+	if (frame == m_residencyFrame)
 		return;
+	m_residencyFrame = frame;
 
-	DenoiserSlot& slot = m_slots[denoiserType];
+	ResidencyEntry entries[NRD_SLOT_COUNT];
+	int count = 0;
+	UINT64 residentBytes = 0;
+	for (int i = 0; i < NRD_SLOT_COUNT; i++)
+	{
+		const DenoiserSlot& slot = m_slots[i];
+		if (slot.integration == nullptr)
+			continue;
+
+		UINT64 bytes = GetFootprintTotal(slot.memory);
+		residentBytes += bytes;
+		if (slot.pendingBuild != nullptr)
+			continue;
+
+		entries[count].slot = i;
+		entries[count].lastUsedFrame = slot.lastUsedFrame;
+		entries[count].bytes = bytes;
+		count++;
+	}
 
-	// Wait for the GPU to finish executing the last NRD command list
-	// before destroying NRI/NRD resources. Without this, the GPU may
-	// still be reading from D3D12 resources that are about to be freed,
-	// causing a DEVICE_REMOVED error.
-	if (slot.lastFenceValue > 0 && s_D3D12 != nullptr)
+	if (m_idleFrames != 0 || m_evictUnderPressure)
 	{
-		ID3D12Fence* frameFence = s_D3D12->GetFrameFence();
-		if (frameFence && frameFence->GetCompletedValue() < slot.lastFenceValue)
+		UINT64 usage = 0;
+		UINT64 budget = 0;
+		if (m_evictUnderPressure && QueryVideoMemory(&usage, &budget))
+			budget = budget > m_reserveBytes ? budget - m_reserveBytes : 1; // Reserve exceeds the budget — always over
+
+		int evictions[NRD_SLOT_COUNT];
+		int evictionCount = SelectEvictions(entries, count, frame, (UINT64)m_idleFrames, usage, budget, evictions);
+		if (evictionCount > 0)
+			m_retireQueue.Collect();
+
+		for (int i = 0; i < evictionCount; i++)
 		{
-			HANDLE event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
-			if (event)
-			{
-				frameFence->SetEventOnCompletion(slot.lastFenceValue, event);
-				WaitForSingleObject(event, 5000); // 5s timeout to avoid infinite hang
-				CloseHandle(event);
-			}
+			const DenoiserSlot& slot = m_slots[evictions[i]];
+			residentBytes -= GetFootprintTotal(slot.memory);
+			SuspendSlot(evictions[i]);
 		}
-		slot.lastFenceValue = 0;
 	}
 
-	slot.integration.Destroy();
+	m_residentBytes = residentBytes;
+	if (m_evictUnderPressure)
+		SetUnityMemoryReservation(residentBytes);
 }
 
 
-void RenderAPI_D3D12::NRDReleaseAllSlots()
+void RenderAPI_D3D12::GetResidencyStats(unsigned long long* residentBytes, unsigned long long* suspensions, unsigned long long* resumes)
 {
-	if (s_D3D12 == nullptr)
-		return;
+	if (residentBytes) *residentBytes = m_residentBytes;
+	if (suspensions) *suspensions = m_suspensions;
+	if (resumes) *resumes = m_resumes;
+}
 
-	// Phase 1: Find max fence value across ALL slots, wait once
-	UINT64 maxFenceValue = 0;
-	for (int i = 0; i < NRD_DENOISER_COUNT; i++)
-		if (m_slots[i].lastFenceValue > maxFenceValue)
-			maxFenceValue = m_slots[i].lastFenceValue;
 
-	if (maxFenceValue > 0)
+void RenderAPI_D3D12::PublishMemoryReport()
+{
+	std::lock_guard<std::mutex> lock(m_reportMutex);
+
+	m_reportCount = 0;
+	for (int i = 0; i < NRD_SLOT_COUNT; i++)
 	{
-		ID3D12Fence* frameFence = s_D3D12->GetFrameFence();
-		if (frameFence && frameFence->GetCompletedValue() < maxFenceValue)
+		const DenoiserSlot& slot = m_slots[i];
+		if (slot.integration == nullptr && !slot.suspended)
+			continue;
+
+		NRDMemoryReportEntry& entry = m_report[m_reportCount++];
+		entry.slot = i;
+		entry.width = slot.width;
+		entry.height = slot.height;
+		entry.suspended = slot.suspended;
+		entry.memory = slot.memory; // Zero while suspended
+	}
+
+	m_reportShared = {};
+	m_reportShared.descriptorBytes = m_preparePass.GetHeapBytes() + m_compositePass.GetHeapBytes()
+		+ m_downsamplePass.GetHeapBytes() + m_upsamplePass.GetHeapBytes();
+	if (m_uploadBuffer != nullptr)
+		m_reportShared.uploadBytes = m_uploadRing.GetCapacity();
+}
+
+
+int RenderAPI_D3D12::GetMemoryReport(NRDMemoryReportEntry* entries, int maxEntries, NRDMemoryFootprint* shared)
+{
+	std::lock_guard<std::mutex> lock(m_reportMutex);
+
+	int count = 0;
+	for (; count < m_reportCount && count < maxEntries; count++)
+		entries[count] = m_report[count];
+
+	if (shared)
+		*shared = m_reportShared;
+
+	return count;
+}
+
+
+bool RenderAPI_D3D12::EnsureComputeQueue()
+{
+	if (m_queueManager != nullptr)
+		return true;
+
+	ID3D12Device* device = s_D3D12->GetDevice();
+	if (FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_graphicsSyncFence))))
+		return false;
+
+	if (!m_stateRing.Create(device, D3D12_COMMAND_LIST_TYPE_DIRECT))
+	{
+		SAFE_RELEASE(m_graphicsSyncFence);
+		return false;
+	}
+
+	m_queueManager = new Direct3DQueueManager(device);
+	return true;
+}
+
+
+void RenderAPI_D3D12::SetCommonSettings()
+{
+	// Don't zero commonSettings — it may contain matrices from SetMatrix()
+	commonSettings.isBaseColorMetalnessAvailable = true;
+	commonSettings.isMotionVectorInWorldSpace = false;
+	commonSettings.motionVectorScale[0] = 1.0f;
+	commonSettings.motionVectorScale[1] = 1.0f;
+	commonSettings.motionVectorScale[2] = 0.0f;
+}
+
+
+void RenderAPI_D3D12::ApplyDenoiserSettings(DenoiserSlot& slot, const float lightDirection[3])
+{
+	// Each member of the slot's layout is registered with identifier == its index in the layout
+	for (int i = 0; i < slot.layout.denoiserCount; i++)
+	{
+		const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[slot.layout.denoiserTypes[i]];
+		nrd::Identifier id = (nrd::Identifier)i;
+
+		switch (desc.settingsFamily)
+		{
+		case SettingsFamily::REBLUR:
+		{
+			nrd::ReblurSettings settings = {};
+			settings.enableAntiFirefly = false;
+			settings.hitDistanceReconstructionMode = nrd::HitDistanceReconstructionMode::AREA_3X3;
+			settings.checkerboardMode = (nrd::CheckerboardMode)slot.checkerboard;
+			slot.integration->SetDenoiserSettings(id, &settings);
+			break;
+		}
+		case SettingsFamily::RELAX:
+		{
+			nrd::RelaxSettings settings = {};
+			settings.enableAntiFirefly = true;
+			settings.hitDistanceReconstructionMode = nrd::HitDistanceReconstructionMode::AREA_3X3;
+			settings.checkerboardMode = (nrd::CheckerboardMode)slot.checkerboard;
+			slot.integration->SetDenoiserSettings(id, &settings);
+			break;
+		}
+		case SettingsFamily::SIGMA:
+		{
+			nrd::SigmaSettings settings = {};
+			settings.lightDirection[0] = lightDirection[0];
+			settings.lightDirection[1] = lightDirection[1];
+			settings.lightDirection[2] = lightDirection[2];
+			slot.integration->SetDenoiserSettings(id, &settings);
+			break;
+		}
+		case SettingsFamily::REFERENCE:
+		{
+			nrd::ReferenceSettings settings = {};
+			slot.integration->SetDenoiserSettings(id, &settings);
+			break;
+		}
+		}
+	}
+}
+
+
+bool RenderAPI_D3D12::NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	{
+		m_lastInitError = 1;
+		return false;
+	}
+
+	// A single denoiser is a group of one — its layout is its g_DenoiserTypeDescs entry
+	DenoiserGroupLayout layout;
+	BuildDenoiserGroupLayout(&denoiserType, 1, layout);
+
+	return InitializeSlot(denoiserType, layout, renderWidth, renderHeight, resources, resourceCount);
+}
+
+
+bool RenderAPI_D3D12::NRDInitializeGroup(int groupIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	if (groupIndex < 0 || groupIndex >= NRD_MAX_GROUPS)
+	{
+		m_lastInitError = 1;
+		return false;
+	}
+
+	DenoiserGroupLayout layout;
+	if (BuildDenoiserGroupLayout(denoiserTypes, denoiserCount, layout) != GroupLayoutResult::OK)
+	{
+		m_lastInitError = 7;
+		return false;
+	}
+
+	return InitializeSlot(NRD_DENOISER_COUNT + groupIndex, layout, renderWidth, renderHeight, resources, resourceCount);
+}
+
+
+// Every bound resource must be in a format its slot allows (see GetAllowedFormats) — NRD would
+// otherwise read it with the wrong layout. Records the first offender for GetFormatMismatch.
+bool RenderAPI_D3D12::ValidateResourceFormats(const DenoiserGroupLayout& layout, void** resources, int resourceCount, bool viewZIsDepth)
+{
+	nrd::NormalEncoding normalEncoding = nrd::GetLibraryDesc()->normalEncoding;
+
+	for (int i = 0; i < resourceCount; i++)
+	{
+		if (resources[i] == nullptr)
+			continue;
+
+		DXGI_FORMAT format = ResolveTypelessFormat(((ID3D12Resource*)resources[i])->GetDesc().Format);
+
+		// Device depth is only read by the prepare pass — any single-channel depth format will do
+		if (viewZIsDepth && layout.resources[i].type == nrd::ResourceType::IN_VIEWZ)
+		{
+			DXGI_FORMAT depthFormat = ResolveReadFormat(((ID3D12Resource*)resources[i])->GetDesc().Format);
+			if (depthFormat == DXGI_FORMAT_R32_FLOAT || depthFormat == DXGI_FORMAT_R24_UNORM_X8_TYPELESS
+				|| depthFormat == DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS || depthFormat == DXGI_FORMAT_R16_UNORM
+				|| depthFormat == DXGI_FORMAT_R16_FLOAT)
+				continue;
+		}
+		else if (IsFormatAllowed(layout.resources[i].type, GetNrdFormat(format), normalEncoding))
+			continue;
+
+		m_formatMismatchFormat.store((int)format);
+		m_formatMismatchIndex.store(i);
+		return false;
+	}
+
+	return true;
+}
+
+
+// Checkerboard needs a REBLUR or RELAX member and full-rate inputs for everything but the signals
+// (packed to half width, see NRDCheckerboard.h). Signal inputs narrower than the mode needs — e.g.
+// packed textures with the mode off — fail with their index and format; -1 = the slot can't use it.
+bool RenderAPI_D3D12::ValidateCheckerboardLayout(const DenoiserGroupLayout& layout, void** resources, int resourceCount, int renderWidth, int renderHeight, int mode, int divisor)
+{
+	static_assert((int)nrd::CheckerboardMode::BLACK == NRD_CHECKERBOARD_BLACK && (int)nrd::CheckerboardMode::WHITE == NRD_CHECKERBOARD_WHITE,
+		"NRDCheckerboardMode must match nrd::CheckerboardMode");
+
+	if (mode != NRD_CHECKERBOARD_OFF)
+	{
+		bool supported = false;
+		for (int i = 0; i < layout.denoiserCount; i++)
+		{
+			SettingsFamily family = g_DenoiserTypeDescs[layout.denoiserTypes[i]].settingsFamily;
+			supported |= family == SettingsFamily::REBLUR || family == SettingsFamily::RELAX;
+		}
+
+		// Reduced copies are picked per block, which would mix the two phases
+		if (!supported || divisor > 1)
+		{
+			m_formatMismatchFormat.store(0);
+			m_formatMismatchIndex.store(-1);
+			return false;
+		}
+	}
+
+	int width = GetCheckerboardInputWidth(mode, renderWidth);
+	for (int i = 0; i < resourceCount; i++)
+	{
+		if (resources[i] == nullptr || !IsCheckerboardInput(layout.resources[i].type))
+			continue;
+
+		D3D12_RESOURCE_DESC desc = ((ID3D12Resource*)resources[i])->GetDesc();
+		if (desc.Width >= (UINT64)width && desc.Height >= (UINT)renderHeight)
+			continue;
+
+		m_formatMismatchFormat.store((int)ResolveTypelessFormat(desc.Format));
+		m_formatMismatchIndex.store(i);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool RenderAPI_D3D12::SetCheckerboardMode(int slotIndex, int mode)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return false;
+
+	if (mode != NRD_CHECKERBOARD_OFF && mode != NRD_CHECKERBOARD_BLACK && mode != NRD_CHECKERBOARD_WHITE)
+		return false;
+
+	m_slots[slotIndex].checkerboardMode = mode;
+	return true;
+}
+
+
+bool RenderAPI_D3D12::GetFormatMismatch(int* resourceIndex, int* format)
+{
+	int index = m_formatMismatchIndex.load();
+	if (index < 0)
+		return false;
+
+	if (resourceIndex) *resourceIndex = index;
+	if (format) *format = m_formatMismatchFormat.load();
+	return true;
+}
+
+
+SlotBuild* RenderAPI_D3D12::PrepareSlotBuild(int slotIndex, const DenoiserGroupLayout& layout, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	// Optional slots may be null, and a trailing run of them may be left off altogether
+	if (!ValidateLayoutResources(layout, resources, resourceCount))
+	{
+		m_lastInitError = 3;
+		return nullptr;
+	}
+
+	// First NRD use loads the selected NRD binary (see NRDLibrary.h)
+	if (!EnsureNrdLibrary())
+	{
+		m_lastInitError = 5;
+		return nullptr;
+	}
+
+	if (!ValidateResourceFormats(layout, resources, resourceCount, m_slots[slotIndex].viewZMode == NRD_VIEWZ_DEVICE_DEPTH))
+	{
+		m_lastInitError = 9;
+		return nullptr;
+	}
+
+	const DenoiserSlot& slot = m_slots[slotIndex];
+	bool useCompute = slot.queueMode == NRD_QUEUE_ASYNC_COMPUTE;
+
+	// Reduced inputs are picked by view Z, so mixed resolution needs it bound
+	int divisor = slot.resolutionDivisor;
+	if (divisor > 1)
+	{
+		bool hasViewZ = false;
+		for (int i = 0; i < layout.resourceCount && i < resourceCount; i++)
+			hasViewZ |= layout.resources[i].type == nrd::ResourceType::IN_VIEWZ && resources[i] != nullptr;
+
+		if (!hasViewZ)
+		{
+			m_lastInitError = 3;
+			return nullptr;
+		}
+	}
+
+	if (!ValidateCheckerboardLayout(layout, resources, resourceCount, renderWidth, renderHeight, slot.checkerboardMode, divisor))
+	{
+		m_lastInitError = 10;
+		return nullptr;
+	}
+
+	SlotBuild* build = new SlotBuild();
+	build->slotIndex = slotIndex;
+	build->layout = layout;
+	build->width = renderWidth;
+	build->height = renderHeight;
+	build->useCompute = useCompute;
+	build->divisor = divisor;
+	build->checkerboard = slot.checkerboardMode;
+	build->viewZMode = slot.viewZMode;
+	// Optional slots left off the end of the array stay null
+	for (int i = 0; i < resourceCount; i++)
+	{
+		build->resources[i] = resources[i];
+		build->formats[i] = resources[i] ? (uint32_t)((ID3D12Resource*)resources[i])->GetDesc().Format : 0;
+	}
+
+	// Diff against the live instance — re-initializing after a RenderTexture reallocation
+	// usually only needs the new pointers, not new pools and pipelines
+	SlotInitKey requested = {};
+	requested.denoiserCount = layout.denoiserCount;
+	requested.width = renderWidth;
+	requested.height = renderHeight;
+	requested.queueMode = useCompute ? NRD_QUEUE_ASYNC_COMPUTE : NRD_QUEUE_GRAPHICS;
+	requested.resourceCount = layout.resourceCount;
+	for (int i = 0; i < layout.denoiserCount; i++)
+		requested.denoiserTypes[i] = layout.denoiserTypes[i];
+	for (int i = 0; i < layout.resourceCount; i++)
+	{
+		requested.resources[i] = build->resources[i];
+		requested.formats[i] = build->formats[i];
+	}
+
+	SlotInitKey live = {};
+	if (slot.integration)
+	{
+		live.denoiserCount = slot.layout.denoiserCount;
+		live.width = slot.width;
+		live.height = slot.height;
+		live.queueMode = slot.onComputeQueue ? NRD_QUEUE_ASYNC_COMPUTE : NRD_QUEUE_GRAPHICS;
+		live.resourceCount = slot.layout.resourceCount;
+		for (int i = 0; i < slot.layout.denoiserCount; i++)
+			live.denoiserTypes[i] = slot.layout.denoiserTypes[i];
+		for (int i = 0; i < slot.layout.resourceCount; i++)
+		{
+			live.resources[i] = slot.resources[i];
+			live.formats[i] = slot.resourceFormats[i];
+		}
+	}
+
+	build->action = ClassifyInit(slot.integration ? &live : nullptr, requested);
+
+	// A new divisor changes the instance size
+	if (slot.integration && slot.divisor != divisor)
+		build->action = InitAction::RECREATE;
+	if (build->action != InitAction::RECREATE)
+		return build;
+
+	if (useCompute && !EnsureComputeQueue())
+	{
+		m_lastInitError = 4;
+		delete build;
+		return nullptr;
+	}
+
+	if (!EnsureNriDevice())
+	{
+		m_lastInitError = 5;
+		delete build;
+		return nullptr;
+	}
+
+	// Configure denoisers — all members share one instance, so one set of
+	// permanent/transient pools, descriptor pools and pipelines
+	for (int i = 0; i < layout.denoiserCount; i++)
+	{
+		build->denoiserDescs[i].identifier = (nrd::Identifier)i;
+		build->denoiserDescs[i].denoiser = g_DenoiserTypeDescs[layout.denoiserTypes[i]].denoiser;
+	}
+
+	build->instanceDesc.denoisers = build->denoiserDescs;
+	build->instanceDesc.denoisersNum = (uint32_t)layout.denoiserCount;
+
+	nrd::IntegrationCreationDesc& integrationDesc = build->integrationDesc;
+	integrationDesc.resourceWidth = (uint16_t)((renderWidth + divisor - 1) / divisor);
+	integrationDesc.resourceHeight = (uint16_t)((renderHeight + divisor - 1) / divisor);
+	// NRD multi-buffers its per-frame constants and descriptors by this count; it must cover
+	// every command list of the slot's ring that can still be in flight.
+	integrationDesc.queuedFrameNum = (uint8_t)NRD_FRAMES_IN_FLIGHT;
+	// Destruction goes through the retire queue, which waits on the exact fence value —
+	// a queue-wide wait-for-idle in Destroy() would stall on unrelated later work.
+	integrationDesc.autoWaitForIdle = false;
+
+	build->nriDevice = m_nriDevice;
+	build->upstream = m_upstream;
+	build->descriptorSize = s_D3D12->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	return build;
+}
+
+
+// Creates the NRD pipelines and pool textures on the shared NRI device. Touches nothing but the
+// build, so it runs on the render thread (NRDInitialize) or on a worker (NRDInitializeAsync).
+static void RunSlotBuild(SlotBuild* build)
+{
+	PluginIntegration* integration = new PluginIntegration(build->upstream);
+	build->instanceDesc.allocationCallbacks.Allocate = NRDAllocator::AllocateCallback;
+	build->instanceDesc.allocationCallbacks.Reallocate = NRDAllocator::ReallocateCallback;
+	build->instanceDesc.allocationCallbacks.Free = NRDAllocator::FreeCallback;
+	build->instanceDesc.allocationCallbacks.userArg = &integration->allocator;
+
+	build->integration = integration;
+	build->result = build->integration->Recreate(build->integrationDesc, build->instanceDesc, build->nriDevice);
+	if (build->result != nrd::Result::SUCCESS)
+	{
+		// Never submitted — safe to destroy right away
+		DestroyRetiredIntegration(build->integration);
+		build->integration = nullptr;
+		return;
+	}
+
+	EstimateInstanceMemory(build->instanceDesc, build->integrationDesc.resourceWidth, build->integrationDesc.resourceHeight,
+		build->integrationDesc.queuedFrameNum, build->descriptorSize, build->memory);
+}
+
+
+static void DestroySlotBuild(SlotBuild* build)
+{
+	if (build->task.valid())
+		build->task.wait();
+
+	if (build->integration)
+		DestroyRetiredIntegration(build->integration);
+
+	delete build;
+}
+
+
+// Swap a finished build into its slot (render thread, between frames). The previous instance
+// is retired; it keeps running until this point, so the slot never goes dark.
+bool RenderAPI_D3D12::CommitSlotBuild(SlotBuild* build)
+{
+	DenoiserSlot& slot = m_slots[build->slotIndex];
+	m_retireQueue.Collect();
+
+	// A failure still to be reported was about the request this one replaces
+	slot.dispatchError = 0;
+
+	if (build->action != InitAction::RECREATE)
+	{
+		// Same instance — at most the texture pointers change, effective from the next dispatch
+		if (build->action == InitAction::REBIND)
+		{
+			for (int i = 0; i < build->layout.resourceCount; i++)
+			{
+				slot.resources[i] = build->resources[i];
+				slot.resourceFormats[i] = build->formats[i];
+			}
+
+			// Reduced copies follow the new formats — recreated by the next dispatch
+			RetireReducedTextures(slot);
+		}
+
+		// A settings-only change — NRD picks it up with the next dispatch's settings, and the
+		// prepare pass with its next bindings. The reduced view Z copy follows the view Z source.
+		bool viewZIsDepth = build->viewZMode == NRD_VIEWZ_DEVICE_DEPTH;
+		if (build->action == InitAction::NO_OP && viewZIsDepth != slot.viewZIsDepth)
+			RetireReducedTextures(slot);
+		slot.checkerboard = build->checkerboard;
+		slot.viewZIsDepth = viewZIsDepth;
+		BuildOutputStates(slot);
+
+		m_initActionCounts[(int)build->action]++;
+		DestroySlotBuild(build);
+		m_lastInitError = 0;
+		return true;
+	}
+
+	if (build->integration == nullptr)
+	{
+		m_lastInitError = 5;
+		DestroySlotBuild(build);
+		return false;
+	}
+
+	// Any previous instance is retired, not destroyed — the GPU may still be executing it
+	RetireIntegration(slot);
+
+	// Switching queues needs command lists of the other type — retire the old ring
+	D3D12_COMMAND_LIST_TYPE listType = build->useCompute ? D3D12_COMMAND_LIST_TYPE_COMPUTE : D3D12_COMMAND_LIST_TYPE_DIRECT;
+	if (slot.cmdRing.IsCreated() && slot.cmdRing.GetType() != listType)
+	{
+		D3D12CommandRing* retired = new D3D12CommandRing();
+		retired->Swap(slot.cmdRing);
+		m_retireQueue.Retire(retired->GetLastFence(), retired->GetLastFenceValue(), DestroyRetiredCommandRing, retired);
+	}
+
+	// Lazy-create command objects on first use
+	if (!slot.cmdRing.IsCreated())
+	{
+		if (!slot.cmdRing.Create(s_D3D12->GetDevice(), listType))
+		{
+			m_lastInitError = 4;
+			DestroySlotBuild(build);
+			return false;
+		}
+	}
+
+	// Store layout, dimensions and resource pointers
+	slot.layout = build->layout;
+	slot.width = build->width;
+	slot.height = build->height;
+	slot.divisor = build->divisor;
+	slot.checkerboard = build->checkerboard;
+	slot.viewZIsDepth = build->viewZMode == NRD_VIEWZ_DEVICE_DEPTH;
+	for (int i = 0; i < build->layout.resourceCount; i++)
+	{
+		slot.resources[i] = build->resources[i];
+		slot.resourceFormats[i] = build->formats[i];
+	}
+
+	slot.integration = build->integration;
+	slot.onComputeQueue = build->useCompute;
+	slot.suspended = false;
+	slot.resumeFailures = 0;
+	slot.resumeRetryFrame = 0;
+	slot.lastUsedFrame = s_D3D12->GetNextFrameFenceValue(); // A new instance counts as used — not idle before its first dispatch
+	slot.memory = build->memory;
+	PublishMemoryReport();
+	slot.prevRectWidth = 0; // New instance has no history
+	slot.prevRectHeight = 0;
+	build->integration = nullptr;
+	DestroySlotBuild(build);
+	m_lastInitError = 0;
+
+	m_initActionCounts[(int)InitAction::RECREATE]++;
+
+	SetCommonSettings();
+	ApplyDenoiserSettings(slot, m_lightDirection);
+	BuildOutputStates(slot);
+
+	return true;
+}
+
+
+// Add a resource state for Unity, once per resource (passes may share textures)
+static void AddSlotState(DenoiserSlot& slot, ID3D12Resource* resource, D3D12_RESOURCE_STATES state)
+{
+	if (resource == nullptr)
+		return;
+
+	for (int i = 0; i < slot.outputStateCount; i++)
+	{
+		if (slot.outputStates[i].resource == resource)
+			return;
+	}
+
+	UnityGraphicsD3D12ResourceState& entry = slot.outputStates[slot.outputStateCount++];
+	entry = {};
+	entry.resource = resource;
+	entry.expected = state;
+	entry.current = state;
+}
+
+
+// Output resource states handed to Unity with every submission
+void RenderAPI_D3D12::BuildOutputStates(DenoiserSlot& slot)
+{
+	slot.outputStateCount = 0;
+	for (int i = 0; i < slot.layout.resourceCount; i++)
+	{
+		if (slot.layout.resources[i].isOutput)
+			AddSlotState(slot, (ID3D12Resource*)slot.resources[i], D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	}
+
+	// The prepare pass reads its sources and writes inputs in the same submission
+	if (slot.prepareEnabled || slot.viewZIsDepth)
+	{
+		ID3D12Resource* sources[NRD_PREPARE_SOURCE_COUNT];
+		ID3D12Resource* targets[NRD_PREPARE_TARGET_COUNT];
+		GetPrepareBindings(slot, sources, targets);
+		for (int i = 0; i < NRD_PREPARE_SOURCE_COUNT; i++)
+			AddSlotState(slot, sources[i], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+		// The plugin's own view Z texture stays in UAV state and is never handed to Unity
+		for (int i = 0; i < NRD_PREPARE_TARGET_COUNT; i++)
+		{
+			if (targets[i] != slot.viewZTexture)
+				AddSlotState(slot, targets[i], D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		}
+	}
+
+	// The composite pass reads G-buffer/base textures and writes its target. NRD's outputs are
+	// transitioned inside the command list and end up in UAV state again.
+	if (slot.compositeTarget != nullptr)
+	{
+		ID3D12Resource* inputs[NRD_COMPOSITE_INPUT_COUNT];
+		GetCompositeBindings(slot, inputs);
+		for (int i = NRD_COMPOSITE_OUTPUT_INPUT_COUNT; i < NRD_COMPOSITE_INPUT_COUNT; i++)
+			AddSlotState(slot, inputs[i], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+		AddSlotState(slot, (ID3D12Resource*)slot.compositeTarget, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	}
+}
+
+
+void RenderAPI_D3D12::GetInitCounters(unsigned long long* recreates, unsigned long long* rebinds, unsigned long long* noOps)
+{
+	if (recreates)
+		*recreates = m_initActionCounts[(int)InitAction::RECREATE].load();
+	if (rebinds)
+		*rebinds = m_initActionCounts[(int)InitAction::REBIND].load();
+	if (noOps)
+		*noOps = m_initActionCounts[(int)InitAction::NO_OP].load();
+}
+
+
+// Drop a slot's in-flight background build (superseded by a newer init, or the slot was released).
+// A worker can't be interrupted, so a still-running build is parked until it finishes.
+void RenderAPI_D3D12::CancelPendingBuild(DenoiserSlot& slot)
+{
+	SlotBuild* build = slot.pendingBuild;
+	if (build == nullptr)
+		return;
+
+	slot.pendingBuild = nullptr;
+	if (build->task.valid() && build->task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		m_abandonedBuilds.push_back(build);
+	else
+		DestroySlotBuild(build);
+}
+
+
+void RenderAPI_D3D12::CollectAbandonedBuilds()
+{
+	size_t write = 0;
+	for (size_t i = 0; i < m_abandonedBuilds.size(); i++)
+	{
+		SlotBuild* build = m_abandonedBuilds[i];
+		if (build->task.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			DestroySlotBuild(build);
+		else
+			m_abandonedBuilds[write++] = build;
+	}
+	m_abandonedBuilds.resize(write);
+}
+
+
+bool RenderAPI_D3D12::InitializeSlot(int slotIndex, const DenoiserGroupLayout& layout, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	// A synchronous init supersedes any background build of the same slot
+	CancelPendingBuild(m_slots[slotIndex]);
+
+	SlotBuild* build = PrepareSlotBuild(slotIndex, layout, renderWidth, renderHeight, resources, resourceCount);
+	if (build == nullptr)
+		return false;
+
+	if (build->action == InitAction::RECREATE)
+		RunSlotBuild(build);
+
+	return CommitSlotBuild(build);
+}
+
+
+bool RenderAPI_D3D12::NRDInitializeAsync(int slotIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount, unsigned long long ticket)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+	{
+		m_lastInitError = 1;
+		return false;
+	}
+
+	DenoiserGroupLayout layout;
+	if (BuildDenoiserGroupLayout(denoiserTypes, denoiserCount, layout) != GroupLayoutResult::OK)
+	{
+		m_lastInitError = slotIndex < NRD_DENOISER_COUNT ? 1 : 7;
+		return false;
+	}
+
+	DenoiserSlot& slot = m_slots[slotIndex];
+	CancelPendingBuild(slot);
+
+	SlotBuild* build = PrepareSlotBuild(slotIndex, layout, renderWidth, renderHeight, resources, resourceCount);
+	if (build == nullptr)
+		return false;
+
+	// One worker per build — several slots initialized together create their pipelines in parallel.
+	// Rebinds/no-ops have nothing to build and are committed at the next poll.
+	build->ticket = ticket;
+	if (build->action == InitAction::RECREATE)
+		build->task = std::async(std::launch::async, RunSlotBuild, build);
+	slot.pendingBuild = build;
+	return true;
+}
+
+
+int RenderAPI_D3D12::NRDPollAsyncInitialize(NRDAsyncInitResult* results, int maxResults)
+{
+	CollectAbandonedBuilds();
+
+	int count = 0;
+	for (int i = 0; i < NRD_SLOT_COUNT && count < maxResults; i++)
+	{
+		SlotBuild* build = m_slots[i].pendingBuild;
+		if (build == nullptr)
+			continue;
+		if (build->task.valid() && build->task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			continue;
+
+		m_slots[i].pendingBuild = nullptr;
+
+		// A resumed slot never stopped being initialized, so there is nothing to report
+		if (build->resume)
+		{
+			if (CommitSlotBuild(build))
+				m_resumes++;
+			else
+				DeferResume(m_slots[i]);
+			continue;
+		}
+
+		NRDAsyncInitResult& result = results[count++];
+		result.slot = i;
+		result.ticket = build->ticket;
+		result.succeeded = CommitSlotBuild(build);
+		result.error = m_lastInitError;
+	}
+
+	return count;
+}
+
+
+int RenderAPI_D3D12::NRDPollDispatchFailures(NRDDispatchFailure* failures, int maxFailures)
+{
+	int count = 0;
+	for (int i = 0; i < NRD_SLOT_COUNT && count < maxFailures; i++)
+	{
+		if (m_slots[i].dispatchError == 0)
+			continue;
+
+		failures[count].slot = i;
+		failures[count].error = m_slots[i].dispatchError;
+		count++;
+		m_slots[i].dispatchError = 0;
+	}
+
+	return count;
+}
+
+
+void RenderAPI_D3D12::NRDDenoise(int slotIndex, int frameSlot)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return;
+
+	// A submission of its own would close the pass tables and constants the open batch is still allocating
+	if (m_batchOpen)
+	{
+		NRDRecord(slotIndex, frameSlot);
+		return;
+	}
+
+	DenoiserSlot& slot = m_slots[slotIndex];
+	if (ResolveFrame(frameSlot) == nullptr)
+		return;
+
+	// A suspended slot is rebuilt in the background and skipped until it is swapped in
+	if (slot.integration == nullptr)
+	{
+		ResumeSlot(slotIndex);
+		return;
+	}
+
+	if (!PrepareDispatch(slot))
+		return;
+
+	m_retireQueue.Collect();
+
+	if (slot.onComputeQueue)
+	{
+		DenoiseOnComputeQueue(slotIndex, frameSlot);
+		return;
+	}
+
+	// Take the next allocator/list pair from the slot's ring. The ring only waits when
+	// the GPU still holds that pair, i.e. it is NRD_FRAMES_IN_FLIGHT submissions behind.
+	// IMPORTANT: we WAIT instead of skipping. Skipping causes the NRD
+	// integration's internal history to go stale, producing temporal drift
+	// (the reprojection overshoots because history is 2+ frames old).
+	ID3D12GraphicsCommandList* cmdList = slot.cmdRing.Begin();
+	if (cmdList == nullptr)
+		return;
+
+	RecordDenoise(slotIndex, frameSlot, cmdList, slot.cmdRing.GetCurrentAllocator());
+
+	cmdList->Close();
+	slot.lastFenceValue = s_D3D12->ExecuteCommandList(cmdList, slot.outputStateCount, slot.outputStates);
+	slot.cmdRing.SetSubmitted(s_D3D12->GetFrameFence(), slot.lastFenceValue);
+	CloseSubmission(s_D3D12->GetFrameFence(), slot.lastFenceValue);
+}
+
+
+// Async compute submission:
+//   graphics: [Unity work][state list][signal S] ...Unity work overlapping NRD... [wait C] (NRDSyncAsyncCompute)
+//   compute:                                    [wait S][NRD dispatches][signal C]
+// The state list is an empty graphics list submitted through Unity so that Unity transitions the
+// slot's outputs to UNORDERED_ACCESS before S, exactly as in graphics mode.
+void RenderAPI_D3D12::DenoiseOnComputeQueue(int slotIndex, int frameSlot)
+{
+	DenoiserSlot& slot = m_slots[slotIndex];
+	Direct3DQueue* computeQueue = m_queueManager->GetComputeQueue();
+	ID3D12CommandQueue* graphicsQueue = s_D3D12->GetCommandQueue();
+
+	// Compute work from an earlier frame that was never synced: make the graphics queue wait
+	// now, before this frame's inputs are handed over, so it can't overwrite inputs still being read.
+	if (m_computeSubmitted > m_computeSynced && m_computeFrameSlot != frameSlot)
+		NRDSyncAsyncCompute();
+
+	ID3D12GraphicsCommandList* stateList = m_stateRing.Begin();
+	ID3D12GraphicsCommandList* cmdList = slot.cmdRing.Begin();
+	if (stateList == nullptr || cmdList == nullptr)
+		return;
+
+	stateList->Close();
+	UINT64 frameFenceValue = s_D3D12->ExecuteCommandList(stateList, slot.outputStateCount, slot.outputStates);
+	m_stateRing.SetSubmitted(s_D3D12->GetFrameFence(), frameFenceValue);
+
+	// Inputs: the compute queue waits GPU-side for the graphics work issued before this event
+	graphicsQueue->Signal(m_graphicsSyncFence, ++m_graphicsSyncValue);
+	computeQueue->GetCommandQueue()->Wait(m_graphicsSyncFence, m_graphicsSyncValue);
+
+	RecordDenoise(slotIndex, frameSlot, cmdList, slot.cmdRing.GetCurrentAllocator());
+
+	// Direct3DQueue::ExecuteCommandList closes the list and signals the queue's fence
+	UINT64 computeFenceValue = computeQueue->ExecuteCommandList(cmdList);
+	slot.cmdRing.SetSubmitted(computeQueue->GetFence(), computeFenceValue);
+	CloseSubmission(computeQueue->GetFence(), computeFenceValue);
+
+	m_computeSubmitted = computeFenceValue;
+	m_computeFrameSlot = frameSlot;
+}
+
+
+void RenderAPI_D3D12::NRDSyncAsyncCompute()
+{
+	if (m_queueManager == nullptr || m_computeSubmitted <= m_computeSynced)
+		return;
+
+	// Outputs: graphics work issued after this point waits GPU-side for the compute fence
+	Direct3DQueue* computeQueue = m_queueManager->GetComputeQueue();
+	s_D3D12->GetCommandQueue()->Wait(computeQueue->GetFence(), m_computeSubmitted);
+	m_computeSynced = m_computeSubmitted;
+}
+
+
+bool RenderAPI_D3D12::SetQueueMode(int slotIndex, int queueMode)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return false;
+
+	if (queueMode != NRD_QUEUE_GRAPHICS && queueMode != NRD_QUEUE_ASYNC_COMPUTE)
+		return false;
+
+	m_slots[slotIndex].queueMode = queueMode;
+	return true;
+}
+
+
+void RenderAPI_D3D12::RecordDenoise(int slotIndex, int frameSlot, ID3D12GraphicsCommandList* cmdList, ID3D12CommandAllocator* cmdAlloc)
+{
+	DenoiserSlot& slot = m_slots[slotIndex];
+	slot.lastUsedFrame = s_D3D12->GetNextFrameFenceValue();
+
+	// Apply matrices from the ring buffer (or frame arena) for this frame's slot.
+	// This ensures we use the matrices that were set by the main thread
+	// for THIS frame, not a future frame that may have already overwritten
+	// commonSettings in a multithreaded rendering scenario.
+	// NRDDenoise / NRDRecord have checked that the frame resolves
+	const FrameMatrixData& frame = *ResolveFrame(frameSlot);
+	commonSettings.frameIndex = frame.frameIndex;
+	memcpy(commonSettings.viewToClipMatrix, frame.viewToClip, sizeof(float) * 16);
+	memcpy(commonSettings.viewToClipMatrixPrev, frame.viewToClipPrev, sizeof(float) * 16);
+	memcpy(commonSettings.worldToViewMatrix, frame.worldToView, sizeof(float) * 16);
+	memcpy(commonSettings.worldToViewMatrixPrev, frame.worldToViewPrev, sizeof(float) * 16);
+
+	// Update NRD per frame
+	slot.integration->NewFrame();
+
+	// Build resource snapshot from the slot's (possibly merged) layout
+	const DenoiserGroupLayout& layout = slot.layout;
+
+	// Check which optional inputs are actually bound. Setting an is*Available flag when the
+	// resource isn't bound makes NRD read uninitialised data (for basecolor/metalness this
+	// corrupts reprojection).
+	bool hasBCM = false;
+	bool hasConfidence = false;
+	bool hasThresholdMix = false;
+	for (int i = 0; i < layout.resourceCount; i++)
+	{
+		if (slot.resources[i] == nullptr)
+			continue;
+
+		nrd::ResourceType type = layout.resources[i].type;
+		if (type == nrd::ResourceType::IN_BASECOLOR_METALNESS)
+			hasBCM = true;
+		else if (type == nrd::ResourceType::IN_DIFF_CONFIDENCE || type == nrd::ResourceType::IN_SPEC_CONFIDENCE)
+			hasConfidence = true;
+		else if (type == nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX)
+			hasThresholdMix = true;
+	}
+
+	// Make local copy of common settings with per-slot dimensions
+	nrd::CommonSettings localSettings = commonSettings;
+	localSettings.timeDeltaBetweenFrames = frame.deltaTime * 1000.0f; // NRD expects milliseconds
+	localSettings.isBaseColorMetalnessAvailable = hasBCM;
+	localSettings.isHistoryConfidenceAvailable = hasConfidence;
+	localSettings.isDisocclusionThresholdMixAvailable = hasThresholdMix;
+
+	// Dynamic resolution: pools stay at the slot's (maximum) size, only the active rect in the
+	// top-left corner of the resources varies. History survives scale changes because NRD
+	// reprojects between rectSizePrev and rectSize.
+	int rectWidth = slot.width;
+	int rectHeight = slot.height;
+	if (frame.rectFrameIndex == frame.frameIndex && frame.rectWidth > 0 && frame.rectHeight > 0)
+	{
+		rectWidth = frame.rectWidth < slot.width ? frame.rectWidth : slot.width;
+		rectHeight = frame.rectHeight < slot.height ? frame.rectHeight : slot.height;
+	}
+
+	// Mixed resolution: NRD sees the reduced resources and rect; everything else stays full size
+	int divisor = slot.divisor;
+	int nrdWidth = (slot.width + divisor - 1) / divisor;
+	int nrdHeight = (slot.height + divisor - 1) / divisor;
+	int nrdRectWidth = (rectWidth + divisor - 1) / divisor;
+	int nrdRectHeight = (rectHeight + divisor - 1) / divisor;
+
+	int prevRectWidth = slot.prevRectWidth > 0 ? slot.prevRectWidth : nrdRectWidth;
+	int prevRectHeight = slot.prevRectHeight > 0 ? slot.prevRectHeight : nrdRectHeight;
+	slot.prevRectWidth = nrdRectWidth;
+	slot.prevRectHeight = nrdRectHeight;
+
+	localSettings.resourceSize[0] = (uint16_t)nrdWidth;
+	localSettings.resourceSize[1] = (uint16_t)nrdHeight;
+	localSettings.resourceSizePrev[0] = (uint16_t)nrdWidth;
+	localSettings.resourceSizePrev[1] = (uint16_t)nrdHeight;
+	localSettings.rectSize[0] = (uint16_t)nrdRectWidth;
+	localSettings.rectSize[1] = (uint16_t)nrdRectHeight;
+	localSettings.rectSizePrev[0] = (uint16_t)prevRectWidth;
+	localSettings.rectSizePrev[1] = (uint16_t)prevRectHeight;
+
+	if (frame.overrideMask & NRD_FRAME_OVERRIDE_ACCUMULATION_MODE)
+		localSettings.accumulationMode = (nrd::AccumulationMode)frame.accumulationMode;
+	if (frame.overrideMask & NRD_FRAME_OVERRIDE_DENOISING_RANGE)
+		localSettings.denoisingRange = frame.denoisingRange;
+	if (frame.overrideMask & NRD_FRAME_OVERRIDE_DISOCCLUSION_THRESHOLD)
+		localSettings.disocclusionThreshold = frame.disocclusionThreshold;
+	if (frame.overrideMask & NRD_FRAME_OVERRIDE_SPLIT_SCREEN)
+		localSettings.splitScreen = frame.splitScreen;
+
+	// IN_MV is bound as the caller produces it (e.g. Unity's forward UV motion with scale -1)
+	localSettings.motionVectorScale[0] = slot.motionVectorScale[0];
+	localSettings.motionVectorScale[1] = slot.motionVectorScale[1];
+	// Pixel motion is in full-resolution pixels at any divisor
+	if (slot.motionVectorsInPixels)
+	{
+		localSettings.motionVectorScale[0] /= (float)rectWidth;
+		localSettings.motionVectorScale[1] /= (float)rectHeight;
+	}
+
+	slot.integration->SetCommonSettings(localSettings);
+
+	// Update per-denoiser settings each frame (e.g. SIGMA lightDirection)
+	bool frameLight = (frame.overrideMask & NRD_FRAME_OVERRIDE_LIGHT_DIRECTION) != 0;
+	ApplyDenoiserSettings(slot, frameLight ? frame.lightDirection : m_lightDirection);
+
+	// Write the slot's inputs from Unity's raw buffers first, in the same command list
+	if (slot.prepareEnabled || slot.viewZIsDepth)
+		RecordPrepare(slot, frame, rectWidth, rectHeight, cmdList);
+
+	if (divisor > 1)
+		RecordDownsample(slot, rectWidth, rectHeight, cmdList);
+
+	nrd::ResourceSnapshot snapshot;
+	snapshot.restoreInitialState = true;
+
+	for (int i = 0; i < layout.resourceCount; i++)
+	{
+		// Unbound optional input — its feature is switched off above
+		if (slot.resources[i] == nullptr)
+			continue;
+
+		// Reduced copies keep the full-resolution view format (sRGB copies are stored typeless)
+		ID3D12Resource* resource = GetDenoiseResource(slot, i);
+		nrd::Resource nrdResource = MakeD3D12Resource(divisor > 1 ? slot.reducedTextures[i] : resource);
+		nrdResource.d3d12.format = (DXGIFormat)ResolveTypelessFormat(resource->GetDesc().Format);
+		snapshot.SetResource(layout.resources[i].type, nrdResource);
+	}
+
+	// Build command buffer desc
+	nri::CommandBufferD3D12Desc cmdBufferDesc = {};
+	cmdBufferDesc.d3d12CommandList = cmdList;
+	cmdBufferDesc.d3d12CommandAllocator = cmdAlloc;
+
+	// Denoise — every member of the slot in one call, sharing the instance's transient pool
+	nrd::Identifier ids[MAX_GROUP_DENOISERS];
+	for (int i = 0; i < layout.denoiserCount; i++)
+		ids[i] = (nrd::Identifier)i;
+
+	slot.integration->DenoiseD3D12(ids, (uint32_t)layout.denoiserCount, cmdBufferDesc, snapshot);
+
+	if (divisor > 1)
+		RecordUpsample(slot, rectWidth, rectHeight, cmdList);
+
+	// Resolve and composite the outputs into the caller's target, still in the same command list
+	if (slot.compositeTarget != nullptr)
+		RecordComposite(slot, rectWidth, rectHeight, cmdList);
+}
+
+
+void RenderAPI_D3D12::SetPrepareSources(int slotIndex, void* const* sources, int sourceCount)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return;
+
+	DenoiserSlot& slot = m_slots[slotIndex];
+	int count = sources != nullptr && sourceCount > 0 ? sourceCount : 0;
+	if (count > NRD_PREPARE_SOURCE_COUNT)
+		count = NRD_PREPARE_SOURCE_COUNT;
+
+	for (int i = 0; i < NRD_PREPARE_SOURCE_COUNT; i++)
+		slot.prepareSources[i] = i < count ? sources[i] : nullptr;
+	slot.prepareEnabled = count > 0;
+
+	if (slot.integration != nullptr)
+		BuildOutputStates(slot);
+}
+
+
+void RenderAPI_D3D12::SetInputConventions(int slotIndex, float motionVectorScaleX, float motionVectorScaleY, bool motionVectorsInPixels, int viewZMode)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return;
+
+	DenoiserSlot& slot = m_slots[slotIndex];
+	slot.motionVectorScale[0] = motionVectorScaleX;
+	slot.motionVectorScale[1] = motionVectorScaleY;
+	slot.motionVectorsInPixels = motionVectorsInPixels;
+
+	// Decides which IN_VIEWZ formats the init accepts and what the prepare pass writes, so like
+	// the checkerboard mode it takes effect with the next InitializeSlot
+	slot.viewZMode = viewZMode;
+}
+
+
+// What the prepare pass reads (NRDPrepareSource order) and the slot's bound inputs it writes
+// (NRDPrepareTarget order, null = not in the layout or a source is missing). In device depth mode
+// the depth is the texture bound as IN_VIEWZ, and view Z goes to the slot's own texture. Returns
+// the NRDPrepareTarget bit mask of the non-null targets.
+int RenderAPI_D3D12::GetPrepareBindings(const DenoiserSlot& slot, ID3D12Resource** sources, ID3D12Resource** targets)
+{
+	static const nrd::ResourceType kTargetTypes[NRD_PREPARE_TARGET_COUNT] =
+	{
+		nrd::ResourceType::IN_MV,
+		nrd::ResourceType::IN_NORMAL_ROUGHNESS,
+		nrd::ResourceType::IN_BASECOLOR_METALNESS,
+		nrd::ResourceType::IN_VIEWZ,
+		nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST,
+		nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST,
+	};
+
+	bool viewZIsDepth = slot.viewZIsDepth;
+	for (int i = 0; i < NRD_PREPARE_SOURCE_COUNT; i++)
+		sources[i] = (ID3D12Resource*)slot.prepareSources[i];
+
+	if (viewZIsDepth)
+	{
+		for (int i = 0; i < slot.layout.resourceCount; i++)
+		{
+			if (slot.layout.resources[i].type == nrd::ResourceType::IN_VIEWZ && slot.resources[i] != nullptr)
+				sources[NRD_PREPARE_DEPTH] = (ID3D12Resource*)slot.resources[i];
+		}
+	}
+
+	// Sources each target is computed from (viewZ feeds the radiance targets' hit distance normalization)
+	bool hasDepth = sources[NRD_PREPARE_DEPTH] != nullptr;
+	bool available[NRD_PREPARE_TARGET_COUNT] =
+	{
+		sources[NRD_PREPARE_MOTION_VECTORS] != nullptr,
+		sources[NRD_PREPARE_GBUFFER1] != nullptr && sources[NRD_PREPARE_GBUFFER2] != nullptr,
+		sources[NRD_PREPARE_GBUFFER0] != nullptr,
+		hasDepth,
+		hasDepth && sources[NRD_PREPARE_DIFFUSE] != nullptr,
+		hasDepth && sources[NRD_PREPARE_SPECULAR] != nullptr && sources[NRD_PREPARE_GBUFFER1] != nullptr,
+	};
+
+	int mask = 0;
+	for (int t = 0; t < NRD_PREPARE_TARGET_COUNT; t++)
+	{
+		targets[t] = nullptr;
+		if (!available[t])
+			continue;
+
+		if (t == NRD_PREPARE_TARGET_VIEWZ && viewZIsDepth)
+		{
+			targets[t] = slot.viewZTexture;
+			mask |= targets[t] != nullptr ? 1 << t : 0;
+			continue;
+		}
+
+		for (int i = 0; i < slot.layout.resourceCount; i++)
+		{
+			if (slot.layout.resources[i].type == kTargetTypes[t] && slot.resources[i] != nullptr)
+			{
+				targets[t] = (ID3D12Resource*)slot.resources[i];
+				mask |= 1 << t;
+				break;
+			}
+		}
+	}
+
+	return mask;
+}
+
+
+// R32_FLOAT view Z at the slot's resource size, written by the prepare pass and read by NRD. Kept in
+// UAV state (NRD restores its initial state) and retired along with the integration.
+bool RenderAPI_D3D12::EnsureViewZTexture(DenoiserSlot& slot)
+{
+	if (slot.viewZTexture != nullptr)
+		return true;
+
+	D3D12_HEAP_PROPERTIES heapProps = {};
+	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+	D3D12_RESOURCE_DESC textureDesc = {};
+	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	textureDesc.Width = (UINT64)slot.width;
+	textureDesc.Height = (UINT)slot.height;
+	textureDesc.DepthOrArraySize = 1;
+	textureDesc.MipLevels = 1;
+	textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+	return SUCCEEDED(s_D3D12->GetDevice()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &textureDesc,
+		D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&slot.viewZTexture)));
+}
+
+
+// Creates a plugin pass on first use. Its descriptor heap counts toward the shared memory report.
+template <typename Pass>
+bool RenderAPI_D3D12::EnsurePass(Pass& pass, ID3D12Device* device)
+{
+	if (pass.IsCreated())
+		return true;
+	if (!pass.Create(device))
+		return false;
+
+	PublishMemoryReport();
+	return true;
+}
+
+
+// One dispatch writing every input the slot's sources cover. Descriptors and constants live until
+// the submission's fence passes, like NRD's own.
+void RenderAPI_D3D12::RecordPrepare(DenoiserSlot& slot, const FrameMatrixData& frame, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList)
+{
+	if (slot.viewZIsDepth && !EnsureViewZTexture(slot))
+		return;
+
+	ID3D12Resource* sources[NRD_PREPARE_SOURCE_COUNT];
+	ID3D12Resource* targets[NRD_PREPARE_TARGET_COUNT];
+	int targetMask = GetPrepareBindings(slot, sources, targets);
+	if (targetMask == 0)
+		return;
+
+	ID3D12Device* device = s_D3D12->GetDevice();
+	if (!EnsurePass(m_preparePass, device))
+		return;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuTable;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuTable;
+	void* constantsCpu = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS constantsGpu = 0;
+	if (!m_preparePass.AllocateTable(&cpuTable, &gpuTable)
+		|| !AllocateUpload(sizeof(NRDPrepareConstants), &constantsCpu, &constantsGpu))
+		return;
+
+	DXGI_FORMAT sourceFormats[NRD_PREPARE_SOURCE_COUNT] = {};
+	for (int i = 0; i < NRD_PREPARE_SOURCE_COUNT; i++)
+	{
+		if (sources[i] != nullptr)
+			sourceFormats[i] = ResolveReadFormat(sources[i]->GetDesc().Format);
+	}
+
+	DXGI_FORMAT targetFormats[NRD_PREPARE_TARGET_COUNT] = {};
+	for (int i = 0; i < NRD_PREPARE_TARGET_COUNT; i++)
+	{
+		if (targets[i] != nullptr)
+			targetFormats[i] = ResolveTypelessFormat(targets[i]->GetDesc().Format);
+	}
+
+	m_preparePass.WriteDescriptors(device, sources, sourceFormats, targets, targetFormats, cpuTable);
+
+	// REBLUR takes YCoCg radiance and hit distance normalized by its HitDistanceParameters (the
+	// defaults, as in ApplyDenoiserSettings); RELAX takes RGB and world units
+	bool reblurPacking = false;
+	for (int i = 0; i < slot.layout.denoiserCount; i++)
+	{
+		if (g_DenoiserTypeDescs[slot.layout.denoiserTypes[i]].settingsFamily == SettingsFamily::REBLUR)
+			reblurPacking = true;
+	}
+
+	nrd::HitDistanceParameters hitDistParams = nrd::ReblurSettings().hitDistanceParameters;
+
+	// Column-major viewToClip: (row, column) is element column * 4 + row
+	NRDPrepareConstants constants = {};
+	constants.depthParams[0] = frame.viewToClip[10];
+	constants.depthParams[1] = frame.viewToClip[14];
+	constants.depthParams[2] = frame.viewToClip[11];
+	constants.depthParams[3] = frame.viewToClip[15];
+	constants.hitDistParams[0] = hitDistParams.A;
+	constants.hitDistParams[1] = hitDistParams.B;
+	constants.hitDistParams[2] = hitDistParams.C;
+	constants.hitDistParams[3] = hitDistParams.D;
+	constants.rectSize[0] = (uint32_t)rectWidth;
+	constants.rectSize[1] = (uint32_t)rectHeight;
+	constants.targetMask = (uint32_t)targetMask;
+	constants.normalEncoding = (uint32_t)GetNrdNormalEncoding();
+	constants.reblurPacking = reblurPacking ? 1 : 0;
+	for (int i = 0; i < 2; i++)
+	{
+		int phase = GetCheckerboardPhase(slot.checkerboard, (uint32_t)frame.frameIndex, i == 1);
+		constants.checkerboardPhase[i] = phase < 0 ? 2 : (uint32_t)phase;
+	}
+	memcpy(constantsCpu, &constants, sizeof(constants));
+
+	m_preparePass.Record(cmdList, gpuTable, constantsGpu, (uint32_t)rectWidth, (uint32_t)rectHeight);
+}
+
+
+void RenderAPI_D3D12::SetCompositeTarget(int slotIndex, void* target, void* const* sources, int sourceCount, int options)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return;
+
+	DenoiserSlot& slot = m_slots[slotIndex];
+	slot.compositeTarget = target;
+	for (int i = 0; i < NRD_COMPOSITE_SOURCE_COUNT; i++)
+		slot.compositeSources[i] = target != nullptr && sources != nullptr && i < sourceCount ? sources[i] : nullptr;
+	slot.compositeOptions = (uint32_t)options & NRD_COMPOSITE_OPTIONS;
+
+	if (slot.integration != nullptr)
+		BuildOutputStates(slot);
+}
+
+
+// The composite pass's inputs (NRDCompositeInput order, null = not bound) and its NRDCompositeFlags.
+// G-buffer sources left null fall back to the slot's prepare sources.
+uint32_t RenderAPI_D3D12::GetCompositeBindings(const DenoiserSlot& slot, ID3D12Resource** inputs)
+{
+	for (int i = 0; i < NRD_COMPOSITE_INPUT_COUNT; i++)
+		inputs[i] = nullptr;
+
+	uint32_t flags = slot.compositeOptions;
+	for (int i = 0; i < slot.layout.resourceCount; i++)
+	{
+		ID3D12Resource* resource = (ID3D12Resource*)slot.resources[i];
+		switch (slot.layout.resources[i].type)
+		{
+		case nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST: inputs[NRD_COMPOSITE_INPUT_DIFFUSE] = resource; break;
+		case nrd::ResourceType::OUT_DIFF_SH0:              inputs[NRD_COMPOSITE_INPUT_DIFFUSE] = resource; flags |= NRD_COMPOSITE_DIFFUSE_SH; break;
+		case nrd::ResourceType::OUT_DIFF_SH1:              inputs[NRD_COMPOSITE_INPUT_DIFFUSE_SH1] = resource; break;
+		case nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST: inputs[NRD_COMPOSITE_INPUT_SPECULAR] = resource; break;
+		case nrd::ResourceType::OUT_SPEC_SH0:              inputs[NRD_COMPOSITE_INPUT_SPECULAR] = resource; flags |= NRD_COMPOSITE_SPECULAR_SH; break;
+		case nrd::ResourceType::OUT_SPEC_SH1:              inputs[NRD_COMPOSITE_INPUT_SPECULAR_SH1] = resource; break;
+		default: break;
+		}
+	}
+
+	if (inputs[NRD_COMPOSITE_INPUT_DIFFUSE] != nullptr)
+		flags |= NRD_COMPOSITE_DIFFUSE;
+	if (inputs[NRD_COMPOSITE_INPUT_SPECULAR] != nullptr)
+		flags |= NRD_COMPOSITE_SPECULAR;
+
+	// REBLUR's radiance outputs are YCoCg, like its inputs
+	for (int i = 0; i < slot.layout.denoiserCount; i++)
+	{
+		if (g_DenoiserTypeDescs[slot.layout.denoiserTypes[i]].settingsFamily == SettingsFamily::REBLUR)
+			flags |= NRD_COMPOSITE_YCOCG;
+	}
+
+	static const int kPrepareFallback[NRD_COMPOSITE_SOURCE_COUNT] = { NRD_PREPARE_GBUFFER0, NRD_PREPARE_GBUFFER1, NRD_PREPARE_GBUFFER2, -1 };
+	for (int i = 0; i < NRD_COMPOSITE_SOURCE_COUNT; i++)
+	{
+		void* source = slot.compositeSources[i];
+		if (source == nullptr && kPrepareFallback[i] >= 0)
+			source = slot.prepareSources[kPrepareFallback[i]];
+		inputs[NRD_COMPOSITE_INPUT_ALBEDO + i] = (ID3D12Resource*)source;
+	}
+
+	if (inputs[NRD_COMPOSITE_INPUT_BASE] != nullptr)
+		flags |= NRD_COMPOSITE_ADD_BASE;
+
+	return flags;
+}
+
+
+// One dispatch resolving the slot's outputs into its composite target. NRD leaves its outputs in
+// UAV state (restoreInitialState); they are read as shader resources and switched back after.
+void RenderAPI_D3D12::RecordComposite(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList)
+{
+	ID3D12Resource* inputs[NRD_COMPOSITE_INPUT_COUNT];
+	uint32_t flags = GetCompositeBindings(slot, inputs);
+	if ((flags & (NRD_COMPOSITE_DIFFUSE | NRD_COMPOSITE_SPECULAR)) == 0)
+		return;
+
+	ID3D12Device* device = s_D3D12->GetDevice();
+	if (!EnsurePass(m_compositePass, device))
+		return;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuTable;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuTable;
+	void* constantsCpu = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS constantsGpu = 0;
+	if (!m_compositePass.AllocateTable(&cpuTable, &gpuTable)
+		|| !AllocateUpload(sizeof(NRDCompositeConstants), &constantsCpu, &constantsGpu))
+		return;
+
+	DXGI_FORMAT inputFormats[NRD_COMPOSITE_INPUT_COUNT] = {};
+	for (int i = 0; i < NRD_COMPOSITE_INPUT_COUNT; i++)
+	{
+		if (inputs[i] != nullptr)
+			inputFormats[i] = ResolveReadFormat(inputs[i]->GetDesc().Format);
+	}
+
+	ID3D12Resource* target = (ID3D12Resource*)slot.compositeTarget;
+	DXGI_FORMAT targetFormat = ResolveTypelessFormat(target->GetDesc().Format);
+	m_compositePass.WriteDescriptors(device, inputs, inputFormats, &target, &targetFormat, cpuTable);
+
+	NRDCompositeConstants constants = {};
+	constants.rectSize[0] = (uint32_t)rectWidth;
+	constants.rectSize[1] = (uint32_t)rectHeight;
+	constants.flags = flags;
+	memcpy(constantsCpu, &constants, sizeof(constants));
+
+	D3D12ComputePass::TransitionForRead(cmdList, inputs, NRD_COMPOSITE_OUTPUT_INPUT_COUNT, true);
+	m_compositePass.Record(cmdList, gpuTable, constantsGpu, (uint32_t)rectWidth, (uint32_t)rectHeight);
+	D3D12ComputePass::TransitionForRead(cmdList, inputs, NRD_COMPOSITE_OUTPUT_INPUT_COUNT, false);
+}
+
+
+bool RenderAPI_D3D12::SetResolutionScale(int slotIndex, int divisor)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return false;
+
+	if (divisor < 1 || divisor > NRD_RESOLUTION_DIVISOR_MAX)
+		return false;
+
+	m_slots[slotIndex].resolutionDivisor = divisor;
+	return true;
+}
+
+
+// The full-resolution texture behind a layout resource: as bound, except device depth bound as
+// IN_VIEWZ, which NRD sees through the view Z converted from it
+ID3D12Resource* RenderAPI_D3D12::GetDenoiseResource(const DenoiserSlot& slot, int resourceIndex) const
+{
+	if (slot.viewZIsDepth && slot.layout.resources[resourceIndex].type == nrd::ResourceType::IN_VIEWZ
+		&& slot.viewZTexture != nullptr)
+		return slot.viewZTexture;
+
+	return (ID3D12Resource*)slot.resources[resourceIndex];
+}
+
+
+// One reduced copy per bound resource, in its format, at the instance size. Kept in UAV state like
+// the view Z texture and retired with the integration (or on a rebind, as formats may change).
+bool RenderAPI_D3D12::EnsureReducedTextures(DenoiserSlot& slot)
+{
+	if (slot.viewZIsDepth && !EnsureViewZTexture(slot))
+		return false;
+
+	D3D12_HEAP_PROPERTIES heapProps = {};
+	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+	for (int i = 0; i < slot.layout.resourceCount; i++)
+	{
+		if (slot.resources[i] == nullptr || slot.reducedTextures[i] != nullptr)
+			continue;
+
+		DXGI_FORMAT format = ResolveTypelessFormat(GetDenoiseResource(slot, i)->GetDesc().Format);
+
+		D3D12_RESOURCE_DESC textureDesc = {};
+		textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		textureDesc.Width = (UINT64)((slot.width + slot.divisor - 1) / slot.divisor);
+		textureDesc.Height = (UINT)((slot.height + slot.divisor - 1) / slot.divisor);
+		textureDesc.DepthOrArraySize = 1;
+		textureDesc.MipLevels = 1;
+		textureDesc.Format = format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB ? DXGI_FORMAT_R8G8B8A8_TYPELESS : format;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+		if (FAILED(s_D3D12->GetDevice()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &textureDesc,
+			D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&slot.reducedTextures[i]))))
+			return false;
+	}
+
+	return true;
+}
+
+
+// Resources a dispatch needs beyond the instance, checked before anything is recorded or submitted.
+// Mixed resolution binds reduced copies of the slot's textures, created on the first dispatch after
+// a commit or rebind. If they can't be created the slot is skipped and error 11 is reported through
+// NRDPollDispatchFailures.
+bool RenderAPI_D3D12::PrepareDispatch(DenoiserSlot& slot)
+{
+	if (slot.divisor <= 1 || EnsureReducedTextures(slot))
+		return true;
+
+	slot.dispatchError = 11;
+	return false;
+}
+
+
+// Fill the reduced inputs from the full-resolution ones, NRD_RESAMPLE_BATCH textures per dispatch.
+// The full-resolution inputs are read as shader resources and switched back to UAV after.
+void RenderAPI_D3D12::RecordDownsample(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList)
+{
+	ID3D12Resource* viewZ = nullptr;
+	ID3D12Resource* inputs[MAX_GROUP_RESOURCES];
+	ID3D12Resource* copies[MAX_GROUP_RESOURCES];
+	int inputCount = 0;
+	for (int i = 0; i < slot.layout.resourceCount; i++)
+	{
+		if (slot.resources[i] == nullptr || slot.layout.resources[i].isOutput)
+			continue;
+
+		inputs[inputCount] = GetDenoiseResource(slot, i);
+		copies[inputCount++] = slot.reducedTextures[i];
+		if (slot.layout.resources[i].type == nrd::ResourceType::IN_VIEWZ)
+			viewZ = GetDenoiseResource(slot, i);
+	}
+
+	ID3D12Device* device = s_D3D12->GetDevice();
+	if (viewZ == nullptr || !EnsurePass(m_downsamplePass, device))
+		return;
+
+	D3D12ComputePass::TransitionForRead(cmdList, inputs, inputCount, true);
+
+	for (int first = 0; first < inputCount; first += NRD_RESAMPLE_BATCH)
+	{
+		int count = inputCount - first < NRD_RESAMPLE_BATCH ? inputCount - first : NRD_RESAMPLE_BATCH;
+
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuTable;
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuTable;
+		void* constantsCpu = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS constantsGpu = 0;
+		if (!m_downsamplePass.AllocateTable(&cpuTable, &gpuTable)
+			|| !AllocateUpload(sizeof(NRDResampleConstants), &constantsCpu, &constantsGpu))
+			break;
+
+		ID3D12Resource* srvs[NRD_DOWNSAMPLE_SRV_COUNT] = { viewZ };
+		DXGI_FORMAT srvFormats[NRD_DOWNSAMPLE_SRV_COUNT] = { ResolveCopyFormat(viewZ->GetDesc().Format) };
+		ID3D12Resource* uavs[NRD_RESAMPLE_BATCH] = {};
+		DXGI_FORMAT uavFormats[NRD_RESAMPLE_BATCH] = {};
+		for (int i = 0; i < count; i++)
+		{
+			srvs[1 + i] = inputs[first + i];
+			srvFormats[1 + i] = ResolveCopyFormat(inputs[first + i]->GetDesc().Format);
+			uavs[i] = copies[first + i];
+			uavFormats[i] = ResolveCopyFormat(copies[first + i]->GetDesc().Format);
+		}
+		m_downsamplePass.WriteDescriptors(device, srvs, srvFormats, uavs, uavFormats, cpuTable);
+
+		NRDResampleConstants constants = {};
+		constants.rectSize[0] = (uint32_t)rectWidth;
+		constants.rectSize[1] = (uint32_t)rectHeight;
+		constants.lowRectSize[0] = (uint32_t)((rectWidth + slot.divisor - 1) / slot.divisor);
+		constants.lowRectSize[1] = (uint32_t)((rectHeight + slot.divisor - 1) / slot.divisor);
+		constants.divisor = (uint32_t)slot.divisor;
+		constants.count = (uint32_t)count;
+		memcpy(constantsCpu, &constants, sizeof(constants));
+
+		m_downsamplePass.Record(cmdList, gpuTable, constantsGpu, constants.lowRectSize[0], constants.lowRectSize[1]);
+	}
+
+	D3D12ComputePass::TransitionForRead(cmdList, inputs, inputCount, false);
+}
+
+
+// Bring NRD's reduced outputs back to the slot's outputs over the full rect, guided by the full and
+// reduced view Z and normals. Guides and reduced outputs are read as shader resources meanwhile.
+void RenderAPI_D3D12::RecordUpsample(DenoiserSlot& slot, int rectWidth, int rectHeight, ID3D12GraphicsCommandList* cmdList)
+{
+	ID3D12Resource* guides[NRD_UPSAMPLE_GUIDE_COUNT] = {};
+	ID3D12Resource* outputs[MAX_GROUP_RESOURCES];
+	ID3D12Resource* reducedOutputs[MAX_GROUP_RESOURCES];
+	int outputCount = 0;
+	for (int i = 0; i < slot.layout.resourceCount; i++)
+	{
+		if (slot.resources[i] == nullptr)
+			continue;
+
+		nrd::ResourceType type = slot.layout.resources[i].type;
+		if (slot.layout.resources[i].isOutput)
+		{
+			outputs[outputCount] = (ID3D12Resource*)slot.resources[i];
+			reducedOutputs[outputCount++] = slot.reducedTextures[i];
+		}
+		else if (type == nrd::ResourceType::IN_VIEWZ)
+		{
+			guides[NRD_UPSAMPLE_GUIDE_VIEWZ] = GetDenoiseResource(slot, i);
+			guides[NRD_UPSAMPLE_GUIDE_LOW_VIEWZ] = slot.reducedTextures[i];
+		}
+		else if (type == nrd::ResourceType::IN_NORMAL_ROUGHNESS)
+		{
+			guides[NRD_UPSAMPLE_GUIDE_NORMAL] = (ID3D12Resource*)slot.resources[i];
+			guides[NRD_UPSAMPLE_GUIDE_LOW_NORMAL] = slot.reducedTextures[i];
+		}
+	}
+
+	ID3D12Device* device = s_D3D12->GetDevice();
+	if (outputCount == 0 || guides[NRD_UPSAMPLE_GUIDE_VIEWZ] == nullptr || !EnsurePass(m_upsamplePass, device))
+		return;
+
+	D3D12ComputePass::TransitionForRead(cmdList, guides, NRD_UPSAMPLE_GUIDE_COUNT, true);
+	D3D12ComputePass::TransitionForRead(cmdList, reducedOutputs, outputCount, true);
+
+	for (int first = 0; first < outputCount; first += NRD_RESAMPLE_BATCH)
+	{
+		int count = outputCount - first < NRD_RESAMPLE_BATCH ? outputCount - first : NRD_RESAMPLE_BATCH;
+
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuTable;
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuTable;
+		void* constantsCpu = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS constantsGpu = 0;
+		if (!m_upsamplePass.AllocateTable(&cpuTable, &gpuTable)
+			|| !AllocateUpload(sizeof(NRDResampleConstants), &constantsCpu, &constantsGpu))
+			break;
+
+		ID3D12Resource* srvs[NRD_UPSAMPLE_SRV_COUNT] = {};
+		DXGI_FORMAT srvFormats[NRD_UPSAMPLE_SRV_COUNT] = {};
+		ID3D12Resource* uavs[NRD_RESAMPLE_BATCH] = {};
+		DXGI_FORMAT uavFormats[NRD_RESAMPLE_BATCH] = {};
+		for (int i = 0; i < NRD_UPSAMPLE_GUIDE_COUNT; i++)
+			srvs[i] = guides[i];
+		for (int i = 0; i < count; i++)
+		{
+			srvs[NRD_UPSAMPLE_GUIDE_COUNT + i] = reducedOutputs[first + i];
+			uavs[i] = outputs[first + i];
+			uavFormats[i] = ResolveCopyFormat(outputs[first + i]->GetDesc().Format);
+		}
+		for (int i = 0; i < NRD_UPSAMPLE_SRV_COUNT; i++)
+		{
+			if (srvs[i] != nullptr)
+				srvFormats[i] = ResolveCopyFormat(srvs[i]->GetDesc().Format);
+		}
+		m_upsamplePass.WriteDescriptors(device, srvs, srvFormats, uavs, uavFormats, cpuTable);
+
+		NRDResampleConstants constants = {};
+		constants.rectSize[0] = (uint32_t)rectWidth;
+		constants.rectSize[1] = (uint32_t)rectHeight;
+		constants.lowRectSize[0] = (uint32_t)((rectWidth + slot.divisor - 1) / slot.divisor);
+		constants.lowRectSize[1] = (uint32_t)((rectHeight + slot.divisor - 1) / slot.divisor);
+		constants.divisor = (uint32_t)slot.divisor;
+		constants.count = (uint32_t)count;
+		constants.normalEncoding = (uint32_t)GetNrdNormalEncoding();
+		constants.hasNormal = guides[NRD_UPSAMPLE_GUIDE_NORMAL] != nullptr ? 1 : 0;
+		memcpy(constantsCpu, &constants, sizeof(constants));
+
+		m_upsamplePass.Record(cmdList, gpuTable, constantsGpu, (uint32_t)rectWidth, (uint32_t)rectHeight);
+	}
+
+	D3D12ComputePass::TransitionForRead(cmdList, reducedOutputs, outputCount, false);
+	D3D12ComputePass::TransitionForRead(cmdList, guides, NRD_UPSAMPLE_GUIDE_COUNT, false);
+}
+
+
+void RenderAPI_D3D12::NRDBeginBatch()
+{
+	if (m_batchOpen || s_D3D12 == nullptr)
+		return;
+
+	m_retireQueue.Collect();
+
+	if (!m_batchRing.IsCreated() && !m_batchRing.Create(s_D3D12->GetDevice(), D3D12_COMMAND_LIST_TYPE_DIRECT))
+		return;
+
+	// The batch list is shared by every denoiser in the batch, so one ring entry covers them all
+	if (m_batchRing.Begin() == nullptr)
+		return;
+
+	m_batchSlotCount = 0;
+	m_batchStateCount = 0;
+	m_batchComputeCount = 0;
+	m_batchOpen = true;
+}
+
+
+void RenderAPI_D3D12::NRDRecord(int slotIndex, int frameSlot)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT || ResolveFrame(frameSlot) == nullptr)
+		return;
+
+	if (m_slots[slotIndex].integration == nullptr)
+	{
+		ResumeSlot(slotIndex);
+		return;
+	}
+
+	if (!PrepareDispatch(m_slots[slotIndex]))
+		return;
+
+	// No open batch (e.g. batch command objects could not be created) — execute immediately
+	if (!m_batchOpen)
+	{
+		NRDDenoise(slotIndex, frameSlot);
+		return;
+	}
+
+	// Async compute slots submit on their own queue (the batch list is a graphics list) once the
+	// batch has been submitted
+	if (m_slots[slotIndex].onComputeQueue)
+	{
+		m_batchComputeSlots[m_batchComputeCount] = slotIndex;
+		m_batchComputeFrameSlots[m_batchComputeCount] = frameSlot;
+		m_batchComputeCount++;
+		return;
+	}
+
+	RecordDenoise(slotIndex, frameSlot, m_batchRing.GetCurrentList(), m_batchRing.GetCurrentAllocator());
+	m_batchSlots[m_batchSlotCount++] = slotIndex;
+
+	// Merge this slot's output states into the batch's state array. Several denoisers may write
+	// the same texture (e.g. a shared output), so Unity must only see each resource once.
+	const DenoiserSlot& slot = m_slots[slotIndex];
+	for (int i = 0; i < slot.outputStateCount; i++)
+	{
+		bool duplicate = false;
+		for (int j = 0; j < m_batchStateCount; j++)
 		{
-			HANDLE event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
-			if (event)
+			if (m_batchStates[j].resource == slot.outputStates[i].resource)
 			{
-				frameFence->SetEventOnCompletion(maxFenceValue, event);
-				WaitForSingleObject(event, 5000);
-				CloseHandle(event);
+				duplicate = true;
+				break;
 			}
 		}
+
+		if (!duplicate)
+			m_batchStates[m_batchStateCount++] = slot.outputStates[i];
+	}
+}
+
+
+void RenderAPI_D3D12::NRDSubmitBatch()
+{
+	if (!m_batchOpen)
+		return;
+
+	ID3D12GraphicsCommandList* cmdList = m_batchRing.GetCurrentList();
+	cmdList->Close();
+	m_batchOpen = false;
+
+	if (m_batchSlotCount > 0)
+	{
+		UINT64 fenceValue = s_D3D12->ExecuteCommandList(cmdList, m_batchStateCount, m_batchStates);
+		m_batchRing.SetSubmitted(s_D3D12->GetFrameFence(), fenceValue);
+		CloseSubmission(s_D3D12->GetFrameFence(), fenceValue);
+
+		// Release paths wait on the slot's fence before destroying its integration
+		for (int i = 0; i < m_batchSlotCount; i++)
+			m_slots[m_batchSlots[i]].lastFenceValue = fenceValue;
+	}
+
+	// Each closes its own submission; the compute queue also waits for the batch just submitted
+	for (int i = 0; i < m_batchComputeCount; i++)
+		NRDDenoise(m_batchComputeSlots[i], m_batchComputeFrameSlots[i]);
+	m_batchComputeCount = 0;
+}
+
+
+void RenderAPI_D3D12::SetMatrix(int frameIndex, float _viewToClipMatrix[16], float _worldToViewMatrix[16], float deltaTime)
+{
+	FlipViewToClipY(_viewToClipMatrix);
+
+	// Write to ring buffer slot so the render thread can read the correct
+	// frame's matrices even if the main thread has already moved ahead.
+	int slot = frameIndex & MATRIX_RING_MASK;
+	FrameMatrixData& frame = m_matrixRing[slot];
+
+	frame.frameIndex = frameIndex;
+	frame.deltaTime = deltaTime;
+	for (int i = 0; i < 16; ++i)
+	{
+		frame.viewToClipPrev[i] = m_viewToClipMatrixPrev[i];
+		frame.viewToClip[i] = _viewToClipMatrix[i];
+
+		frame.worldToViewPrev[i] = m_worldToViewMatrixPrev[i];
+		frame.worldToView[i] = _worldToViewMatrix[i];
+	}
+
+	// Save current as prev for the next frame's SetMatrix call
+	memcpy(m_viewToClipMatrixPrev, _viewToClipMatrix, sizeof(float) * 16);
+	memcpy(m_worldToViewMatrixPrev, _worldToViewMatrix, sizeof(float) * 16);
+}
+
+
+void RenderAPI_D3D12::SetRenderRect(int frameIndex, int width, int height)
+{
+	FrameMatrixData& frame = m_matrixRing[frameIndex & MATRIX_RING_MASK];
+	frame.rectWidth = width;
+	frame.rectHeight = height;
+	frame.rectFrameIndex = frameIndex;
+}
+
+
+void RenderAPI_D3D12::SetFrameParams(const NRDFrameParams& params)
+{
+	// Several events (one per slot) usually carry the same frame's block; only a new frame index
+	// advances the arena. Render thread only, so the arena needs no synchronization.
+	if (m_paramsFrameCount == 0 || m_paramsFrames[m_paramsCurrent].frameIndex != params.frameIndex)
+	{
+		m_paramsCurrent ^= 1;
+		m_paramsFrameCount++;
 	}
 
-	// Phase 2: GPU is idle — destroy all integrations
-	for (int i = 0; i < NRD_DENOISER_COUNT; i++)
+	FrameMatrixData& frame = m_paramsFrames[m_paramsCurrent];
+	const FrameMatrixData& previous = m_paramsFrames[m_paramsCurrent ^ 1];
+
+	frame.frameIndex = params.frameIndex;
+	frame.deltaTime = params.deltaTime;
+	memcpy(frame.viewToClip, params.viewToClip, sizeof(float) * 16);
+	memcpy(frame.worldToView, params.worldToView, sizeof(float) * 16);
+	FlipViewToClipY(frame.viewToClip);
+
+	// The first frame reprojects onto itself
+	bool hasPrevious = m_paramsFrameCount > 1;
+	memcpy(frame.viewToClipPrev, hasPrevious ? previous.viewToClip : frame.viewToClip, sizeof(float) * 16);
+	memcpy(frame.worldToViewPrev, hasPrevious ? previous.worldToView : frame.worldToView, sizeof(float) * 16);
+
+	frame.rectFrameIndex = params.frameIndex;
+	frame.rectWidth = params.rectWidth;
+	frame.rectHeight = params.rectHeight;
+
+	frame.overrideMask = params.overrideMask;
+	if (params.accumulationMode >= (uint32_t)nrd::AccumulationMode::MAX_NUM)
+		frame.overrideMask &= ~(uint32_t)NRD_FRAME_OVERRIDE_ACCUMULATION_MODE;
+
+	memcpy(frame.lightDirection, params.lightDirection, sizeof(float) * 3);
+	frame.accumulationMode = params.accumulationMode;
+	frame.denoisingRange = params.denoisingRange;
+	frame.disocclusionThreshold = params.disocclusionThreshold;
+	frame.splitScreen = params.splitScreen;
+}
+
+
+// Null if the slot names a frame the arena no longer (or never) held — the work is dropped rather
+// than denoised with another frame's matrices
+const FrameMatrixData* RenderAPI_D3D12::ResolveFrame(int frameSlot) const
+{
+	if ((frameSlot & NRD_FRAME_PARAMS_SLOT_BIT) == 0)
+		return &m_matrixRing[frameSlot & MATRIX_RING_MASK];
+
+	int frameIndex = frameSlot & NRD_FRAME_PARAMS_INDEX_MASK;
+	const FrameMatrixData& current = m_paramsFrames[m_paramsCurrent];
+	if (m_paramsFrameCount > 0 && (current.frameIndex & NRD_FRAME_PARAMS_INDEX_MASK) == frameIndex)
+		return &current;
+
+	// A batch flushed by the next frame's first event still refers to the previous arena entry
+	const FrameMatrixData& previous = m_paramsFrames[m_paramsCurrent ^ 1];
+	if (m_paramsFrameCount > 1 && (previous.frameIndex & NRD_FRAME_PARAMS_INDEX_MASK) == frameIndex)
+		return &previous;
+
+	return nullptr;
+}
+
+
+void RenderAPI_D3D12::SetLightDirection(float x, float y, float z)
+{
+	m_lightDirection[0] = x;
+	m_lightDirection[1] = y;
+	m_lightDirection[2] = z;
+}
+
+
+void RenderAPI_D3D12::NRDRelease(int slotIndex)
+{
+	if (slotIndex < 0 || slotIndex >= NRD_SLOT_COUNT)
+		return;
+
+	// The GPU may still be reading NRI/NRD resources from the last submission (destroying
+	// them now would cause DEVICE_REMOVED), so the instance is retired instead of waited on.
+	// It is destroyed by a later Collect once the GPU has passed that submission.
+	m_retireQueue.Collect();
+	CancelPendingBuild(m_slots[slotIndex]);
+	m_slots[slotIndex].suspended = false;
+	m_slots[slotIndex].resumeFailures = 0;
+	m_slots[slotIndex].resumeRetryFrame = 0;
+	m_slots[slotIndex].dispatchError = 0;
+	m_slots[slotIndex].prepareEnabled = false;
+	memset(m_slots[slotIndex].prepareSources, 0, sizeof(m_slots[slotIndex].prepareSources));
+	m_slots[slotIndex].compositeTarget = nullptr;
+	memset(m_slots[slotIndex].compositeSources, 0, sizeof(m_slots[slotIndex].compositeSources));
+	RetireIntegration(m_slots[slotIndex]);
+}
+
+
+void RenderAPI_D3D12::NRDReleaseAllSlots()
+{
+	if (s_D3D12 == nullptr)
+		return;
+
+	m_retireQueue.Collect();
+	for (int i = 0; i < NRD_SLOT_COUNT; i++)
 	{
-		m_slots[i].lastFenceValue = 0;
-		m_slots[i].integration.Destroy();
+		CancelPendingBuild(m_slots[i]);
+		m_slots[i].suspended = false;
+		m_slots[i].resumeFailures = 0;
+		m_slots[i].resumeRetryFrame = 0;
+		m_slots[i].dispatchError = 0;
+		m_slots[i].prepareEnabled = false;
+		memset(m_slots[i].prepareSources, 0, sizeof(m_slots[i].prepareSources));
+		m_slots[i].compositeTarget = nullptr;
+		memset(m_slots[i].compositeSources, 0, sizeof(m_slots[i].compositeSources));
+		RetireIntegration(m_slots[i]);
 	}
 }
 
 
 void RenderAPI_D3D12::ReleaseResources()
 {
+	// Device shutdown — force the retire queue to drain, blocking until the GPU is done
 	NRDReleaseAllSlots();
-	for (int i = 0; i < NRD_DENOISER_COUNT; i++)
+	m_retireQueue.Drain();
+
+	// Workers still building use the device — wait for them before it goes away
+	for (size_t i = 0; i < m_abandonedBuilds.size(); i++)
+		DestroySlotBuild(m_abandonedBuilds[i]);
+	m_abandonedBuilds.clear();
+
+	// Every integration is destroyed by now
+	DestroyNriDevice();
+
+	for (int i = 0; i < NRD_SLOT_COUNT; i++)
+	{
+		DenoiserSlot& slot = m_slots[i];
+		WaitForFence(slot.cmdRing.GetLastFence(), slot.cmdRing.GetLastFenceValue(), 5000);
+		slot.cmdRing.Release();
+		slot.onComputeQueue = false;
+	}
+
+	WaitForFrameFence(m_batchRing.GetLastFenceValue(), 5000);
+	m_batchOpen = false;
+	m_batchComputeCount = 0;
+	m_batchRing.Release();
+
+	// Every submission that could reference the heap has been waited on above
+	m_preparePass.Release();
+	m_compositePass.Release();
+	m_downsamplePass.Release();
+	m_upsamplePass.Release();
+	SAFE_RELEASE(m_uploadBuffer);
+	m_uploadMapped = nullptr;
+	m_uploadRing.Reset(0);
+	for (size_t i = 0; i < m_uploadOrphans.size(); i++)
+		m_uploadOrphans[i]->Release();
+	m_uploadOrphans.clear();
+
+	SAFE_RELEASE(m_adapter);
+	m_residencyFrame = 0;
+	m_unityReservation = 0;
+	m_residentBytes = 0;
+	PublishMemoryReport();
+
+	if (m_queueManager)
+	{
+		WaitForFrameFence(m_stateRing.GetLastFenceValue(), 5000);
+		m_stateRing.Release();
+
+		m_queueManager->WaitForAllIdle();
+		delete m_queueManager;
+		m_queueManager = nullptr;
+		SAFE_RELEASE(m_graphicsSyncFence);
+		m_graphicsSyncValue = 0;
+		m_computeSubmitted = 0;
+		m_computeSynced = 0;
+		m_computeFrameSlot = -1;
+	}
+}
+
+
+bool RenderAPI_D3D12::EnsureNriDevice()
+{
+	if (m_nriDevice != nullptr)
+		return true;
+
+	if (s_D3D12 == nullptr)
+		return false;
+
+	// Unity's queue is the only queue family. NRD never submits (autoWaitForIdle is off): it
+	// records into command lists we wrap per dispatch, and the wrapper takes the list type from
+	// the list itself — so async compute slots record through the same device.
+	m_nriQueue = s_D3D12->GetCommandQueue();
+	m_nriQueueFamily.d3d12Queues = &m_nriQueue;
+	m_nriQueueFamily.queueNum = 1;
+	m_nriQueueFamily.queueType = nri::QueueType::GRAPHICS;
+
+	nri::DeviceCreationD3D12Desc deviceDesc = {};
+	deviceDesc.d3d12Device = s_D3D12->GetDevice();
+	deviceDesc.queueFamilies = &m_nriQueueFamily;
+	deviceDesc.queueFamilyNum = 1;
+	deviceDesc.enableNRIValidation = false;
+	deviceDesc.disableD3D12EnhancedBarriers = true; // Unity uses legacy barriers
+	deviceDesc.allocationCallbacks.Allocate = NRDAllocator::AllocateCallback;
+	deviceDesc.allocationCallbacks.Reallocate = NRDAllocator::ReallocateCallback;
+	deviceDesc.allocationCallbacks.Free = NRDAllocator::FreeCallback;
+	deviceDesc.allocationCallbacks.userArg = &m_deviceAllocator;
+
+	if (nri::nriCreateDeviceFromD3D12Device(deviceDesc, m_nriDevice) != nri::Result::SUCCESS)
+	{
+		m_nriDevice = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+
+void RenderAPI_D3D12::DestroyNriDevice()
+{
+	if (m_nriDevice == nullptr)
+		return;
+
+	nri::nriDestroyDevice(m_nriDevice);
+	m_nriDevice = nullptr;
+	m_nriQueue = nullptr;
+}
+
+
+#if NRD_USE_UNITY_MEMORY_MANAGER
+struct UnityUpstreamArg
+{
+	IUnityMemoryManager* manager;
+	UnityAllocator* allocator;
+};
+
+static UnityUpstreamArg s_unityUpstreamArg;
+
+static void* UnityUpstreamAllocate(void* userArg, size_t size, size_t alignment)
+{
+	UnityUpstreamArg* arg = (UnityUpstreamArg*)userArg;
+	return arg->manager->Allocate(arg->allocator, size, alignment, __FILE__, __LINE__);
+}
+
+static void UnityUpstreamFree(void* userArg, void* memory)
+{
+	UnityUpstreamArg* arg = (UnityUpstreamArg*)userArg;
+	arg->manager->Deallocate(arg->allocator, memory, __FILE__, __LINE__);
+}
+#endif
+
+
+// Nothing is allocated yet at device initialize, so the device allocator can still switch upstream
+void RenderAPI_D3D12::CreateUnityAllocator(IUnityInterfaces* interfaces)
+{
+#if NRD_USE_UNITY_MEMORY_MANAGER
+	if (m_unityAllocator != nullptr)
+		return;
+
+	m_unityMemory = interfaces->Get<IUnityMemoryManager>();
+	if (m_unityMemory == nullptr)
+		return;
+
+	m_unityAllocator = m_unityMemory->CreateAllocator("NKLIDenoising", "NRD");
+	if (m_unityAllocator == nullptr)
+		return;
+
+	s_unityUpstreamArg.manager = m_unityMemory;
+	s_unityUpstreamArg.allocator = m_unityAllocator;
+	m_unityUpstream.allocate = UnityUpstreamAllocate;
+	m_unityUpstream.free = UnityUpstreamFree;
+	m_unityUpstream.userArg = &s_unityUpstreamArg;
+
+	if (m_deviceAllocator.SetUpstream(&m_unityUpstream))
+		m_upstream = &m_unityUpstream;
+#else
+	(void)interfaces;
+#endif
+}
+
+
+// After ReleaseResources — every integration (and its allocator) and the NRI device are gone
+void RenderAPI_D3D12::DestroyUnityAllocator()
+{
+	m_deviceAllocator.Trim();
+	m_deviceAllocator.SetUpstream(nullptr);
+	m_upstream = nullptr;
+
+	if (m_unityAllocator != nullptr)
 	{
-		SAFE_RELEASE(m_slots[i].cmdList);
-		SAFE_RELEASE(m_slots[i].cmdAlloc);
-		m_slots[i].cmdObjectsCreated = false;
+		m_unityMemory->DestroyAllocator(m_unityAllocator);
+		m_unityAllocator = nullptr;
 	}
 }
 
 
+unsigned long long RenderAPI_D3D12::GetCommandRingStallCount()
+{
+	UINT64 stalls = m_batchRing.GetStallCount() + m_stateRing.GetStallCount();
+	for (int i = 0; i < NRD_SLOT_COUNT; i++)
+		stalls += m_slots[i].cmdRing.GetStallCount();
+
+	return stalls;
+}
+
+
 void RenderAPI_D3D12::ProcessDeviceEvent(UnityGfxDeviceEventType type, IUnityInterfaces* interfaces)
 {
 	switch (type)
 	{
 	case kUnityGfxDeviceEventInitialize:
 		s_D3D12 = interfaces->Get<IUnityGraphicsD3D12v4>();
+		CreateUnityAllocator(interfaces);
+		// Failure is retried by the first initialization, which reports it as error 5
+		EnsureNriDevice();
 		break;
 	case kUnityGfxDeviceEventShutdown:
 		ReleaseResources();
+		DestroyUnityAllocator();
 		break;
 	}
 }
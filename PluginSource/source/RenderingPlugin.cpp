@@ -3,10 +3,18 @@
 #include "PlatformBase.h"
 #include "RenderAPI.h"
 #include "NRDDenoiserConfig.h"
+#include "NRDFrameBatcher.h"
+#include "NRDCommandChannel.h"
+#include "NRDFrameParams.h"
+#include "NRDAllocator.h"
+#include "NRDLibrary.h"
+#include "NRDComposite.h"
+#include "NRDUpsample.h"
+#include "NRDCheckerboard.h"
 
 #include <assert.h>
 #include <math.h>
-#include <mutex>
+#include <atomic>
 #include <vector>
 
 #include "Unity/IUnityRenderingExtensions.h"
@@ -14,22 +22,51 @@
 // Gameworks — use NRI fetched by NRD's CMake to match built NRI.dll
 #include "../NRD/_Build/_deps/nri-src/Include/NRI.h"
 
-// Per-denoiser state arrays (indexed by nrd::Denoiser enum value)
-static bool g_initialized[NRD_DENOISER_COUNT] = {};
-static int g_prevWidth[NRD_DENOISER_COUNT] = {};
-static int g_prevHeight[NRD_DENOISER_COUNT] = {};
-static std::mutex g_mutex;
+// Per-slot state arrays (indexed by nrd::Denoiser enum value, then NRD_DENOISER_COUNT + groupIndex).
+// Render thread only — the main thread sees slot state through g_slotPublished.
+static bool g_initialized[NRD_SLOT_COUNT] = {};
 
-// Diagnostic: last error code from NRDInitialize
-static int g_lastInitError = 0;
+// Render-thread batch of denoisers issued with NRD_EVENT_BATCH_BIT
+static NRDFrameBatcher g_batcher;
+
+// Main thread → render thread. Exported init/release/settings functions post commands;
+// the render thread applies them at the start of the next execute event.
+static NRDCommandChannel g_commands;
+
+// Per-slot generation counters: the sequence of the latest command posted for a slot, and the
+// sequence/status the render thread published after applying it ((sequence << 8) | NRDSlotStatus).
+// The slot is pending while the two differ.
+static std::atomic<uint64_t> g_slotRequested[NRD_SLOT_COUNT];
+static std::atomic<uint64_t> g_slotPublished[NRD_SLOT_COUNT];
+
+// Render thread only: the sequence of the last command applied to each slot. A failure found while
+// dispatching is published against it, so commands posted since keep the slot pending.
+static uint64_t g_slotApplied[NRD_SLOT_COUNT] = {};
+
+enum NRDSlotStatus
+{
+	NRD_SLOT_NOT_INITIALIZED = 0,
+	NRD_SLOT_PENDING = 1,
+	NRD_SLOT_READY = 2,
+	NRD_SLOT_FAILED = 3 // see NRDGetLastError
+};
+
+// Diagnostic: last error code from NRDInitialize (set by validation on the calling thread, or by the render thread)
+static std::atomic<int> g_lastInitError(0);
 // Error codes:
 // 0 = success
 // 1 = denoiserType out of range
 // 2 = s_CurrentAPI is null (graphics not initialized)
-// 3 = resource count mismatch
+// 3 = resource count mismatch, or a required resource is null
 // 4 = CreateCommandObjects failed
-// 5 = RecreateD3D12 failed
+// 5 = NRD instance creation failed (or the shared NRI device could not be created)
 // 6 = unknown
+// 7 = invalid denoiser group (duplicate type, conflicting outputs, too many members/resources)
+// 8 = command queue full (too many init/release calls between two execute events)
+// 9 = a resource's format is not allowed for its slot (see NRDGetFormatMismatch)
+// 10 = the checkerboard mode doesn't fit the slot, or a signal input is too small for it (see NRDGetFormatMismatch)
+// 11 = the reduced-resolution copies of a scaled slot's textures could not be created (reported by the
+//      first dispatch after initialization; the slot is released)
 
 
 // --------------------------------------------------------------------------
@@ -83,6 +120,9 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API RegisterPlugin()
 static RenderAPI* s_CurrentAPI = NULL;
 static UnityGfxRenderer s_DeviceType = kUnityGfxRendererNull;
 
+static void DrainCommands();
+static void PublishSlot(int slot, uint64_t sequence, NRDSlotStatus status);
+
 
 static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType eventType)
 {
@@ -92,8 +132,13 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
 		assert(s_CurrentAPI == NULL);
 		s_DeviceType = s_Graphics->GetRenderer();
 		s_CurrentAPI = CreateRenderAPI(s_DeviceType);
+		g_batcher.SetRenderAPI(s_CurrentAPI);
 	}
 
+	// Apply commands posted since the last execute event while the device still exists
+	if (eventType == kUnityGfxDeviceEventShutdown)
+		DrainCommands();
+
 	// Let the implementation process the device related events
 	if (s_CurrentAPI)
 	{
@@ -103,44 +148,298 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
 	// Cleanup graphics API implementation upon shutdown
 	if (eventType == kUnityGfxDeviceEventShutdown)
 	{
+		g_batcher.SetRenderAPI(NULL);
 		delete s_CurrentAPI;
 		s_CurrentAPI = NULL;
 		s_DeviceType = kUnityGfxRendererNull;
 
-		for (int i = 0; i < NRD_DENOISER_COUNT; i++)
+		for (int i = 0; i < NRD_SLOT_COUNT; i++)
+		{
+			g_initialized[i] = false;
+			PublishSlot(i, g_slotRequested[i].load(std::memory_order_acquire), NRD_SLOT_NOT_INITIALIZED);
+		}
+	}
+}
+
+
+// --------------------------------------------------------------------------
+// Render thread command processing
+
+static void PublishSlot(int slot, uint64_t sequence, NRDSlotStatus status)
+{
+	g_slotPublished[slot].store((sequence << 8) | (uint64_t)status, std::memory_order_release);
+}
+
+
+static void ReleaseSlot(int slot)
+{
+	// Called even for uninitialized slots: the backend also cancels any background build
+	g_batcher.Remove(slot);
+	s_CurrentAPI->NRDRelease(slot);
+	g_initialized[slot] = false;
+}
+
+
+static void ApplyInitialize(NRDCommand& command)
+{
+	int slot = command.slot;
+
+	// The backend diffs the request against the live instance: unchanged requests are no-ops,
+	// new texture pointers are rebound, and only a new denoiser set or size recreates NRD.
+	bool initialized;
+	if (command.type == NRDCommandType::INITIALIZE_GROUP)
+		initialized = s_CurrentAPI->NRDInitializeGroup(slot - NRD_DENOISER_COUNT, command.denoiserTypes, command.denoiserCount,
+			command.renderWidth, command.renderHeight, command.resources, command.resourceCount);
+	else
+		initialized = s_CurrentAPI->NRDInitialize(slot, command.renderWidth, command.renderHeight, command.resources, command.resourceCount);
+
+	g_lastInitError.store(initialized ? 0 : s_CurrentAPI->GetLastInitError());
+	if (!initialized)
+		ReleaseSlot(slot); // Don't leave the previous instance running behind a failed request
+
+	g_initialized[slot] = initialized;
+	PublishSlot(slot, command.sequence, initialized ? NRD_SLOT_READY : NRD_SLOT_FAILED);
+}
+
+
+// The slot's current instance (if any) keeps denoising while the new one is built. The slot is
+// published by PollAsyncInitialize once the build has been swapped in.
+static void ApplyInitializeAsync(NRDCommand& command)
+{
+	int slot = command.slot;
+	if (!s_CurrentAPI->NRDInitializeAsync(slot, &slot, 1, command.renderWidth, command.renderHeight, command.resources, command.resourceCount, command.sequence))
+	{
+		g_lastInitError.store(s_CurrentAPI->GetLastInitError());
+		PublishSlot(slot, command.sequence, NRD_SLOT_FAILED);
+	}
+}
+
+
+// Frame boundary: swap in background builds that have finished
+static void PollAsyncInitialize()
+{
+	NRDAsyncInitResult results[NRD_SLOT_COUNT];
+	int count = s_CurrentAPI->NRDPollAsyncInitialize(results, NRD_SLOT_COUNT);
+
+	for (int i = 0; i < count; i++)
+	{
+		const NRDAsyncInitResult& result = results[i];
+		if (result.succeeded)
+			g_initialized[result.slot] = true;
+
+		g_lastInitError.store(result.succeeded ? 0 : result.error);
+		PublishSlot(result.slot, result.ticket, result.succeeded ? NRD_SLOT_READY : NRD_SLOT_FAILED);
+	}
+}
+
+
+// Slots a dispatch had to skip (error 11). Nothing was recorded for them; the slot is released so
+// it doesn't keep failing every frame, and reports failed until it is initialized again.
+static void PollDispatchFailures()
+{
+	NRDDispatchFailure failures[NRD_SLOT_COUNT];
+	int count = s_CurrentAPI->NRDPollDispatchFailures(failures, NRD_SLOT_COUNT);
+
+	for (int i = 0; i < count; i++)
+	{
+		ReleaseSlot(failures[i].slot);
+		g_lastInitError.store(failures[i].error);
+		PublishSlot(failures[i].slot, g_slotApplied[failures[i].slot], NRD_SLOT_FAILED);
+	}
+}
+
+
+static bool IsInitializeCommand(NRDCommandType type)
+{
+	return type == NRDCommandType::INITIALIZE || type == NRDCommandType::INITIALIZE_GROUP || type == NRDCommandType::INITIALIZE_ASYNC;
+}
+
+
+static void ApplyCommand(NRDCommand& command)
+{
+	if (s_CurrentAPI == NULL)
+	{
+		// Device went away after the command was posted
+		if (IsInitializeCommand(command.type))
+		{
+			g_lastInitError.store(2);
+			PublishSlot(command.slot, command.sequence, NRD_SLOT_FAILED);
+		}
+		return;
+	}
+
+	switch (command.type)
+	{
+	case NRDCommandType::INITIALIZE:
+	case NRDCommandType::INITIALIZE_GROUP:
+		ApplyInitialize(command);
+		break;
+	case NRDCommandType::INITIALIZE_ASYNC:
+		ApplyInitializeAsync(command);
+		break;
+	case NRDCommandType::RELEASE:
+		ReleaseSlot(command.slot);
+		PublishSlot(command.slot, command.sequence, NRD_SLOT_NOT_INITIALIZED);
+		break;
+	case NRDCommandType::RELEASE_ALL:
+		g_batcher.Clear();
+		s_CurrentAPI->NRDReleaseAllSlots();
+		for (int i = 0; i < NRD_SLOT_COUNT; i++)
 		{
 			g_initialized[i] = false;
-			g_prevWidth[i] = 0;
-			g_prevHeight[i] = 0;
+			PublishSlot(i, command.sequence, NRD_SLOT_NOT_INITIALIZED);
 		}
+		break;
+	case NRDCommandType::SET_LIGHT_DIRECTION:
+		s_CurrentAPI->SetLightDirection(command.vector[0], command.vector[1], command.vector[2]);
+		break;
+	case NRDCommandType::SET_QUEUE_MODE:
+		s_CurrentAPI->SetQueueMode(command.slot, command.value);
+		break;
+	case NRDCommandType::SET_MEMORY_POLICY:
+		s_CurrentAPI->SetMemoryPolicy(command.value, command.flag, command.bytes);
+		break;
+	case NRDCommandType::SET_PREPARE_SOURCES:
+		s_CurrentAPI->SetPrepareSources(command.slot, command.resources, command.resourceCount);
+		break;
+	case NRDCommandType::SET_INPUT_CONVENTIONS:
+		s_CurrentAPI->SetInputConventions(command.slot, command.vector[0], command.vector[1], command.flag, command.value);
+		break;
+	case NRDCommandType::SET_COMPOSITE_TARGET:
+		s_CurrentAPI->SetCompositeTarget(command.slot, command.resources[0], command.resources + 1, command.resourceCount - 1, command.value);
+		break;
+	case NRDCommandType::SET_RESOLUTION_SCALE:
+		s_CurrentAPI->SetResolutionScale(command.slot, command.value);
+		break;
+	case NRDCommandType::SET_CHECKERBOARD_MODE:
+		s_CurrentAPI->SetCheckerboardMode(command.slot, command.value);
+		break;
+	}
+}
+
+
+// Render thread only — the channel's single consumer. Commands call into Unity's render-thread
+// interfaces, and the batch records command lists.
+static void DrainCommands()
+{
+	NRDCommand command;
+	while (g_commands.TryPop(command))
+	{
+		// Batched events were issued before this command was posted — submit them against the state they saw
+		g_batcher.Flush();
+		ApplyCommand(command);
+
+		if (command.type == NRDCommandType::RELEASE_ALL)
+		{
+			for (int i = 0; i < NRD_SLOT_COUNT; i++)
+				g_slotApplied[i] = command.sequence;
+		}
+		else if (IsInitializeCommand(command.type) || command.type == NRDCommandType::RELEASE)
+			g_slotApplied[command.slot] = command.sequence;
 	}
 }
 
 
 // --------------------------------------------------------------------------
-// Generic render thread callback (try_to_lock — skip frame if init/release in progress)
+// Generic render thread callback
 //
 // Event ID encoding (set by C# via GL.IssuePluginEvent):
-//   bits 0-7:   denoiser type (nrd::Denoiser enum, 0..18)
+//   bits 0-7:   slot — denoiser type (nrd::Denoiser enum, 0..18), group slot
+//               (NRD_DENOISER_COUNT + groupIndex), NRD_EVENT_FLUSH or NRD_EVENT_SYNC_COMPUTE
 //   bits 8-9:   matrix ring buffer slot (frameCount & 3)
-//   bits 10-31: unused
+//   bit  10:    NRD_EVENT_BATCH_BIT — queue into the frame batch instead of executing immediately
+//   bits 11-31: unused
+//
+// Batched denoisers are recorded into one command list and submitted together when a
+// NRD_EVENT_FLUSH event arrives, or automatically when an event for a new frame slot arrives.
+// Unbatched events, sync events and newly posted commands submit the pending batch first.
+//
+// Slots in async compute mode (NRDSetQueueMode) run on the plugin's compute queue; issue
+// NRD_EVENT_SYNC_COMPUTE before the first graphics pass that reads their outputs.
+//
+// Pending init/release/settings commands are applied first, so an execute event issued after
+// NRDInitialize always sees the new instance — no lock, no dropped frames.
+//
+// Events issued through the NRDGetExecuteCallbackWithData callback carry an NRDFrameParams block
+// instead of a ring slot; bits 8-9 are ignored and the block's frame index identifies the frame.
 
-static void UNITY_INTERFACE_API OnExecuteEventGeneric(int eventID)
+static const int NRD_EVENT_FLUSH = 0xFF;
+static const int NRD_EVENT_SYNC_COMPUTE = 0xFE;
+static const int NRD_EVENT_BATCH_BIT = 1 << 10;
+
+static bool IsControlEvent(int denoiserType)
+{
+	return denoiserType == NRD_EVENT_FLUSH || denoiserType == NRD_EVENT_SYNC_COMPUTE;
+}
+
+static void ExecuteEvent(int eventID, const NRDFrameParams* params)
 {
 	int denoiserType = eventID & 0xFF;
 	int frameSlot = (eventID >> 8) & MATRIX_RING_MASK;
+	bool batched = (eventID & NRD_EVENT_BATCH_BIT) != 0;
 
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	bool control = IsControlEvent(denoiserType);
+	if (!control && (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT))
+		return;
+
+	if (s_CurrentAPI == NULL)
+		return;
+
+	NRDAllocator::MarkRenderThread();
+	DrainCommands();
+	PollAsyncInitialize();
+	PollDispatchFailures();
+	s_CurrentAPI->UpdateResidency();
+
+	// Copy the caller's block into the backend's frame arena before anything is recorded
+	if (params != nullptr)
+	{
+		s_CurrentAPI->SetFrameParams(*params);
+		frameSlot = NRD_FRAME_PARAMS_SLOT_BIT | (params->frameIndex & NRD_FRAME_PARAMS_INDEX_MASK);
+	}
+
+	if (denoiserType == NRD_EVENT_FLUSH)
+	{
+		g_batcher.Flush();
 		return;
+	}
 
-	std::unique_lock<std::mutex> lock(g_mutex, std::try_to_lock);
-	if (!lock.owns_lock())
+	if (denoiserType == NRD_EVENT_SYNC_COMPUTE)
+	{
+		g_batcher.SyncAsyncCompute();
 		return;
+	}
 
-	if (s_CurrentAPI == NULL || !g_initialized[denoiserType])
+	if (!g_initialized[denoiserType])
 		return;
 
-	s_CurrentAPI->NRDDenoise(denoiserType, frameSlot);
+	if (batched)
+		g_batcher.Enqueue(denoiserType, frameSlot);
+	else
+		g_batcher.Execute(denoiserType, frameSlot);
+}
+
+static void UNITY_INTERFACE_API OnExecuteEventGeneric(int eventID)
+{
+	ExecuteEvent(eventID, nullptr);
+}
+
+static void UNITY_INTERFACE_API OnExecuteEventWithData(int eventID, void* data)
+{
+	// Blocks older than version 1 or truncated by the caller are rejected rather than read past.
+	// Newer (larger) blocks are accepted; fields this build doesn't know are ignored.
+	const NRDFrameParams* params = (const NRDFrameParams*)data;
+	bool valid = params != nullptr && params->version >= 1 && params->size >= sizeof(NRDFrameParams);
+
+	// Without a valid block only flush/sync events can run — denoising would read a stale frame
+	if (!valid)
+	{
+		if (IsControlEvent(eventID & 0xFF))
+			ExecuteEvent(eventID, nullptr);
+		return;
+	}
+
+	ExecuteEvent(eventID, params);
 }
 
 
@@ -168,62 +467,569 @@ static void UNITY_INTERFACE_API OnExecuteEventLegacyReblur(int eventID)
 
 
 // --------------------------------------------------------------------------
-// Generic external API (main thread — lock_guard blocks until render thread finishes)
+// Generic external API (any thread — posts commands to the render thread, never blocks)
 
-extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount)
+// Raise a slot's requested generation. Per-slot calls are expected from one thread at a time;
+// the max keeps the counter monotonic regardless.
+static void MarkRequested(int slot, uint64_t sequence)
 {
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	uint64_t current = g_slotRequested[slot].load(std::memory_order_relaxed);
+	while (current < sequence && !g_slotRequested[slot].compare_exchange_weak(current, sequence, std::memory_order_release, std::memory_order_relaxed))
 	{
-		g_lastInitError = 1;
+	}
+}
+
+
+// TryPush assigns the sequence in queue order, so a slot's requested and published generations
+// rise in the order the render thread applies its commands, whichever thread posted them.
+static bool PostCommand(NRDCommand& command)
+{
+	if (!g_commands.TryPush(command))
+	{
+		// Only initializations report through the init status — a dropped settings call returns false
+		if (IsInitializeCommand(command.type))
+			g_lastInitError.store(8);
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lock(g_mutex);
+	if (command.type == NRDCommandType::RELEASE_ALL)
+	{
+		for (int i = 0; i < NRD_SLOT_COUNT; i++)
+			MarkRequested(i, command.sequence);
+	}
+	else if (IsInitializeCommand(command.type) || command.type == NRDCommandType::RELEASE)
+	{
+		// Only commands that publish a slot status — settings changes must not leave it pending
+		MarkRequested(command.slot, command.sequence);
+	}
+
+	return true;
+}
+
 
+// Shared by every initialization entry point: validates what can be checked without the device
+// and copies the resources into the command
+static bool PrepareInitialize(NRDCommand& command, void** resources, int resourceCount)
+{
 	if (s_CurrentAPI == nullptr)
 	{
-		g_lastInitError = 2;
+		g_lastInitError.store(2);
+		return false;
+	}
+
+	if (resources == nullptr || resourceCount < 0 || resourceCount > MAX_GROUP_RESOURCES)
+	{
+		g_lastInitError.store(3);
+		return false;
+	}
+
+	for (int i = 0; i < resourceCount; i++)
+		command.resources[i] = resources[i];
+	command.resourceCount = resourceCount;
+	return true;
+}
+
+
+// Returns true once the command is queued — see NRDGetInitStatus for the result
+static bool PostInitialize(NRDCommand& command, void** resources, int resourceCount)
+{
+	return PrepareInitialize(command, resources, resourceCount) && PostCommand(command);
+}
+
+
+static bool MakeInitializeCommand(NRDCommand& command, NRDCommandType type, int denoiserType, int renderWidth, int renderHeight)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	{
+		g_lastInitError.store(1);
 		return false;
 	}
 
-	// Check for resize — release and re-create if dimensions changed
-	if ((renderWidth != g_prevWidth[denoiserType] || renderHeight != g_prevHeight[denoiserType]) && g_initialized[denoiserType])
+	command = {};
+	command.type = type;
+	command.slot = denoiserType;
+	command.renderWidth = renderWidth;
+	command.renderHeight = renderHeight;
+	return true;
+}
+
+
+static bool MakeInitializeGroupCommand(NRDCommand& command, int groupIndex, const int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight)
+{
+	if (groupIndex < 0 || groupIndex >= NRD_MAX_GROUPS)
 	{
-		s_CurrentAPI->NRDRelease(denoiserType);
-		g_initialized[denoiserType] = false;
+		g_lastInitError.store(1);
+		return false;
+	}
 
-		g_prevWidth[denoiserType] = renderWidth;
-		g_prevHeight[denoiserType] = renderHeight;
+	// Composition is table logic — reject it here rather than after a round trip
+	DenoiserGroupLayout layout;
+	if (denoiserTypes == nullptr || BuildDenoiserGroupLayout(denoiserTypes, denoiserCount, layout) != GroupLayoutResult::OK)
+	{
+		g_lastInitError.store(7);
+		return false;
 	}
 
-	g_initialized[denoiserType] = s_CurrentAPI->NRDInitialize(denoiserType, renderWidth, renderHeight, resources, resourceCount);
-	if (!g_initialized[denoiserType])
-		g_lastInitError = s_CurrentAPI->GetLastInitError();
-	else
-		g_lastInitError = 0;
+	command = {};
+	command.type = NRDCommandType::INITIALIZE_GROUP;
+	command.slot = NRD_DENOISER_COUNT + groupIndex;
+	command.renderWidth = renderWidth;
+	command.renderHeight = renderHeight;
+	command.denoiserCount = denoiserCount;
+	for (int i = 0; i < denoiserCount; i++)
+		command.denoiserTypes[i] = denoiserTypes[i];
+	return true;
+}
+
+
+// Never blocks: the request is posted to the render thread and applied at the start of the next
+// execute event. Returns true once queued — NRDGetInitStatus reports the result.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDInitialize(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	NRDCommand command;
+	if (!MakeInitializeCommand(command, NRDCommandType::INITIALIZE, denoiserType, renderWidth, renderHeight))
+		return false;
+
+	return PostInitialize(command, resources, resourceCount);
+}
+
+
+// Like NRDInitialize, but the NRD instance (pipelines, pool textures) is created
+// on a worker thread. The slot's current instance keeps running with its old resources until the new
+// one is swapped in at the start of an execute event; NRDGetInitStatus reports ready (2) from then on.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDInitializeAsync(int denoiserType, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	NRDCommand command;
+	if (!MakeInitializeCommand(command, NRDCommandType::INITIALIZE_ASYNC, denoiserType, renderWidth, renderHeight))
+		return false;
+
+	return PostInitialize(command, resources, resourceCount);
+}
+
+
+// Initialize several denoisers hosted by one shared NRD instance. Resources are passed in the
+// merged layout order reported by NRDGetGroupLayout. Execute with event slot NRD_DENOISER_COUNT + groupIndex.
+// Posted like NRDInitialize.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDInitializeGroup(int groupIndex, int* denoiserTypes, int denoiserCount, int renderWidth, int renderHeight, void** resources, int resourceCount)
+{
+	NRDCommand command;
+	if (!MakeInitializeGroupCommand(command, groupIndex, denoiserTypes, denoiserCount, renderWidth, renderHeight))
+		return false;
+
+	return PostInitialize(command, resources, resourceCount);
+}
+
+
+// Reports the merged resource order for a denoiser group (nrd::ResourceType values).
+// Returns the resource count, or -1 if the group composition is invalid or outResourceTypes is too small.
+// Table logic only — safe to call before the graphics device exists.
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetGroupLayout(int* denoiserTypes, int denoiserCount, int* outResourceTypes, int maxResources)
+{
+	DenoiserGroupLayout layout;
+	if (BuildDenoiserGroupLayout(denoiserTypes, denoiserCount, layout) != GroupLayoutResult::OK)
+		return -1;
+
+	if (outResourceTypes == nullptr || maxResources < layout.resourceCount)
+		return -1;
+
+	for (int i = 0; i < layout.resourceCount; i++)
+		outResourceTypes[i] = (int)layout.resources[i].type;
+
+	return layout.resourceCount;
+}
+
+
+// Slot state as last published by the render thread (NRDSlotStatus):
+// 0 = not initialized, 1 = pending (a posted command has not been applied yet), 2 = ready, 3 = failed
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetInitStatus(int denoiserType)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return NRD_SLOT_NOT_INITIALIZED;
+
+	uint64_t requested = g_slotRequested[denoiserType].load(std::memory_order_acquire);
+	uint64_t published = g_slotPublished[denoiserType].load(std::memory_order_acquire);
+
+	if ((published >> 8) < requested)
+		return NRD_SLOT_PENDING;
 
-	return g_initialized[denoiserType];
+	return (int)(published & 0xFF);
 }
 
 
 extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetLastError()
 {
-	return g_lastInitError;
+	return g_lastInitError.load();
 }
 
 
-extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDRelease(int denoiserType)
+// Detail for errors 9 and 10: index into the resource array and its DXGI_FORMAT (typeless formats
+// resolved). Returns false if no initialization has failed format validation yet, or if the last
+// error 10 was about the slot rather than a texture.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetFormatMismatch(int* resourceIndex, int* dxgiFormat)
 {
-	if (denoiserType < 0 || denoiserType >= NRD_DENOISER_COUNT)
+	if (s_CurrentAPI == nullptr)
+		return false;
+
+	return s_CurrentAPI->GetFormatMismatch(resourceIndex, dxgiFormat);
+}
+
+
+// Initializations applied since device creation, by outcome: a new NRD instance (recreate),
+// new texture pointers on the live instance (rebind), or an unchanged request (no-op)
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetInitCounters(unsigned long long* recreates, unsigned long long* rebinds, unsigned long long* noOps)
+{
+	if (s_CurrentAPI == nullptr)
+	{
+		if (recreates) *recreates = 0;
+		if (rebinds) *rebinds = 0;
+		if (noOps) *noOps = 0;
 		return;
+	}
+
+	s_CurrentAPI->GetInitCounters(recreates, rebinds, noOps);
+}
+
+
+// Constant upload ring of the plugin's own passes (not NRD's): buffer size, bytes uploaded since
+// device creation, peak use (diagnostic)
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetUploadRingStats(unsigned long long* capacity, unsigned long long* bytesUploaded, unsigned long long* highWaterMark)
+{
+	if (s_CurrentAPI == nullptr)
+	{
+		if (capacity) *capacity = 0;
+		if (bytesUploaded) *bytesUploaded = 0;
+		if (highWaterMark) *highWaterMark = 0;
+		return;
+	}
+
+	s_CurrentAPI->GetUploadRingStats(capacity, bytesUploaded, highWaterMark);
+}
+
+
+// Retire queue: released objects still waiting for the GPU, and how often a release had to block
+// because the queue was full (NRD_RETIRE_QUEUE_CAPACITY entries) since device creation (diagnostic)
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetRetireQueueStats(int* pending, unsigned long long* forcedWaits)
+{
+	if (s_CurrentAPI == nullptr)
+	{
+		if (pending) *pending = 0;
+		if (forcedWaits) *forcedWaits = 0;
+		return;
+	}
+
+	s_CurrentAPI->GetRetireQueueStats(pending, forcedWaits);
+}
+
+
+// Pool memory of the resident (not suspended) instances, and how many suspensions and resumes
+// the memory policy has performed since startup
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetResidencyStats(unsigned long long* residentBytes, unsigned long long* suspensions, unsigned long long* resumes)
+{
+	if (s_CurrentAPI == nullptr)
+	{
+		if (residentBytes) *residentBytes = 0;
+		if (suspensions) *suspensions = 0;
+		if (resumes) *resumes = 0;
+		return;
+	}
 
-	std::lock_guard<std::mutex> lock(g_mutex);
+	s_CurrentAPI->GetResidencyStats(residentBytes, suspensions, resumes);
+}
+
+
+// Choose the NRD binary by the normal encoding it was built with (nrd::NormalEncoding value;
+// -1 = the default NRD.dll). Loads NRD_enc<N>.dll from the plugin folder instead of NRD.dll.
+// Call before the first initialization or memory estimate — once NRD is loaded it can't change,
+// and the call fails unless it asks for what is loaded. Also fails if the DLL is missing.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSelectNormalEncoding(int normalEncoding)
+{
+	return SelectNrdLibrary(normalEncoding);
+}
+
+
+// NRD_NORMAL_ENCODING of the NRD binary in use (loading it if needed), for packing
+// IN_NORMAL_ROUGHNESS to match. -1 if NRD can't be loaded.
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetNormalEncoding()
+{
+	return GetNrdNormalEncoding();
+}
+
+
+// GPU memory of a denoiser group instance (see NRDEstimateMemory) — one shared instance, so
+// usually less than the sum of its members
+extern "C" unsigned long long UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDEstimateGroupMemory(const int* denoiserTypes, int denoiserCount, int width, int height, NRDMemoryFootprint* footprint)
+{
+	NRDMemoryFootprint estimate = {};
+	DenoiserGroupLayout layout;
+	bool valid = denoiserTypes != nullptr && width > 0 && height > 0 && width <= 65535 && height <= 65535
+		&& BuildDenoiserGroupLayout(denoiserTypes, denoiserCount, layout) == GroupLayoutResult::OK
+		&& EnsureNrdLibrary();
 
-	if (g_initialized[denoiserType] && s_CurrentAPI != nullptr)
+	if (valid)
+		EstimateDenoiserMemory(denoiserTypes, denoiserCount, width, height, NRD_ESTIMATE_QUEUED_FRAMES, NRD_TYPICAL_DESCRIPTOR_SIZE, estimate);
+
+	if (footprint)
+		*footprint = estimate;
+
+	return GetFootprintTotal(estimate);
+}
+
+
+// GPU memory an instance of denoiserType at width x height would use, from NRD's own pool and
+// limit descriptions. Needs no device — callable before Unity's graphics device exists, e.g. to
+// budget quality tiers. Returns the total in bytes (0 for an invalid type or size); footprint
+// (optional) receives the breakdown. Descriptor bytes assume a 32-byte descriptor.
+extern "C" unsigned long long UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDEstimateMemory(int denoiserType, int width, int height, NRDMemoryFootprint* footprint)
+{
+	return NRDEstimateGroupMemory(&denoiserType, 1, width, height, footprint);
+}
+
+
+// Memory of every initialized slot (denoiser type or 19 + groupIndex), as measured when its
+// instance was created, plus the plugin passes' descriptor heaps and upload ring in shared (optional).
+// Writes up to maxEntries entries and returns how many were written.
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetMemoryReport(NRDMemoryReportEntry* entries, int maxEntries, NRDMemoryFootprint* shared)
+{
+	if (s_CurrentAPI == nullptr || entries == nullptr || maxEntries < 0)
 	{
-		s_CurrentAPI->NRDRelease(denoiserType);
-		g_initialized[denoiserType] = false;
+		if (shared) *shared = {};
+		return 0;
 	}
+
+	return s_CurrentAPI->GetMemoryReport(entries, maxEntries, shared);
+}
+
+
+// CPU memory behind the NRD/NRI allocation callbacks: blocks requested from the upstream heap
+// (Unity's memory manager or the CRT) in total and from the render thread, and the bytes held.
+// Once every denoiser has run a few frames the render-thread count stops growing — sample it
+// twice to check that a steady-state frame allocates nothing.
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetAllocatorStats(unsigned long long* upstreamAllocations, unsigned long long* renderThreadAllocations, unsigned long long* reservedBytes)
+{
+	NRDAllocatorStats stats;
+	NRDAllocator::GetStats(stats);
+
+	if (upstreamAllocations) *upstreamAllocations = stats.upstreamAllocations;
+	if (renderThreadAllocations) *renderThreadAllocations = stats.renderThreadUpstreamAllocations;
+	if (reservedBytes) *reservedBytes = stats.reservedBytes;
+}
+
+
+// Render-thread CPU stalls on command allocator reuse since device creation (diagnostic)
+extern "C" unsigned long long UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetFenceStallCount()
+{
+	if (s_CurrentAPI == nullptr)
+		return 0;
+
+	return s_CurrentAPI->GetCommandRingStallCount();
+}
+
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDRelease(int denoiserType)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::RELEASE;
+	command.slot = denoiserType;
+	PostCommand(command);
+}
+
+
+// Select the queue a slot (denoiser type or 19 + groupIndex) runs on — NRDQueueMode:
+// 0 = Unity's graphics queue (default), 1 = async compute. Applied by the slot's next initialization.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetQueueMode(int denoiserType, int queueMode)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (queueMode != NRD_QUEUE_GRAPHICS && queueMode != NRD_QUEUE_ASYNC_COMPUTE)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_QUEUE_MODE;
+	command.slot = denoiserType;
+	command.value = queueMode;
+	return PostCommand(command);
+}
+
+
+// Fused input preparation for a slot: before each dispatch, one compute pass in the same command
+// list writes the slot's IN_MV, IN_NORMAL_ROUGHNESS, IN_BASECOLOR_METALNESS, IN_VIEWZ and
+// IN_*_RADIANCE_HITDIST from Unity's raw buffers (NRDPrepareSource order; null entries are skipped
+// along with the inputs that need them). sourceCount 0 turns it off. Cleared when the slot is released.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetPrepareSources(int denoiserType, void** sources, int sourceCount)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (sourceCount < 0 || sourceCount > NRD_PREPARE_SOURCE_COUNT || (sourceCount > 0 && sources == nullptr))
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_PREPARE_SOURCES;
+	command.slot = denoiserType;
+	for (int i = 0; i < sourceCount; i++)
+		command.resources[i] = sources[i];
+	command.resourceCount = sourceCount;
+	return PostCommand(command);
+}
+
+
+// How a slot's IN_MV and IN_VIEWZ are encoded, so Unity's buffers can be bound without a blit.
+// IN_MV is multiplied by (motionVectorScaleX, motionVectorScaleY) — and divided by the render rect
+// with motionVectorsInPixels — to get NRD's backward UV motion: Unity's _CameraMotionVectorsTexture
+// is (-1, -1), and takes effect from the next dispatch. viewZMode is an NRDViewZMode and takes
+// effect from the slot's next NRDInitialize. Kept across releases. Defaults: (1, 1), UV, NRD_VIEWZ_LINEAR.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetInputConventions(int denoiserType, float motionVectorScaleX, float motionVectorScaleY, bool motionVectorsInPixels, int viewZMode)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (viewZMode != NRD_VIEWZ_LINEAR && viewZMode != NRD_VIEWZ_DEVICE_DEPTH)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_INPUT_CONVENTIONS;
+	command.slot = denoiserType;
+	command.vector[0] = motionVectorScaleX;
+	command.vector[1] = motionVectorScaleY;
+	command.flag = motionVectorsInPixels;
+	command.value = viewZMode;
+	return PostCommand(command);
+}
+
+
+// Fused output stage for a slot: after each dispatch, one compute pass in the same command list
+// resolves SH outputs, remodulates (options & NRD_COMPOSITE_REMODULATE) and writes diffuse +
+// specular — plus the NRD_COMPOSITE_BASE texture if given — into target (UAV, alpha from the base
+// or 1). sources are NRDCompositeSource textures. A null target turns it off. Cleared when the slot
+// is released.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetCompositeTarget(int denoiserType, void* target, void** sources, int sourceCount, int options)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (sourceCount < 0 || sourceCount > NRD_COMPOSITE_SOURCE_COUNT || (sourceCount > 0 && sources == nullptr))
+		return false;
+
+	if ((options & ~(int)NRD_COMPOSITE_OPTIONS) != 0)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_COMPOSITE_TARGET;
+	command.slot = denoiserType;
+	command.resources[0] = target;
+	for (int i = 0; i < sourceCount; i++)
+		command.resources[1 + i] = sources[i];
+	command.resourceCount = 1 + sourceCount;
+	command.value = options;
+	return PostCommand(command);
+}
+
+
+// CPU reference of the composite pass for one pixel (NRDCompositeFlags, NRDComposite.h), to
+// validate read-back results. Callable from any thread.
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDEvaluateComposite(const NRDCompositeTexel* texel, unsigned int flags, float* result)
+{
+	if (texel == nullptr || result == nullptr)
+		return;
+
+	EvaluateComposite(*texel, flags, result);
+}
+
+
+// Mixed resolution for a slot: NRD runs at ceil(width / divisor) x ceil(height / divisor) on
+// plugin-owned copies. Before each dispatch every input is downsampled (nearest view Z of each
+// block); after it, the outputs are upsampled into the slot's outputs with depth/normal-aware
+// weights (NRDUpsample.h). divisor 1..NRD_RESOLUTION_DIVISOR_MAX; needs IN_VIEWZ. Applied by the
+// slot's next initialization and kept across releases.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetResolutionScale(int denoiserType, int divisor)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (divisor < 1 || divisor > NRD_RESOLUTION_DIVISOR_MAX)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_RESOLUTION_SCALE;
+	command.slot = denoiserType;
+	command.value = divisor;
+	return PostCommand(command);
+}
+
+
+// CPU reference of the upsample pass over whole images (see UpsampleImage), for golden tests.
+// Normals may be null (depth weights only). Callable from any thread.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDReferenceUpsample(const float* lowValue, const float* lowViewZ, const float* lowNormal,
+	int lowWidth, int lowHeight, const float* viewZ, const float* normal, int width, int height, int divisor, float* result)
+{
+	if (lowValue == nullptr || lowViewZ == nullptr || viewZ == nullptr || result == nullptr)
+		return false;
+
+	if (divisor < 1 || lowWidth < 1 || lowHeight < 1 || width < 1 || height < 1)
+		return false;
+
+	UpsampleImage(lowValue, lowViewZ, lowNormal, lowWidth, lowHeight, viewZ, normal, width, height, divisor, result);
+	return true;
+}
+
+
+// Checkerboard input for a slot's REBLUR/RELAX members — NRDCheckerboardMode: 0 = off (default),
+// 1 = black, 2 = white. Signal inputs then hold only this frame's pixels, packed to half width;
+// NRDGetCheckerboardPhase tells which. Applied by the slot's next initialization (error 10 if the
+// slot or its textures don't fit the mode) and kept across releases.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetCheckerboardMode(int denoiserType, int mode)
+{
+	if (denoiserType < 0 || denoiserType >= NRD_SLOT_COUNT)
+		return false;
+
+	if (mode != NRD_CHECKERBOARD_OFF && mode != NRD_CHECKERBOARD_BLACK && mode != NRD_CHECKERBOARD_WHITE)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_CHECKERBOARD_MODE;
+	command.slot = denoiserType;
+	command.value = mode;
+	return PostCommand(command);
+}
+
+
+// Pixels to trace for a frame in a checkerboard mode: those with ((x ^ y) & 1) == the result, stored
+// at (x / 2, y). frameIndex is the one passed with the frame's matrices. -1 = every pixel (off).
+// Callable from any thread.
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetCheckerboardPhase(int mode, unsigned int frameIndex, bool specular)
+{
+	return GetCheckerboardPhase(mode, frameIndex, specular);
+}
+
+
+// VRAM residency policy. Instances not executed for more than idleFrames frames (0 = never) are
+// suspended; with evictUnderPressure, so are the least recently used ones while the adapter's
+// video memory usage exceeds its budget minus reserveBytes. A suspended slot stays initialized and
+// is rebuilt in the background once it is executed again, with its history reset. Off by default.
+extern "C" bool UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetMemoryPolicy(int idleFrames, bool evictUnderPressure, unsigned long long reserveBytes)
+{
+	if (idleFrames < 0)
+		return false;
+
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_MEMORY_POLICY;
+	command.value = idleFrames;
+	command.flag = evictUnderPressure;
+	command.bytes = reserveBytes;
+	return PostCommand(command);
+}
+
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDReleaseGroup(int groupIndex)
+{
+	if (groupIndex < 0 || groupIndex >= NRD_MAX_GROUPS)
+		return;
+
+	NRDRelease(NRD_DENOISER_COUNT + groupIndex);
 }
 
 
@@ -233,15 +1039,20 @@ extern "C" UnityRenderingEvent UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGet
 }
 
 
+// Execute callback for CommandBuffer.IssuePluginEventAndData with an NRDFrameParams block as data.
+// Same event ID encoding as NRDGetExecuteCallback, minus the ring slot bits.
+extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDGetExecuteCallbackWithData()
+{
+	return OnExecuteEventWithData;
+}
+
+
 extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDReleaseAll()
 {
-	std::lock_guard<std::mutex> lock(g_mutex);
-	if (s_CurrentAPI != nullptr)
-	{
-		s_CurrentAPI->NRDReleaseAllSlots();
-		for (int i = 0; i < NRD_DENOISER_COUNT; i++)
-			g_initialized[i] = false;
-	}
+	NRDCommand command = {};
+	command.type = NRDCommandType::RELEASE_ALL;
+	command.slot = -1;
+	PostCommand(command);
 }
 
 
@@ -254,12 +1065,27 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetMatrix(int fram
 }
 
 
-extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetLightDirection(float x, float y, float z)
+// Dynamic resolution: the active render rect for frameIndex, in the top-left corner of resources
+// allocated at the maximum size passed to NRDInitialize. Clamped to that size; frames without a
+// rect use the full size. Changing it keeps the NRD instance and its history.
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetRenderRect(int frameIndex, int width, int height)
 {
 	if (s_CurrentAPI == nullptr)
 		return;
 
-	s_CurrentAPI->SetLightDirection(x, y, z);
+	s_CurrentAPI->SetRenderRect(frameIndex, width, height);
+}
+
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API NRDSetLightDirection(float x, float y, float z)
+{
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_LIGHT_DIRECTION;
+	command.slot = -1;
+	command.vector[0] = x;
+	command.vector[1] = y;
+	command.vector[2] = z;
+	PostCommand(command);
 }
 
 
@@ -0,0 +1,19 @@
+#pragma once
+#include "IUnityInterface.h"
+
+#include <stdint.h>
+
+typedef struct UnityAllocator UnityAllocator;
+
+// Allocations made through an allocator created here are tracked by Unity's memory profiler
+// under the given area and object names.
+UNITY_DECLARE_INTERFACE(IUnityMemoryManager)
+{
+    UnityAllocator* (UNITY_INTERFACE_API * CreateAllocator)(const char* areaName, const char* objectName);
+    void(UNITY_INTERFACE_API * DestroyAllocator)(UnityAllocator * allocator);
+
+    void* (UNITY_INTERFACE_API * Allocate)(UnityAllocator * allocator, size_t size, size_t align, const char* file, int32_t line);
+    void(UNITY_INTERFACE_API * Deallocate)(UnityAllocator * allocator, void* ptr, const char* file, int32_t line);
+    void* (UNITY_INTERFACE_API * Reallocate)(UnityAllocator * allocator, void* ptr, size_t size, size_t align, const char* file, int32_t line);
+};
+UNITY_REGISTER_INTERFACE_GUID(0xBAF9E57C61A811ECULL, 0xC5A7CC7861A811ECULL, IUnityMemoryManager)
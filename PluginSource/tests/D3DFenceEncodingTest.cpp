@@ -0,0 +1,79 @@
+#include "NRDTest.h"
+
+#include "D3DFenceEncoding.h"
+
+
+// D3D12_COMMAND_LIST_TYPE values (d3d12.h isn't available on the host)
+static const uint32_t QUEUE_DIRECT = 0;
+static const uint32_t QUEUE_COMPUTE = 2;
+static const uint32_t QUEUE_COPY = 3;
+
+static const uint32_t s_types[] = { QUEUE_DIRECT, QUEUE_COMPUTE, QUEUE_COPY, 0xFF };
+static const uint64_t s_counters[] = { 0, 1, 12345, 0xDEADBEEF, kFenceCounterMask - 1, kFenceCounterMask };
+
+
+NRD_TEST(BaseCarriesQueueTypeInTopByte)
+{
+	NRD_CHECK(MakeQueueFenceBase(QUEUE_DIRECT) == 0);
+	NRD_CHECK(MakeQueueFenceBase(QUEUE_COMPUTE) == 0x0200000000000000ull);
+	NRD_CHECK(MakeQueueFenceBase(QUEUE_COPY) == 0x0300000000000000ull);
+
+	// Only the low 8 bits of the type are encoded
+	NRD_CHECK(MakeQueueFenceBase(0x1FF) == 0xFF00000000000000ull);
+}
+
+
+NRD_TEST(DirectQueueValuesAreTheBareCounter)
+{
+	// Type 0 leaves the value untouched — extraction must still report DIRECT, not "no queue"
+	for (uint64_t counter : s_counters)
+	{
+		uint64_t value = MakeQueueFenceValue(QUEUE_DIRECT, counter);
+		NRD_CHECK(value == counter);
+		NRD_CHECK(GetFenceQueueType(value) == QUEUE_DIRECT);
+		NRD_CHECK(GetFenceCounter(value) == counter);
+	}
+}
+
+
+NRD_TEST(ValueRoundTrip)
+{
+	for (uint32_t type : s_types)
+	{
+		for (uint64_t counter : s_counters)
+		{
+			uint64_t value = MakeQueueFenceValue(type, counter);
+			NRD_CHECK(GetFenceQueueType(value) == type);
+			NRD_CHECK(GetFenceCounter(value) == counter);
+		}
+
+		NRD_CHECK(MakeQueueFenceValue(type, 0) == MakeQueueFenceBase(type));
+	}
+}
+
+
+NRD_TEST(CounterIsMaskedToItsBits)
+{
+	// A counter overflowing into the type byte must not change the queue
+	uint64_t value = MakeQueueFenceValue(QUEUE_COMPUTE, kFenceCounterMask + 1);
+	NRD_CHECK(GetFenceQueueType(value) == QUEUE_COMPUTE);
+	NRD_CHECK(GetFenceCounter(value) == 0);
+
+	value = MakeQueueFenceValue(QUEUE_DIRECT, ~0ull);
+	NRD_CHECK(GetFenceQueueType(value) == QUEUE_DIRECT);
+	NRD_CHECK(GetFenceCounter(value) == kFenceCounterMask);
+}
+
+
+NRD_TEST(QueuesNeverCollideAndStayOrdered)
+{
+	for (uint64_t counter = 0; counter < 64; counter++)
+	{
+		NRD_CHECK(MakeQueueFenceValue(QUEUE_DIRECT, counter) != MakeQueueFenceValue(QUEUE_COMPUTE, counter));
+		NRD_CHECK(MakeQueueFenceValue(QUEUE_COMPUTE, counter) != MakeQueueFenceValue(QUEUE_COPY, counter));
+
+		// Fence completion compares values of one queue — they must grow with the counter
+		NRD_CHECK(MakeQueueFenceValue(QUEUE_COMPUTE, counter + 1) > MakeQueueFenceValue(QUEUE_COMPUTE, counter));
+		NRD_CHECK(MakeQueueFenceValue(QUEUE_DIRECT, counter + 1) > MakeQueueFenceValue(QUEUE_DIRECT, counter));
+	}
+}
@@ -0,0 +1,188 @@
+#include "NRDTest.h"
+
+#include "NRDAliasPlanner.h"
+
+
+static const uint64_t KB = 1024;
+static const uint64_t ALIGNMENT = 64 * KB; // D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+
+
+static bool LifetimesOverlap(const AliasRequest& a, const AliasRequest& b)
+{
+	return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+}
+
+
+// The invariants every plan must hold, whatever the heuristic
+static bool IsValidPlan(const AliasRequest* requests, int count, const AliasPlacement* placements, uint64_t heapSize)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const AliasRequest& a = requests[i];
+		if (a.alignment > 1 && placements[i].offset % a.alignment != 0)
+			return false;
+		if (placements[i].offset + a.size > heapSize)
+			return false;
+
+		for (int j = i + 1; j < count; j++)
+		{
+			const AliasRequest& b = requests[j];
+			bool memoryOverlaps = a.size != 0 && b.size != 0 && placements[i].offset < placements[j].offset + b.size
+				&& placements[j].offset < placements[i].offset + a.size;
+			if (memoryOverlaps && LifetimesOverlap(a, b))
+				return false;
+		}
+
+		// The aliasing barrier's "before" block must have ended before this one starts and share its memory
+		int before = placements[i].aliasBefore;
+		if (before >= 0 && (before == i || requests[before].lastUse >= a.firstUse))
+			return false;
+	}
+	return true;
+}
+
+
+NRD_TEST(SequentialBlocksShareOneRange)
+{
+	// Graphics-queue slots dispatched one after another
+	AliasRequest requests[3] = {
+		{ 4 * ALIGNMENT, ALIGNMENT, 0, 0 },
+		{ 8 * ALIGNMENT, ALIGNMENT, 1, 1 },
+		{ 2 * ALIGNMENT, ALIGNMENT, 2, 2 },
+	};
+	AliasPlacement placements[3];
+
+	uint64_t heapSize = PlanAliasing(requests, 3, placements);
+	NRD_CHECK(heapSize == 8 * ALIGNMENT);
+	NRD_CHECK(IsValidPlan(requests, 3, placements, heapSize));
+	for (int i = 0; i < 3; i++)
+		NRD_CHECK(placements[i].offset == 0);
+
+	// Each block discards the one used right before it
+	NRD_CHECK(placements[0].aliasBefore == -1);
+	NRD_CHECK(placements[1].aliasBefore == 0);
+	NRD_CHECK(placements[2].aliasBefore == 1);
+}
+
+
+NRD_TEST(OverlappingBlocksAreStacked)
+{
+	// An async compute slot is live for the whole frame, next to two sequential slots
+	AliasRequest requests[3] = {
+		{ 3 * ALIGNMENT, ALIGNMENT, 0, 1000 },
+		{ 5 * ALIGNMENT, ALIGNMENT, 0, 0 },
+		{ 2 * ALIGNMENT, ALIGNMENT, 1, 1 },
+	};
+	AliasPlacement placements[3];
+
+	uint64_t heapSize = PlanAliasing(requests, 3, placements);
+	NRD_CHECK(IsValidPlan(requests, 3, placements, heapSize));
+	NRD_CHECK(heapSize == 8 * ALIGNMENT);
+	NRD_CHECK(placements[0].aliasBefore == -1);
+	NRD_CHECK(placements[1].aliasBefore == -1);
+	NRD_CHECK(placements[2].aliasBefore == 1);
+}
+
+
+NRD_TEST(AllLiveTogetherNeedsTheSum)
+{
+	AliasRequest requests[4] = {
+		{ 100 * KB, ALIGNMENT, 0, 3 },
+		{ 10 * KB, ALIGNMENT, 1, 2 },
+		{ 200 * KB, ALIGNMENT, 2, 2 },
+		{ 1 * KB, ALIGNMENT, 0, 2 },
+	};
+	AliasPlacement placements[4];
+
+	uint64_t heapSize = PlanAliasing(requests, 4, placements);
+	NRD_CHECK(IsValidPlan(requests, 4, placements, heapSize));
+
+	// Largest first, each starting on a placement boundary: 200 KB (padded to 256), 100 (128), 10 (64), 1
+	NRD_CHECK(heapSize == (256 + 128 + 64 + 1) * KB);
+	for (int i = 0; i < 4; i++)
+		NRD_CHECK(placements[i].aliasBefore == -1);
+}
+
+
+NRD_TEST(LifetimesAreInclusive)
+{
+	// Ending at the position the other one starts at still overlaps
+	AliasRequest requests[2] = {
+		{ ALIGNMENT, ALIGNMENT, 0, 2 },
+		{ ALIGNMENT, ALIGNMENT, 2, 4 },
+	};
+	AliasPlacement placements[2];
+
+	NRD_CHECK(PlanAliasing(requests, 2, placements) == 2 * ALIGNMENT);
+	NRD_CHECK(placements[0].offset != placements[1].offset);
+}
+
+
+NRD_TEST(UnalignedAndEmptyBlocks)
+{
+	AliasRequest requests[3] = {
+		{ 10, 0, 0, 5 },
+		{ 0, 1, 0, 5 },
+		{ 7, 1, 0, 5 },
+	};
+	AliasPlacement placements[3];
+
+	uint64_t heapSize = PlanAliasing(requests, 3, placements);
+	NRD_CHECK(heapSize == 17);
+	NRD_CHECK(IsValidPlan(requests, 3, placements, heapSize));
+}
+
+
+NRD_TEST(CountOutOfRange)
+{
+	AliasRequest request = { ALIGNMENT, ALIGNMENT, 0, 0 };
+	AliasPlacement placement;
+	NRD_CHECK(PlanAliasing(&request, 0, &placement) == 0);
+	NRD_CHECK(PlanAliasing(&request, -1, &placement) == 0);
+	NRD_CHECK(PlanAliasing(&request, NRD_ALIAS_MAX_REQUESTS + 1, &placement) == 0);
+}
+
+
+// Deterministic random plans: always valid, never larger than no aliasing, never smaller than the
+// busiest position needs
+NRD_TEST(RandomPlansAreValid)
+{
+	uint32_t state = 12345;
+	auto next = [&state](uint32_t range)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) % range;
+	};
+
+	for (int iteration = 0; iteration < 500; iteration++)
+	{
+		int count = 1 + (int)next(NRD_ALIAS_MAX_REQUESTS);
+		AliasRequest requests[NRD_ALIAS_MAX_REQUESTS];
+		AliasPlacement placements[NRD_ALIAS_MAX_REQUESTS];
+
+		uint64_t alignedSum = 0;
+		for (int i = 0; i < count; i++)
+		{
+			requests[i].size = (1 + next(16)) * ALIGNMENT - next(2) * 1000;
+			requests[i].alignment = ALIGNMENT;
+			requests[i].firstUse = (int)next(24);
+			requests[i].lastUse = requests[i].firstUse + (int)next(6);
+			alignedSum += (requests[i].size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		}
+
+		uint64_t heapSize = PlanAliasing(requests, count, placements);
+		NRD_CHECK(IsValidPlan(requests, count, placements, heapSize));
+		NRD_CHECK(heapSize <= alignedSum);
+
+		for (int position = 0; position < 30; position++)
+		{
+			uint64_t live = 0;
+			for (int i = 0; i < count; i++)
+			{
+				if (requests[i].firstUse <= position && position <= requests[i].lastUse)
+					live += requests[i].size;
+			}
+			NRD_CHECK(heapSize >= live);
+		}
+	}
+}
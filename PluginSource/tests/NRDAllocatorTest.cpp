@@ -0,0 +1,217 @@
+#include "NRDTest.h"
+
+#include "NRDAllocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// Upstream that counts what the pool asks of it — a stand-in for the CRT / Unity's memory manager
+struct CountingUpstream
+{
+	int allocations = 0;
+	int frees = 0;
+	size_t outstandingBytes = 0;
+	NRDUpstreamAllocator callbacks = {};
+
+	CountingUpstream()
+	{
+		callbacks.allocate = Allocate;
+		callbacks.free = Free;
+		callbacks.userArg = this;
+	}
+
+	static void* Allocate(void* userArg, size_t size, size_t alignment)
+	{
+		CountingUpstream* upstream = (CountingUpstream*)userArg;
+		upstream->allocations++;
+		upstream->outstandingBytes += size;
+
+		// Size prefix so Free can account for the block
+		uint8_t* memory = (uint8_t*)malloc(size + 16);
+		*(size_t*)memory = size;
+		NRD_CHECK(alignment <= 16);
+		return memory + 16;
+	}
+
+	static void Free(void* userArg, void* memory)
+	{
+		CountingUpstream* upstream = (CountingUpstream*)userArg;
+		uint8_t* block = (uint8_t*)memory - 16;
+		upstream->frees++;
+		upstream->outstandingBytes -= *(size_t*)block;
+		free(block);
+	}
+};
+
+
+// What one RecordDenoise asks of the instance's allocator: NRD's dispatch list grown through
+// Reallocate, NRI's per-dispatch descriptor set and barrier scratch, a resource snapshot, an
+// over-aligned constant staging block and one buffer above the largest size class. Every block
+// is released by the end of the frame, some in allocation order and some in reverse.
+static void RecordDenoiseFrame(NRDAllocator& allocator, int frame)
+{
+	static const size_t SMALL_SIZES[] = { 24, 48, 96, 200, 640 };
+	static const int SMALL_COUNT = sizeof(SMALL_SIZES) / sizeof(SMALL_SIZES[0]);
+
+	void* dispatches = nullptr;
+	for (size_t capacity = 64; capacity <= 8192; capacity *= 2)
+	{
+		dispatches = allocator.Reallocate(dispatches, capacity, 8);
+		NRD_CHECK(dispatches != nullptr);
+		memset(dispatches, frame & 0xFF, capacity);
+	}
+
+	void* snapshot = allocator.Allocate(4096, 16);
+	void* constants = allocator.Allocate(1024, 256);
+	void* large = allocator.Allocate(96 * 1024, 16);
+	NRD_CHECK(snapshot && constants && large);
+	NRD_CHECK(((uintptr_t)constants & 255) == 0);
+	memset(large, 0, 96 * 1024);
+
+	// Per-dispatch scratch — more dispatches on some frames than on others
+	void* scratch[3 * SMALL_COUNT];
+	int scratchCount = 0;
+	int dispatchCount = 1 + frame % 3;
+	for (int d = 0; d < dispatchCount; d++)
+	{
+		for (int i = 0; i < SMALL_COUNT; i++)
+		{
+			scratch[scratchCount] = allocator.Allocate(SMALL_SIZES[i], 8);
+			NRD_CHECK(scratch[scratchCount] != nullptr);
+			scratchCount++;
+		}
+	}
+
+	if (frame % 2 == 0)
+	{
+		for (int i = 0; i < scratchCount; i++)
+			allocator.Free(scratch[i]);
+	}
+	else
+	{
+		for (int i = scratchCount - 1; i >= 0; i--)
+			allocator.Free(scratch[i]);
+	}
+
+	allocator.Free(large);
+	allocator.Free(constants);
+	allocator.Free(snapshot);
+	allocator.Free(dispatches);
+}
+
+
+NRD_TEST(SteadyStateFramesMakeNoUpstreamAllocations)
+{
+	CountingUpstream upstream;
+	NRDAllocator allocator(&upstream.callbacks);
+
+	// Warm-up covers the largest frame (three dispatches)
+	for (int frame = 0; frame < 3; frame++)
+		RecordDenoiseFrame(allocator, frame);
+
+	int warmAllocations = upstream.allocations;
+	size_t warmBytes = upstream.outstandingBytes;
+	NRD_CHECK(warmAllocations > 0);
+
+	for (int frame = 3; frame < 1003; frame++)
+		RecordDenoiseFrame(allocator, frame);
+
+	NRD_CHECK(upstream.allocations == warmAllocations);
+	NRD_CHECK(upstream.frees == 0);
+	NRD_CHECK(upstream.outstandingBytes == warmBytes);
+
+	allocator.Trim();
+	NRD_CHECK(upstream.frees == upstream.allocations);
+	NRD_CHECK(upstream.outstandingBytes == 0);
+}
+
+
+NRD_TEST(RenderThreadStatsStayFlatAtSteadyState)
+{
+	CountingUpstream upstream;
+	NRDAllocator allocator(&upstream.callbacks);
+	NRDAllocator::MarkRenderThread();
+
+	for (int frame = 0; frame < 3; frame++)
+		RecordDenoiseFrame(allocator, frame);
+
+	NRDAllocatorStats before;
+	NRDAllocator::GetStats(before);
+	NRD_CHECK(before.renderThreadUpstreamAllocations > 0);
+
+	for (int frame = 3; frame < 503; frame++)
+		RecordDenoiseFrame(allocator, frame);
+
+	NRDAllocatorStats after;
+	NRDAllocator::GetStats(after);
+	NRD_CHECK(after.upstreamAllocations == before.upstreamAllocations);
+	NRD_CHECK(after.renderThreadUpstreamAllocations == before.renderThreadUpstreamAllocations);
+	NRD_CHECK(after.reservedBytes == before.reservedBytes);
+}
+
+
+NRD_TEST(FreedBlocksAreReusedBySizeClass)
+{
+	CountingUpstream upstream;
+	NRDAllocator allocator(&upstream.callbacks);
+
+	void* a = allocator.Allocate(100, 8);
+	allocator.Free(a);
+
+	// Same class (128 bytes), and still within it once over-alignment slack is added
+	void* b = allocator.Allocate(120, 8);
+	void* c = allocator.Reallocate(b, 128, 16);
+	NRD_CHECK(b == a);
+	NRD_CHECK(c == b);
+	NRD_CHECK(upstream.allocations == 1);
+
+	// A different class needs a new block
+	void* d = allocator.Allocate(300, 8);
+	NRD_CHECK(upstream.allocations == 2);
+
+	allocator.Free(c);
+	allocator.Free(d);
+}
+
+
+NRD_TEST(LargeBlockCacheIsBounded)
+{
+	CountingUpstream upstream;
+	NRDAllocator allocator(&upstream.callbacks);
+
+	void* blocks[NRD_ALLOCATOR_LARGE_CACHE + 2];
+	for (int i = 0; i < NRD_ALLOCATOR_LARGE_CACHE + 2; i++)
+		blocks[i] = allocator.Allocate(NRD_ALLOCATOR_MAX_POOLED_SIZE + 1024 * (size_t)(i + 1), 16);
+	for (int i = 0; i < NRD_ALLOCATOR_LARGE_CACHE + 2; i++)
+		allocator.Free(blocks[i]);
+
+	// The cache keeps the first eight; the rest went straight back
+	NRD_CHECK(upstream.frees == 2);
+
+	// Best fit: the smallest cached block that holds the request
+	void* reused = allocator.Allocate(NRD_ALLOCATOR_MAX_POOLED_SIZE + 1536, 16);
+	NRD_CHECK(reused == blocks[1]);
+	NRD_CHECK(upstream.allocations == NRD_ALLOCATOR_LARGE_CACHE + 2);
+	allocator.Free(reused);
+}
+
+
+NRD_TEST(UpstreamIsFixedWhileMemoryIsReserved)
+{
+	CountingUpstream first;
+	CountingUpstream second;
+	NRDAllocator allocator(&first.callbacks);
+
+	void* memory = allocator.Allocate(64, 8);
+	allocator.Free(memory);
+
+	// The pooled block still belongs to the first upstream
+	NRD_CHECK(!allocator.SetUpstream(&second.callbacks));
+
+	allocator.Trim();
+	NRD_CHECK(allocator.SetUpstream(&second.callbacks));
+	allocator.Free(allocator.Allocate(64, 8));
+	NRD_CHECK(first.allocations == 1 && first.frees == 1);
+	NRD_CHECK(second.allocations == 1);
+}
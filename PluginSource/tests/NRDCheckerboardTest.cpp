@@ -0,0 +1,124 @@
+#include "NRDTest.h"
+
+#include "NRDCheckerboard.h"
+
+#include <vector>
+
+
+static const int MODES[] = { NRD_CHECKERBOARD_BLACK, NRD_CHECKERBOARD_WHITE };
+static const uint32_t FRAMES[] = { 0, 1, 2, 3, 7, 1000, 0xFFFFFFFEu, 0xFFFFFFFFu };
+
+
+NRD_TEST(PhaseGoldenValues)
+{
+	// NRD's frame 0: BLACK traces diffuse on even (x ^ y), WHITE on odd
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_BLACK, 0, false) == 0);
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_BLACK, 0, true) == 1);
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_WHITE, 0, false) == 1);
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_WHITE, 0, true) == 0);
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_BLACK, 1, false) == 1);
+	NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_WHITE, 7, true) == 1);
+}
+
+
+NRD_TEST(PhaseAlternatesAndSignalsAreComplementary)
+{
+	for (int mode : MODES)
+	{
+		for (uint32_t frame : FRAMES)
+		{
+			int diffuse = GetCheckerboardPhase(mode, frame, false);
+			int specular = GetCheckerboardPhase(mode, frame, true);
+			NRD_CHECK(diffuse == 0 || diffuse == 1);
+			NRD_CHECK(specular == 1 - diffuse);
+
+			// The next frame traces the other pixels (the frame index wraps like NRD's)
+			NRD_CHECK(GetCheckerboardPhase(mode, frame + 1, false) == 1 - diffuse);
+			NRD_CHECK(GetCheckerboardPhase(mode, frame + 2, false) == diffuse);
+		}
+
+		// The two modes are each other's opposite
+		int other = mode == NRD_CHECKERBOARD_BLACK ? NRD_CHECKERBOARD_WHITE : NRD_CHECKERBOARD_BLACK;
+		for (uint32_t frame : FRAMES)
+			NRD_CHECK(GetCheckerboardPhase(mode, frame, false) == GetCheckerboardPhase(other, frame, true));
+	}
+}
+
+
+NRD_TEST(OffTracesEveryPixel)
+{
+	for (uint32_t frame : FRAMES)
+	{
+		NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_OFF, frame, false) == -1);
+		NRD_CHECK(GetCheckerboardPhase(NRD_CHECKERBOARD_OFF, frame, true) == -1);
+		NRD_CHECK(GetCheckerboardPhase(3, frame, false) == -1);
+	}
+
+	for (int width = 1; width <= 9; width++)
+		NRD_CHECK(GetCheckerboardInputWidth(NRD_CHECKERBOARD_OFF, width) == width);
+}
+
+
+NRD_TEST(InputWidthHoldsEveryTracedPixel)
+{
+	// Traced pixel (x, y) is packed at (x / 2, y): on every row of an odd or even width, for both
+	// signals and phases, the packed columns are distinct and fit the input width exactly
+	static const int WIDTHS[] = { 1, 2, 3, 7, 8, 1279, 1920 };
+	for (int mode : MODES)
+	{
+		for (int width : WIDTHS)
+		{
+			int inputWidth = GetCheckerboardInputWidth(mode, width);
+			NRD_CHECK(inputWidth == (width + 1) / 2);
+
+			int widest = 0;
+			for (uint32_t frame : FRAMES)
+			{
+				for (int signal = 0; signal < 2; signal++)
+				{
+					int phase = GetCheckerboardPhase(mode, frame, signal == 1);
+					for (int y = 0; y < 2; y++)
+					{
+						std::vector<int> used(inputWidth, 0);
+						int traced = 0;
+						for (int x = 0; x < width; x++)
+						{
+							if (((x ^ y) & 1) != phase)
+								continue;
+
+							int column = x / 2;
+							NRD_CHECK(column < inputWidth);
+							if (column < inputWidth)
+								used[column]++;
+							traced++;
+						}
+
+						for (int column = 0; column < inputWidth; column++)
+							NRD_CHECK(used[column] <= 1);
+						if (traced > widest)
+							widest = traced;
+					}
+				}
+			}
+
+			// Some row and phase fills the input completely
+			NRD_CHECK(widest == inputWidth);
+		}
+	}
+}
+
+
+NRD_TEST(OnlySignalsAreCheckerboarded)
+{
+	NRD_CHECK(IsCheckerboardInput(nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST));
+	NRD_CHECK(IsCheckerboardInput(nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST));
+	NRD_CHECK(IsCheckerboardInput(nrd::ResourceType::IN_DIFF_SH1));
+	NRD_CHECK(IsCheckerboardInput(nrd::ResourceType::IN_SPEC_HITDIST));
+
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::IN_MV));
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::IN_NORMAL_ROUGHNESS));
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::IN_VIEWZ));
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::IN_DIFF_CONFIDENCE));
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::IN_PENUMBRA));
+	NRD_CHECK(!IsCheckerboardInput(nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST));
+}
@@ -0,0 +1,212 @@
+#include "NRDTest.h"
+
+#include "NRDCommandChannel.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// The producer's own running index travels in bytes — sequence belongs to the channel
+static NRDCommand MakeCommand(int producer, uint64_t index)
+{
+	NRDCommand command = {};
+	command.type = NRDCommandType::SET_QUEUE_MODE;
+	command.slot = producer;
+	command.bytes = index;
+	command.value = (int)(index * 31 + producer);
+	command.renderWidth = (int)(index ^ 0x5A5A5A5Aull);
+	command.resourceCount = MAX_GROUP_RESOURCES;
+	for (int i = 0; i < MAX_GROUP_RESOURCES; i++)
+		command.resources[i] = (void*)(uintptr_t)(index + i);
+	return command;
+}
+
+
+// A torn copy (producer still writing while the consumer reads) breaks one of these
+static bool IsIntact(const NRDCommand& command)
+{
+	if (command.value != (int)(command.bytes * 31 + command.slot) || command.renderWidth != (int)(command.bytes ^ 0x5A5A5A5Aull))
+		return false;
+
+	for (int i = 0; i < MAX_GROUP_RESOURCES; i++)
+	{
+		if (command.resources[i] != (void*)(uintptr_t)(command.bytes + i))
+			return false;
+	}
+	return true;
+}
+
+
+NRD_TEST(EmptyChannelPopsNothing)
+{
+	static NRDCommandChannel channel;
+	NRDCommand command;
+	NRD_CHECK(!channel.TryPop(command));
+}
+
+
+NRD_TEST(FifoAndCapacity)
+{
+	static NRDCommandChannel channel;
+	NRDCommand command;
+
+	// Several laps, so cell sequence numbers wrap around the ring
+	uint64_t pushed = 0;
+	uint64_t popped = 0;
+	for (int lap = 0; lap < 3; lap++)
+	{
+		for (int i = 0; i < NRD_COMMAND_CHANNEL_CAPACITY; i++)
+		{
+			command = MakeCommand(0, pushed++);
+			NRD_CHECK(channel.TryPush(command));
+			NRD_CHECK(command.sequence == pushed);
+		}
+
+		// Full: the push fails, loses nothing and uses up no sequence
+		command = MakeCommand(0, 9999);
+		NRD_CHECK(!channel.TryPush(command));
+
+		for (int i = 0; i < NRD_COMMAND_CHANNEL_CAPACITY; i++)
+		{
+			NRD_CHECK(channel.TryPop(command));
+			NRD_CHECK(command.bytes == popped++);
+			NRD_CHECK(command.sequence == popped);
+			NRD_CHECK(IsIntact(command));
+		}
+		NRD_CHECK(!channel.TryPop(command));
+	}
+
+	// One slot freed makes room for exactly one more
+	for (int i = 0; i < NRD_COMMAND_CHANNEL_CAPACITY; i++)
+	{
+		command = MakeCommand(0, i);
+		channel.TryPush(command);
+	}
+	NRD_CHECK(channel.TryPop(command));
+	command = MakeCommand(0, 1000);
+	NRD_CHECK(channel.TryPush(command));
+	command = MakeCommand(0, 1001);
+	NRD_CHECK(!channel.TryPush(command));
+}
+
+
+// Several producers against one consumer, with the queue small enough relative to the traffic that
+// it keeps filling up. Every command must arrive exactly once, intact and in its producer's order.
+// Build with NRD_TESTS_TSAN=ON to have ThreadSanitizer check the cell handoff.
+NRD_TEST(MultiProducerStress)
+{
+	static const int PRODUCERS = 4;
+	static const uint64_t COMMANDS_PER_PRODUCER = 200000;
+
+	static NRDCommandChannel channel;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; p++)
+	{
+		producers.emplace_back([p]()
+		{
+			for (uint64_t i = 0; i < COMMANDS_PER_PRODUCER; i++)
+			{
+				NRDCommand command = MakeCommand(p, i);
+				while (!channel.TryPush(command))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	uint64_t next[PRODUCERS] = {};
+	uint64_t received = 0;
+	bool intact = true;
+	bool ordered = true;
+	while (received < PRODUCERS * COMMANDS_PER_PRODUCER)
+	{
+		NRDCommand command;
+		if (!channel.TryPop(command))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		intact = intact && command.slot >= 0 && command.slot < PRODUCERS && IsIntact(command);
+		if (!intact)
+			break;
+
+		ordered = ordered && command.bytes == next[command.slot];
+		next[command.slot] = command.bytes + 1;
+		received++;
+	}
+
+	for (std::thread& producer : producers)
+		producer.join();
+
+	NRD_CHECK(intact);
+	NRD_CHECK(ordered);
+	for (int p = 0; p < PRODUCERS; p++)
+		NRD_CHECK(next[p] == COMMANDS_PER_PRODUCER);
+
+	NRDCommand command;
+	NRD_CHECK(!channel.TryPop(command));
+}
+
+
+// Producers posting to the same slots, the way RenderingPlugin's PostCommand and the render thread
+// use the channel: each producer raises the slot's requested sequence after its push, and the
+// consumer publishes each popped command's sequence for its slot. Sequences must reach the consumer
+// in rising order, so once everything is applied every slot has published the highest one requested.
+NRD_TEST(SharedSlotSequencesPublishInOrder)
+{
+	static const int PRODUCERS = 4;
+	static const int SLOTS = 3;
+	static const uint64_t COMMANDS_PER_PRODUCER = 100000;
+
+	static NRDCommandChannel channel;
+	static std::atomic<uint64_t> requested[SLOTS];
+	for (int s = 0; s < SLOTS; s++)
+		requested[s].store(0);
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; p++)
+	{
+		producers.emplace_back([p]()
+		{
+			for (uint64_t i = 0; i < COMMANDS_PER_PRODUCER; i++)
+			{
+				NRDCommand command = MakeCommand(p, i);
+				command.slot = (int)((i + p) % SLOTS);
+				while (!channel.TryPush(command))
+					std::this_thread::yield();
+
+				uint64_t current = requested[command.slot].load(std::memory_order_relaxed);
+				while (current < command.sequence && !requested[command.slot].compare_exchange_weak(current, command.sequence))
+				{
+				}
+			}
+		});
+	}
+
+	uint64_t published[SLOTS] = {};
+	uint64_t last = 0;
+	uint64_t received = 0;
+	bool rising = true;
+	while (received < PRODUCERS * COMMANDS_PER_PRODUCER)
+	{
+		NRDCommand command;
+		if (!channel.TryPop(command))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		rising = rising && command.sequence == last + 1;
+		last = command.sequence;
+		published[command.slot] = command.sequence;
+		received++;
+	}
+
+	for (std::thread& producer : producers)
+		producer.join();
+
+	NRD_CHECK(rising);
+	for (int s = 0; s < SLOTS; s++)
+		NRD_CHECK(published[s] == requested[s].load());
+}
@@ -0,0 +1,216 @@
+#include "NRDTest.h"
+
+#include "NRDComposite.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+
+static const float TOLERANCE = 1e-5f;
+
+
+static void CheckColor(const float color[3], float r, float g, float b)
+{
+	NRD_CHECK_NEAR(color[0], r, TOLERANCE);
+	NRD_CHECK_NEAR(color[1], g, TOLERANCE);
+	NRD_CHECK_NEAR(color[2], b, TOLERANCE);
+}
+
+
+NRD_TEST(YCoCgRoundTrips)
+{
+	static const float COLORS[][3] = {
+		{ 0.3f, 0.7f, 0.1f },
+		{ 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f },
+		{ 12.5f, 3.25f, 0.5f },
+	};
+
+	for (int i = 0; i < (int)(sizeof(COLORS) / sizeof(COLORS[0])); i++)
+	{
+		float ycocg[3];
+		float color[3];
+		LinearToYCoCg(COLORS[i], ycocg);
+		YCoCgToLinear(ycocg, color);
+		CheckColor(color, COLORS[i][0], COLORS[i][1], COLORS[i][2]);
+	}
+
+	// Golden: NRD's forward transform
+	float ycocg[3];
+	static const float COLOR[3] = { 0.3f, 0.7f, 0.1f };
+	LinearToYCoCg(COLOR, ycocg);
+	CheckColor(ycocg, 0.45f, 0.1f, 0.25f);
+}
+
+
+NRD_TEST(YCoCgToLinearClampsNegatives)
+{
+	static const float YCOCG[3] = { 0.1f, 0.5f, 0.0f };
+	float color[3];
+	YCoCgToLinear(YCOCG, color);
+	CheckColor(color, 0.6f, 0.1f, 0.0f);
+}
+
+
+NRD_TEST(ResolveShGoldenValues)
+{
+	static const float UP[3] = { 0.0f, 0.0f, 1.0f };
+	static const float DOWN[3] = { 0.0f, 0.0f, -1.0f };
+	static const float SIDE[3] = { 1.0f, 0.0f, 0.0f };
+	float color[3];
+
+	// r = 1: p = 3, a = 0, so the lobe is 4 * q^3
+	static const float SH0[4] = { 1.0f, 0.0f, 0.0f, 5.0f };
+	static const float SH1_FULL[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+	ResolveSh(SH0, SH1_FULL, UP, color);
+	CheckColor(color, 4.0f, 4.0f, 4.0f);
+	ResolveSh(SH0, SH1_FULL, DOWN, color);
+	CheckColor(color, 0.0f, 0.0f, 0.0f);
+	ResolveSh(SH0, SH1_FULL, SIDE, color);
+	CheckColor(color, 0.5f, 0.5f, 0.5f);
+
+	// r = 0.5: p = 2, a = 1/3
+	static const float SH1_HALF[4] = { 0.0f, 0.0f, 0.5f, 0.0f };
+	ResolveSh(SH0, SH1_HALF, UP, color);
+	CheckColor(color, 7.0f / 3.0f, 7.0f / 3.0f, 7.0f / 3.0f);
+	ResolveSh(SH0, SH1_HALF, DOWN, color);
+	CheckColor(color, 1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 3.0f);
+
+	// Chroma scales with the luminance: (4, 0.8, -0.4) in YCoCg
+	static const float SH0_CHROMA[4] = { 1.0f, 0.2f, -0.1f, 0.0f };
+	ResolveSh(SH0_CHROMA, SH1_FULL, UP, color);
+	CheckColor(color, 5.2f, 3.6f, 3.6f);
+
+	// No luminance — black, whatever the lobe
+	static const float SH0_DARK[4] = { 0.0f, 0.3f, 0.3f, 0.0f };
+	ResolveSh(SH0_DARK, SH1_FULL, UP, color);
+	CheckColor(color, 0.0f, 0.0f, 0.0f);
+}
+
+
+NRD_TEST(ResolveShFlatLobeIgnoresNormal)
+{
+	static const float COLOR[3] = { 0.3f, 0.7f, 0.1f };
+	float sh0[4];
+	LinearToYCoCg(COLOR, sh0);
+	sh0[3] = 0.0f;
+	static const float SH1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	static const float NORMALS[][3] = { { 0.0f, 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f }, { 0.6f, 0.0f, 0.8f } };
+
+	for (int i = 0; i < 3; i++)
+	{
+		float color[3];
+		ResolveSh(sh0, SH1, NORMALS[i], color);
+		CheckColor(color, COLOR[0], COLOR[1], COLOR[2]);
+	}
+}
+
+
+NRD_TEST(ResolveShPreservesMeanLuminance)
+{
+	// Averaged over the sphere, a directional lobe resolves to the stored luminance
+	static const float COLOR[3] = { 0.3f, 0.7f, 0.1f };
+	float sh0[4];
+	LinearToYCoCg(COLOR, sh0);
+	sh0[3] = 0.0f;
+	float r = 0.7f;
+	float sh1[4] = { 0.6f * r * sh0[0], 0.0f, 0.8f * r * sh0[0], 0.0f };
+
+	// Fixed seed — the estimate is deterministic
+	srand(1);
+	double sum = 0.0;
+	const int samples = 200000;
+	for (int i = 0; i < samples; i++)
+	{
+		double z = 2.0 * rand() / RAND_MAX - 1.0;
+		double phi = 6.283185307 * rand() / RAND_MAX;
+		double s = sqrt(1.0 - z * z);
+		float normal[3] = { (float)(s * cos(phi)), (float)(s * sin(phi)), (float)z };
+
+		float color[3];
+		float ycocg[3];
+		ResolveSh(sh0, sh1, normal, color);
+		LinearToYCoCg(color, ycocg);
+		sum += ycocg[0];
+	}
+
+	NRD_CHECK_NEAR(sum / samples / sh0[0], 1.0, 0.01);
+}
+
+
+NRD_TEST(CompositeRadianceGoldenValues)
+{
+	NRDCompositeTexel texel = {};
+	texel.diffuse[0] = 1.0f;
+	texel.diffuse[1] = 2.0f;
+	texel.diffuse[2] = 3.0f;
+	texel.albedo[0] = texel.albedo[1] = texel.albedo[2] = 0.5f;
+	texel.specular[0] = 1.0f;
+	texel.specularAlbedo[0] = 0.04f;
+	texel.base[0] = 10.0f;
+	texel.base[3] = 0.25f;
+	float result[4];
+
+	// Diffuse only, written as is with alpha 1
+	EvaluateComposite(texel, NRD_COMPOSITE_DIFFUSE, result);
+	CheckColor(result, 1.0f, 2.0f, 3.0f);
+	NRD_CHECK(result[3] == 1.0f);
+
+	// Both signals without remodulation
+	EvaluateComposite(texel, NRD_COMPOSITE_DIFFUSE | NRD_COMPOSITE_SPECULAR, result);
+	CheckColor(result, 2.0f, 2.0f, 3.0f);
+
+	// Remodulated and added to the base, keeping its alpha
+	EvaluateComposite(texel, NRD_COMPOSITE_DIFFUSE | NRD_COMPOSITE_SPECULAR | NRD_COMPOSITE_REMODULATE | NRD_COMPOSITE_ADD_BASE, result);
+	CheckColor(result, 10.54f, 1.0f, 1.5f);
+	NRD_CHECK(result[3] == 0.25f);
+
+	// Nothing bound but the base
+	EvaluateComposite(texel, NRD_COMPOSITE_ADD_BASE, result);
+	CheckColor(result, 10.0f, 0.0f, 0.0f);
+}
+
+
+NRD_TEST(CompositeYCoCgRadiance)
+{
+	// REBLUR radiance outputs are YCoCg; the hit distance channel is ignored
+	static const float COLOR[3] = { 0.3f, 0.7f, 0.1f };
+	NRDCompositeTexel texel = {};
+	LinearToYCoCg(COLOR, texel.diffuse);
+	texel.diffuse[3] = 42.0f;
+	texel.albedo[0] = 2.0f;
+	texel.albedo[1] = 1.0f;
+	texel.albedo[2] = 0.5f;
+	float result[4];
+
+	EvaluateComposite(texel, NRD_COMPOSITE_DIFFUSE | NRD_COMPOSITE_YCOCG | NRD_COMPOSITE_REMODULATE, result);
+	CheckColor(result, 0.6f, 0.7f, 0.05f);
+}
+
+
+NRD_TEST(CompositeShUsesPackedNormal)
+{
+	NRDCompositeTexel texel = {};
+	texel.diffuse[0] = 1.0f;
+	texel.diffuseSh1[2] = 1.0f;
+	texel.albedo[0] = texel.albedo[1] = texel.albedo[2] = 0.25f;
+	texel.specular[0] = 1.0f;
+	texel.specularSh1[2] = 0.5f;
+	texel.specularAlbedo[0] = texel.specularAlbedo[1] = texel.specularAlbedo[2] = 1.0f;
+	float result[4];
+
+	// GBuffer2 packing: (0.5, 0.5, 1) is +Z
+	texel.normal[0] = 0.5f;
+	texel.normal[1] = 0.5f;
+	texel.normal[2] = 1.0f;
+	uint32_t flags = NRD_COMPOSITE_DIFFUSE | NRD_COMPOSITE_SPECULAR | NRD_COMPOSITE_DIFFUSE_SH | NRD_COMPOSITE_SPECULAR_SH | NRD_COMPOSITE_REMODULATE;
+	EvaluateComposite(texel, flags, result);
+	float up = 0.25f * 4.0f + 7.0f / 3.0f;
+	CheckColor(result, up, up, up);
+
+	// Unnormalized packing still resolves along -Z
+	texel.normal[2] = 0.25f;
+	EvaluateComposite(texel, flags, result);
+	float down = 1.0f / 3.0f;
+	CheckColor(result, down, down, down);
+}
@@ -0,0 +1,161 @@
+#include "NRDTest.h"
+
+#include "NRDDenoiserConfig.h"
+
+
+static const int REBLUR_DIFFUSE = (int)nrd::Denoiser::REBLUR_DIFFUSE;
+static const int REBLUR_SPECULAR = (int)nrd::Denoiser::REBLUR_SPECULAR;
+static const int SIGMA_SHADOW = (int)nrd::Denoiser::SIGMA_SHADOW;
+
+
+static int CountType(const DenoiserGroupLayout& layout, nrd::ResourceType type)
+{
+	int count = 0;
+	for (int i = 0; i < layout.resourceCount; i++)
+		count += layout.resources[i].type == type ? 1 : 0;
+
+	return count;
+}
+
+
+NRD_TEST(SingleDenoiserMatchesItsTableEntry)
+{
+	for (int type = 0; type < NRD_DENOISER_COUNT; type++)
+	{
+		DenoiserGroupLayout layout;
+		NRD_CHECK(BuildDenoiserGroupLayout(&type, 1, layout) == GroupLayoutResult::OK);
+
+		const DenoiserTypeDesc& desc = g_DenoiserTypeDescs[type];
+		NRD_CHECK(layout.denoiserCount == 1 && layout.denoiserTypes[0] == type);
+		NRD_CHECK(layout.resourceCount == desc.resourceCount);
+		for (int i = 0; i < desc.resourceCount; i++)
+		{
+			NRD_CHECK(layout.resources[i].type == desc.resources[i].type);
+			NRD_CHECK(layout.resources[i].isOutput == desc.resources[i].isOutput);
+			NRD_CHECK(layout.resources[i].isOptional == desc.resources[i].isOptional);
+		}
+	}
+}
+
+
+NRD_TEST(MergedLayoutOrder)
+{
+	// Required slots member by member, then the trailing optional inputs member by member
+	static const int MEMBERS[] = { REBLUR_DIFFUSE, REBLUR_SPECULAR, SIGMA_SHADOW };
+	static const ResourceSlotDesc EXPECTED[] = {
+		{ nrd::ResourceType::IN_MV, false, false },
+		{ nrd::ResourceType::IN_NORMAL_ROUGHNESS, false, false },
+		{ nrd::ResourceType::IN_BASECOLOR_METALNESS, false, true },
+		{ nrd::ResourceType::IN_VIEWZ, false, false },
+		{ nrd::ResourceType::IN_DIFF_RADIANCE_HITDIST, false, false },
+		{ nrd::ResourceType::OUT_DIFF_RADIANCE_HITDIST, true, false },
+		{ nrd::ResourceType::IN_SPEC_RADIANCE_HITDIST, false, false },
+		{ nrd::ResourceType::OUT_SPEC_RADIANCE_HITDIST, true, false },
+		{ nrd::ResourceType::IN_PENUMBRA, false, false },
+		{ nrd::ResourceType::OUT_SHADOW_TRANSLUCENCY, true, false },
+		{ nrd::ResourceType::IN_DIFF_CONFIDENCE, false, true },
+		{ nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX, false, true },
+		{ nrd::ResourceType::IN_SPEC_CONFIDENCE, false, true },
+	};
+	static const int EXPECTED_COUNT = sizeof(EXPECTED) / sizeof(EXPECTED[0]);
+
+	DenoiserGroupLayout layout;
+	NRD_CHECK(BuildDenoiserGroupLayout(MEMBERS, 3, layout) == GroupLayoutResult::OK);
+	NRD_CHECK(layout.denoiserCount == 3);
+	for (int i = 0; i < 3; i++)
+		NRD_CHECK(layout.denoiserTypes[i] == MEMBERS[i]);
+
+	NRD_CHECK(layout.resourceCount == EXPECTED_COUNT);
+	for (int i = 0; i < EXPECTED_COUNT && i < layout.resourceCount; i++)
+	{
+		NRD_CHECK(layout.resources[i].type == EXPECTED[i].type);
+		NRD_CHECK(layout.resources[i].isOutput == EXPECTED[i].isOutput);
+		NRD_CHECK(layout.resources[i].isOptional == EXPECTED[i].isOptional);
+	}
+
+	// Member order decides the order of first appearance
+	static const int REORDERED[] = { SIGMA_SHADOW, REBLUR_DIFFUSE };
+	NRD_CHECK(BuildDenoiserGroupLayout(REORDERED, 2, layout) == GroupLayoutResult::OK);
+	NRD_CHECK(layout.resources[3].type == nrd::ResourceType::IN_PENUMBRA);
+	NRD_CHECK(layout.resources[5].type == nrd::ResourceType::IN_BASECOLOR_METALNESS);
+}
+
+
+NRD_TEST(SharedInputsAppearOnce)
+{
+	static const int MEMBERS[] = { REBLUR_DIFFUSE, REBLUR_SPECULAR, SIGMA_SHADOW };
+	DenoiserGroupLayout layout;
+	NRD_CHECK(BuildDenoiserGroupLayout(MEMBERS, 3, layout) == GroupLayoutResult::OK);
+
+	NRD_CHECK(CountType(layout, nrd::ResourceType::IN_MV) == 1);
+	NRD_CHECK(CountType(layout, nrd::ResourceType::IN_NORMAL_ROUGHNESS) == 1);
+	NRD_CHECK(CountType(layout, nrd::ResourceType::IN_VIEWZ) == 1);
+	NRD_CHECK(CountType(layout, nrd::ResourceType::IN_DISOCCLUSION_THRESHOLD_MIX) == 1);
+
+	// The shared guides are first and required
+	NRD_CHECK(layout.resources[0].type == nrd::ResourceType::IN_MV && !layout.resources[0].isOptional);
+	NRD_CHECK(layout.resources[1].type == nrd::ResourceType::IN_NORMAL_ROUGHNESS && !layout.resources[1].isOptional);
+	NRD_CHECK(layout.resources[3].type == nrd::ResourceType::IN_VIEWZ && !layout.resources[3].isOptional);
+}
+
+
+NRD_TEST(RequiredCountExcludesTrailingOptionalInputs)
+{
+	static const int MEMBERS[] = { REBLUR_DIFFUSE, REBLUR_SPECULAR, SIGMA_SHADOW };
+	DenoiserGroupLayout layout;
+	NRD_CHECK(BuildDenoiserGroupLayout(MEMBERS, 3, layout) == GroupLayoutResult::OK);
+	NRD_CHECK(GetRequiredResourceCount(layout) == 10);
+
+	int textures[13];
+	void* resources[13];
+	for (int i = 0; i < 13; i++)
+		resources[i] = &textures[i];
+
+	NRD_CHECK(ValidateLayoutResources(layout, resources, 13));
+	NRD_CHECK(ValidateLayoutResources(layout, resources, 10));
+	NRD_CHECK(!ValidateLayoutResources(layout, resources, 9));
+	NRD_CHECK(!ValidateLayoutResources(layout, resources, 14));
+
+	// Base color / metalness is optional in place; view Z is not
+	resources[2] = nullptr;
+	NRD_CHECK(ValidateLayoutResources(layout, resources, 10));
+	resources[3] = nullptr;
+	NRD_CHECK(!ValidateLayoutResources(layout, resources, 10));
+}
+
+
+NRD_TEST(IncompatibleGroupsAreRejected)
+{
+	DenoiserGroupLayout layout;
+
+	// Two members writing the same output
+	static const int SAME_OUTPUT[] = { REBLUR_DIFFUSE, (int)nrd::Denoiser::RELAX_DIFFUSE };
+	NRD_CHECK(BuildDenoiserGroupLayout(SAME_OUTPUT, 2, layout) == GroupLayoutResult::RESOURCE_CONFLICT);
+	static const int OVERLAPPING[] = { REBLUR_SPECULAR, (int)nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR };
+	NRD_CHECK(BuildDenoiserGroupLayout(OVERLAPPING, 2, layout) == GroupLayoutResult::RESOURCE_CONFLICT);
+
+	static const int DUPLICATE[] = { REBLUR_DIFFUSE, SIGMA_SHADOW, REBLUR_DIFFUSE };
+	NRD_CHECK(BuildDenoiserGroupLayout(DUPLICATE, 3, layout) == GroupLayoutResult::DUPLICATE_DENOISER_TYPE);
+
+	static const int OUT_OF_RANGE[] = { REBLUR_DIFFUSE, NRD_DENOISER_COUNT };
+	NRD_CHECK(BuildDenoiserGroupLayout(OUT_OF_RANGE, 2, layout) == GroupLayoutResult::INVALID_DENOISER_TYPE);
+	static const int NEGATIVE[] = { -1 };
+	NRD_CHECK(BuildDenoiserGroupLayout(NEGATIVE, 1, layout) == GroupLayoutResult::INVALID_DENOISER_TYPE);
+
+	static const int FIVE[] = { 0, 1, 2, 3, 4 };
+	NRD_CHECK(BuildDenoiserGroupLayout(FIVE, MAX_GROUP_DENOISERS + 1, layout) == GroupLayoutResult::TOO_MANY_DENOISERS);
+
+	NRD_CHECK(BuildDenoiserGroupLayout(FIVE, 0, layout) == GroupLayoutResult::EMPTY);
+	NRD_CHECK(BuildDenoiserGroupLayout(nullptr, 1, layout) == GroupLayoutResult::EMPTY);
+
+	// 15 + 4 + 4 + 3 distinct slots
+	static const int LARGE[] = {
+		(int)nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_SH,
+		(int)nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION,
+		(int)nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR,
+		(int)nrd::Denoiser::SIGMA_SHADOW_TRANSLUCENCY,
+	};
+	NRD_CHECK(BuildDenoiserGroupLayout(LARGE, 4, layout) == GroupLayoutResult::TOO_MANY_RESOURCES);
+	NRD_CHECK(BuildDenoiserGroupLayout(LARGE, 3, layout) == GroupLayoutResult::OK);
+	NRD_CHECK(layout.resourceCount == 23);
+}
@@ -0,0 +1,197 @@
+#include "NRDTest.h"
+#include "NRDTestFence.h"
+
+#include "NRDDescriptorArena.h"
+
+
+NRD_TEST(AllocatesContiguously)
+{
+	FakeFenceSource fences;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(100);
+
+	NRD_CHECK(arena.Allocate(10) == 0);
+	NRD_CHECK(arena.Allocate(5) == 10);
+	NRD_CHECK(arena.Allocate(1) == 15);
+	NRD_CHECK(arena.GetOccupancy() == 16);
+	NRD_CHECK(arena.GetHighWaterMark() == 16);
+
+	NRD_CHECK(arena.Allocate(0) == -1);
+	NRD_CHECK(arena.Allocate(101) == -1);
+	NRD_CHECK(arena.GetFailedAllocationCount() == 2);
+}
+
+
+NRD_TEST(FrameIsRecycledOnlyAfterItsFence)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(100);
+
+	arena.Allocate(40);
+	arena.EndFrame(&fence, 1);
+	arena.Allocate(30);
+	arena.EndFrame(&fence, 2);
+
+	NRD_CHECK(arena.Collect() == 0);
+	NRD_CHECK(arena.GetOccupancy() == 70);
+
+	fence = 1;
+	NRD_CHECK(arena.Collect() == 1);
+	NRD_CHECK(arena.GetOccupancy() == 30);
+
+	fence = 2;
+	NRD_CHECK(arena.Collect() == 1);
+	NRD_CHECK(arena.GetOccupancy() == 0);
+
+	// Empty ring starts over at index 0
+	NRD_CHECK(arena.Allocate(8) == 0);
+	NRD_CHECK(arena.GetHighWaterMark() == 70);
+}
+
+
+NRD_TEST(FullHeapFailsUntilFenceCompletes)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(64);
+
+	NRD_CHECK(arena.Allocate(64) == 0);
+	arena.EndFrame(&fence, 5);
+
+	NRD_CHECK(arena.Allocate(1) == -1);
+	NRD_CHECK(arena.GetFailedAllocationCount() == 1);
+
+	// Allocate collects completed frames by itself
+	fence = 5;
+	NRD_CHECK(arena.Allocate(64) == 0);
+	NRD_CHECK(fences.waitCount == 0);
+}
+
+
+NRD_TEST(WrapSkipsTheTailAsPadding)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(100);
+
+	arena.Allocate(60);
+	arena.EndFrame(&fence, 1);
+	NRD_CHECK(arena.Allocate(30) == 60);
+	arena.EndFrame(&fence, 2);
+
+	fence = 1;
+
+	// 10 left before the end: a block of 20 doesn't straddle it, it starts at 0 and the tail is padding
+	NRD_CHECK(arena.Allocate(20) == 0);
+	NRD_CHECK(arena.GetOccupancy() == 30 + 10 + 20);
+	arena.EndFrame(&fence, 3);
+
+	// The padding is given back with the frame that skipped it
+	fence = 2;
+	arena.Collect();
+	NRD_CHECK(arena.GetOccupancy() == 30);
+	fence = 3;
+	arena.Collect();
+	NRD_CHECK(arena.GetOccupancy() == 0);
+}
+
+
+NRD_TEST(FramesRecycleInCloseOrderAcrossFences)
+{
+	// A frame closed against the compute fence holds back later graphics frames until it completes
+	FakeFenceSource fences;
+	uint64_t graphics = 0;
+	uint64_t compute = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(100);
+
+	arena.Allocate(10);
+	arena.EndFrame(&compute, 1);
+	arena.Allocate(20);
+	arena.EndFrame(&graphics, 1);
+
+	graphics = 1;
+	NRD_CHECK(arena.Collect() == 0);
+	NRD_CHECK(arena.GetOccupancy() == 30);
+
+	compute = 1;
+	NRD_CHECK(arena.Collect() == 2);
+	NRD_CHECK(arena.GetOccupancy() == 0);
+}
+
+
+NRD_TEST(EmptyFrameIsNotRecorded)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(100);
+
+	for (int i = 0; i < 4 * NRD_DESCRIPTOR_ARENA_MAX_FRAMES; i++)
+		arena.EndFrame(&fence, i + 1);
+
+	NRD_CHECK(arena.GetForcedWaitCount() == 0);
+	NRD_CHECK(arena.Collect() == 0);
+}
+
+
+NRD_TEST(TooManyFramesInFlightWaitsForTheOldest)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(1000);
+
+	for (int i = 0; i < NRD_DESCRIPTOR_ARENA_MAX_FRAMES; i++)
+	{
+		arena.Allocate(10);
+		arena.EndFrame(&fence, i + 1);
+	}
+	NRD_CHECK(fences.waitCount == 0);
+
+	arena.Allocate(10);
+	arena.EndFrame(&fence, NRD_DESCRIPTOR_ARENA_MAX_FRAMES + 1);
+	NRD_CHECK(arena.GetForcedWaitCount() == 1);
+	NRD_CHECK(fences.waitCount == 1);
+	NRD_CHECK(fence == 1);
+	NRD_CHECK(arena.GetOccupancy() == NRD_DESCRIPTOR_ARENA_MAX_FRAMES * 10);
+}
+
+
+NRD_TEST(NullFenceCompletesImmediately)
+{
+	NRDDescriptorArena arena;
+	arena.Reset(10);
+
+	arena.Allocate(10);
+	arena.EndFrame(nullptr, 0);
+	NRD_CHECK(arena.Allocate(10) == 0);
+}
+
+
+NRD_TEST(ResetForgetsEverything)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDDescriptorArena arena;
+	arena.SetFenceSource(&fences);
+	arena.Reset(50);
+
+	arena.Allocate(30);
+	arena.EndFrame(&fence, 1);
+	arena.Reset(80);
+	NRD_CHECK(arena.GetOccupancy() == 0);
+	NRD_CHECK(arena.GetCapacity() == 80);
+	NRD_CHECK(arena.Allocate(80) == 0);
+}
@@ -0,0 +1,181 @@
+#include "NRDTest.h"
+
+#include "NRDFrameBatcher.h"
+#include "RenderAPI.h"
+
+#include <vector>
+
+
+enum MockCall
+{
+	CALL_BEGIN_BATCH,
+	CALL_RECORD,
+	CALL_SUBMIT_BATCH,
+	CALL_DENOISE,
+	CALL_SYNC_COMPUTE
+};
+
+struct MockEntry
+{
+	MockCall call;
+	int slot;
+	int frameSlot;
+
+	bool operator==(const MockEntry& other) const
+	{
+		return call == other.call && slot == other.slot && frameSlot == other.frameSlot;
+	}
+};
+
+
+// Logs the submission-relevant calls in the order the batcher makes them
+class MockRenderAPI : public RenderAPI
+{
+public:
+	std::vector<MockEntry> log;
+
+	void ProcessDeviceEvent(UnityGfxDeviceEventType, IUnityInterfaces*) override {}
+	void ReleaseResources() override {}
+	bool NRDInitialize(int, int, int, void**, int) override { return true; }
+	void NRDDenoise(int denoiserType, int frameSlot) override { log.push_back({ CALL_DENOISE, denoiserType, frameSlot }); }
+	void NRDRelease(int) override {}
+	void SetMatrix(int, float[16], float[16], float) override {}
+
+	void NRDBeginBatch() override { log.push_back({ CALL_BEGIN_BATCH, -1, -1 }); }
+	void NRDRecord(int denoiserType, int frameSlot) override { log.push_back({ CALL_RECORD, denoiserType, frameSlot }); }
+	void NRDSubmitBatch() override { log.push_back({ CALL_SUBMIT_BATCH, -1, -1 }); }
+	void NRDSyncAsyncCompute() override { log.push_back({ CALL_SYNC_COMPUTE, -1, -1 }); }
+};
+
+
+static bool LogEquals(const MockRenderAPI& api, const std::vector<MockEntry>& expected)
+{
+	return api.log == expected;
+}
+
+
+NRD_TEST(FlushSubmitsBatchInIssueOrder)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(3, 1);
+	batcher.Enqueue(0, 1);
+	batcher.Enqueue(3, 1); // Already queued
+	NRD_CHECK(batcher.GetPendingCount() == 2);
+	NRD_CHECK(api.log.empty());
+
+	NRD_CHECK(batcher.Flush() == 2);
+	NRD_CHECK(LogEquals(api, { { CALL_BEGIN_BATCH, -1, -1 }, { CALL_RECORD, 3, 1 }, { CALL_RECORD, 0, 1 }, { CALL_SUBMIT_BATCH, -1, -1 } }));
+	NRD_CHECK(batcher.GetPendingCount() == 0);
+
+	// Nothing pending — no empty batch
+	NRD_CHECK(batcher.Flush() == 0);
+	NRD_CHECK(api.log.size() == 4);
+}
+
+
+NRD_TEST(ImmediateExecuteSubmitsPendingBatchFirst)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(1, 2);
+	batcher.Enqueue(2, 2);
+	batcher.Execute(5, 2);
+
+	NRD_CHECK(LogEquals(api, { { CALL_BEGIN_BATCH, -1, -1 }, { CALL_RECORD, 1, 2 }, { CALL_RECORD, 2, 2 }, { CALL_SUBMIT_BATCH, -1, -1 },
+		{ CALL_DENOISE, 5, 2 } }));
+	NRD_CHECK(batcher.GetPendingCount() == 0);
+
+	// A later flush event has nothing left to submit
+	NRD_CHECK(batcher.Flush() == 0);
+	NRD_CHECK(api.log.size() == 5);
+}
+
+
+NRD_TEST(ImmediateExecuteWithoutBatch)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Execute(4, 0);
+	batcher.Execute(4, 1);
+
+	NRD_CHECK(LogEquals(api, { { CALL_DENOISE, 4, 0 }, { CALL_DENOISE, 4, 1 } }));
+}
+
+
+NRD_TEST(SyncComputeSubmitsPendingBatchFirst)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(7, 3);
+	batcher.SyncAsyncCompute();
+
+	NRD_CHECK(LogEquals(api, { { CALL_BEGIN_BATCH, -1, -1 }, { CALL_RECORD, 7, 3 }, { CALL_SUBMIT_BATCH, -1, -1 }, { CALL_SYNC_COMPUTE, -1, -1 } }));
+}
+
+
+NRD_TEST(NewFrameSlotSubmitsPreviousBatch)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(1, 0);
+	batcher.Enqueue(1, 1);
+
+	NRD_CHECK(LogEquals(api, { { CALL_BEGIN_BATCH, -1, -1 }, { CALL_RECORD, 1, 0 }, { CALL_SUBMIT_BATCH, -1, -1 } }));
+	NRD_CHECK(batcher.GetPendingCount() == 1);
+	NRD_CHECK(batcher.GetPendingFrameSlot() == 1);
+}
+
+
+NRD_TEST(RemovedSlotIsNotRecorded)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(1, 0);
+	batcher.Enqueue(2, 0);
+	batcher.Enqueue(3, 0);
+	batcher.Remove(2);
+	batcher.Flush();
+
+	NRD_CHECK(LogEquals(api, { { CALL_BEGIN_BATCH, -1, -1 }, { CALL_RECORD, 1, 0 }, { CALL_RECORD, 3, 0 }, { CALL_SUBMIT_BATCH, -1, -1 } }));
+}
+
+
+NRD_TEST(OutOfRangeSlotsAreIgnored)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(-1, 0);
+	batcher.Enqueue(NRD_SLOT_COUNT, 0);
+	NRD_CHECK(batcher.GetPendingCount() == 0);
+	NRD_CHECK(batcher.Flush() == 0);
+	NRD_CHECK(api.log.empty());
+}
+
+
+NRD_TEST(ChangingBackendDropsPendingBatch)
+{
+	MockRenderAPI api;
+	NRDFrameBatcher batcher;
+	batcher.SetRenderAPI(&api);
+
+	batcher.Enqueue(1, 0);
+	batcher.SetRenderAPI(nullptr);
+	batcher.Execute(2, 0);
+	NRD_CHECK(batcher.Flush() == 0);
+	NRD_CHECK(api.log.empty());
+}
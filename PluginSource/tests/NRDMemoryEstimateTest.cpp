@@ -0,0 +1,190 @@
+#include "NRDTest.h"
+
+#include "NRDDenoiserConfig.h"
+#include "NRDMemoryEstimate.h"
+
+#include <vector>
+
+#ifndef NRD_CALL
+#define NRD_CALL
+#endif
+
+
+// Stand-in for NRD's instance description, so the estimate can be checked against sums worked
+// out by hand. Each denoiser has a scripted pool; like NRD, an instance keeps every member's
+// permanent textures and shares one transient pool, as large as the largest member's.
+struct FakeDenoiserPools
+{
+	std::vector<nrd::TextureDesc> permanent;
+	std::vector<nrd::TextureDesc> transient;
+	nrd::DescriptorPoolDesc limits;
+	uint32_t constantBufferSize;
+};
+
+static FakeDenoiserPools GetFakePools(nrd::Denoiser denoiser)
+{
+	FakeDenoiserPools pools = {};
+	if (denoiser == nrd::Denoiser::SIGMA_SHADOW)
+	{
+		pools.permanent = { { nrd::Format::RG16_SFLOAT, 1 } };
+		pools.transient = { { nrd::Format::RGBA8_UNORM, 1 }, { nrd::Format::RGBA8_UNORM, 1 }, { nrd::Format::R16_SFLOAT, 16 } };
+		pools.limits = { 10, 10, 4, 60, 20 };
+		pools.constantBufferSize = 600;
+	}
+	else
+	{
+		pools.permanent = {
+			{ nrd::Format::RGBA16_SFLOAT, 1 }, { nrd::Format::RGBA16_SFLOAT, 1 }, { nrd::Format::RGBA16_SFLOAT, 1 },
+			{ nrd::Format::RGBA16_SFLOAT, 1 }, { nrd::Format::R16_SFLOAT, 1 }, { nrd::Format::R16_SFLOAT, 1 },
+		};
+		pools.transient = {
+			{ nrd::Format::RGBA16_SFLOAT, 1 }, { nrd::Format::RGBA16_SFLOAT, 1 }, { nrd::Format::RGBA16_SFLOAT, 1 },
+			{ nrd::Format::RGBA16_SFLOAT, 2 }, { nrd::Format::RGBA16_SFLOAT, 2 },
+		};
+		pools.limits = { 20, 20, 4, 200, 60 };
+		pools.constantBufferSize = 1000;
+	}
+
+	return pools;
+}
+
+struct FakeInstance
+{
+	std::vector<nrd::TextureDesc> permanent;
+	std::vector<nrd::TextureDesc> transient;
+	nrd::InstanceDesc desc;
+};
+
+static int s_liveInstances = 0;
+
+namespace nrd
+{
+	Result NRD_CALL CreateInstance(const InstanceCreationDesc& instanceCreationDesc, Instance*& instance)
+	{
+		if (instanceCreationDesc.denoisersNum == 0)
+			return Result::FAILURE;
+
+		FakeInstance* fake = new FakeInstance();
+		fake->desc = {};
+		for (uint32_t i = 0; i < instanceCreationDesc.denoisersNum; i++)
+		{
+			FakeDenoiserPools pools = GetFakePools(instanceCreationDesc.denoisers[i].denoiser);
+			fake->permanent.insert(fake->permanent.end(), pools.permanent.begin(), pools.permanent.end());
+			if (pools.transient.size() > fake->transient.size())
+				fake->transient = pools.transient;
+
+			DescriptorPoolDesc& limits = fake->desc.descriptorPoolDesc;
+			limits.setsMaxNum += pools.limits.setsMaxNum;
+			limits.constantBuffersMaxNum += pools.limits.constantBuffersMaxNum;
+			limits.samplersMaxNum += pools.limits.samplersMaxNum;
+			limits.texturesMaxNum += pools.limits.texturesMaxNum;
+			limits.storageTexturesMaxNum += pools.limits.storageTexturesMaxNum;
+			if (pools.constantBufferSize > fake->desc.constantBufferMaxDataSize)
+				fake->desc.constantBufferMaxDataSize = pools.constantBufferSize;
+		}
+
+		fake->desc.permanentPool = fake->permanent.data();
+		fake->desc.permanentPoolSize = (uint32_t)fake->permanent.size();
+		fake->desc.transientPool = fake->transient.data();
+		fake->desc.transientPoolSize = (uint32_t)fake->transient.size();
+
+		s_liveInstances++;
+		instance = (Instance*)fake;
+		return Result::SUCCESS;
+	}
+
+	const InstanceDesc* NRD_CALL GetInstanceDesc(const Instance& instance)
+	{
+		return &((const FakeInstance&)instance).desc;
+	}
+
+	void NRD_CALL DestroyInstance(Instance& instance)
+	{
+		s_liveInstances--;
+		delete (FakeInstance*)&instance;
+	}
+}
+
+
+static const uint64_t KB64 = 64 * 1024;
+
+// 1920 x 1080 textures rounded to the 64 KB placement alignment
+static const uint64_t FULL_RGBA16 = 254 * KB64; // 16,588,800 bytes
+static const uint64_t FULL_R16 = 64 * KB64;     // 4,147,200 bytes
+static const uint64_t FULL_RG16 = 127 * KB64;   // 8,294,400 bytes
+static const uint64_t FULL_RGBA8 = FULL_RG16;
+static const uint64_t HALF_RGBA16 = FULL_R16;   // 960 x 540 x 8
+static const uint64_t TILES_R16 = KB64;         // 120 x 68 x 2
+
+static const int REBLUR_DIFFUSE = (int)nrd::Denoiser::REBLUR_DIFFUSE;
+static const int SIGMA_SHADOW = (int)nrd::Denoiser::SIGMA_SHADOW;
+
+
+static NRDMemoryFootprint Estimate(const int* denoiserTypes, int denoiserCount, int width = 1920, int height = 1080)
+{
+	NRDMemoryFootprint footprint;
+	NRD_CHECK(EstimateDenoiserMemory(denoiserTypes, denoiserCount, width, height, NRD_ESTIMATE_QUEUED_FRAMES, NRD_TYPICAL_DESCRIPTOR_SIZE, footprint));
+	return footprint;
+}
+
+
+NRD_TEST(ReblurFootprint)
+{
+	NRDMemoryFootprint footprint = Estimate(&REBLUR_DIFFUSE, 1);
+	NRD_CHECK(footprint.permanentBytes == 4 * FULL_RGBA16 + 2 * FULL_R16);
+	NRD_CHECK(footprint.transientBytes == 3 * FULL_RGBA16 + 2 * HALF_RGBA16);
+
+	// (20 + 200 + 60) descriptors and 20 constant views of 1024 bytes, three frames each
+	NRD_CHECK(footprint.descriptorBytes == 280 * NRD_TYPICAL_DESCRIPTOR_SIZE * 3);
+	NRD_CHECK(footprint.uploadBytes == 1024 * 20 * 3);
+	NRD_CHECK(s_liveInstances == 0);
+}
+
+
+NRD_TEST(SigmaFootprint)
+{
+	NRDMemoryFootprint footprint = Estimate(&SIGMA_SHADOW, 1);
+	NRD_CHECK(footprint.permanentBytes == FULL_RG16);
+	NRD_CHECK(footprint.transientBytes == 2 * FULL_RGBA8 + TILES_R16);
+	NRD_CHECK(footprint.descriptorBytes == 90 * NRD_TYPICAL_DESCRIPTOR_SIZE * 3);
+	NRD_CHECK(footprint.uploadBytes == 768 * 10 * 3);
+}
+
+
+NRD_TEST(DownsampledTexturesRoundUp)
+{
+	// 15 x 9 at 1/16 is still one tile; every texture takes at least one 64 KB block
+	NRDMemoryFootprint footprint = Estimate(&SIGMA_SHADOW, 1, 15, 9);
+	NRD_CHECK(footprint.permanentBytes == KB64);
+	NRD_CHECK(footprint.transientBytes == 3 * KB64);
+
+	// One row past a block boundary takes another block: 2048 x 9 x 4 bytes
+	footprint = Estimate(&SIGMA_SHADOW, 1, 2048, 9);
+	NRD_CHECK(footprint.permanentBytes == 2 * KB64);
+}
+
+
+NRD_TEST(GroupIsNoLargerThanItsMembers)
+{
+	static const int MEMBERS[] = { REBLUR_DIFFUSE, SIGMA_SHADOW };
+	NRDMemoryFootprint reblur = Estimate(&REBLUR_DIFFUSE, 1);
+	NRDMemoryFootprint sigma = Estimate(&SIGMA_SHADOW, 1);
+	NRDMemoryFootprint group = Estimate(MEMBERS, 2);
+
+	NRD_CHECK(group.permanentBytes == reblur.permanentBytes + sigma.permanentBytes);
+	NRD_CHECK(group.transientBytes == reblur.transientBytes);
+	NRD_CHECK(group.transientBytes < reblur.transientBytes + sigma.transientBytes);
+	NRD_CHECK(GetFootprintTotal(group) <= GetFootprintTotal(reblur) + GetFootprintTotal(sigma));
+}
+
+
+NRD_TEST(RejectedDescriptionHasNoFootprint)
+{
+	nrd::InstanceCreationDesc instanceDesc = {};
+	NRDMemoryFootprint footprint;
+	footprint.permanentBytes = 1;
+
+	NRD_CHECK(!EstimateInstanceMemory(instanceDesc, 1920, 1080, NRD_ESTIMATE_QUEUED_FRAMES, NRD_TYPICAL_DESCRIPTOR_SIZE, footprint));
+	NRD_CHECK(GetFootprintTotal(footprint) == 0);
+	NRD_CHECK(s_liveInstances == 0);
+}
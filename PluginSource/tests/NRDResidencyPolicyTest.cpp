@@ -0,0 +1,304 @@
+#include "NRDTest.h"
+
+#include "NRDResidencyPolicy.h"
+
+#include <string.h>
+
+
+static const uint64_t MB = 1024 * 1024;
+
+
+NRD_TEST(NoPolicyEvictsNothing)
+{
+	ResidencyEntry entries[2] = {
+		{ 0, 1, 100 * MB },
+		{ 1, 2, 100 * MB },
+	};
+	int evictions[2];
+
+	NRD_CHECK(SelectEvictions(entries, 2, 1000, 0, 900 * MB, 0, evictions) == 0);
+}
+
+
+NRD_TEST(IdleInstancesAreSuspendedBySlot)
+{
+	// Slot 5 is exactly at the limit, slot 7 was used this frame
+	ResidencyEntry entries[4] = {
+		{ 9, 10, MB },
+		{ 5, 80, MB },
+		{ 3, 20, MB },
+		{ 7, 100, MB },
+	};
+	int evictions[4];
+
+	int count = SelectEvictions(entries, 4, 100, 20, 0, 0, evictions);
+	NRD_CHECK(count == 2);
+	NRD_CHECK(evictions[0] == 3);
+	NRD_CHECK(evictions[1] == 9);
+}
+
+
+NRD_TEST(PressureEvictsLeastRecentlyUsedUntilUnderBudget)
+{
+	ResidencyEntry entries[4] = {
+		{ 0, 95, 100 * MB },
+		{ 1, 90, 100 * MB },
+		{ 2, 98, 100 * MB },
+		{ 3, 90, 50 * MB },
+	};
+	int evictions[4];
+
+	// 120 MB over: slot 1 (oldest, lower slot on the tie), then slot 3
+	int count = SelectEvictions(entries, 4, 100, 0, 1120 * MB, 1000 * MB, evictions);
+	NRD_CHECK(count == 2);
+	NRD_CHECK(evictions[0] == 1);
+	NRD_CHECK(evictions[1] == 3);
+
+	// Exactly at the budget — nothing to free
+	NRD_CHECK(SelectEvictions(entries, 4, 100, 0, 1000 * MB, 1000 * MB, evictions) == 0);
+}
+
+
+NRD_TEST(IdleSuspensionsCountTowardPressure)
+{
+	ResidencyEntry entries[3] = {
+		{ 0, 10, 200 * MB },
+		{ 1, 90, 100 * MB },
+		{ 2, 95, 100 * MB },
+	};
+	int evictions[3];
+
+	// The idle slot alone frees enough
+	int count = SelectEvictions(entries, 3, 100, 50, 1150 * MB, 1000 * MB, evictions);
+	NRD_CHECK(count == 1);
+	NRD_CHECK(evictions[0] == 0);
+}
+
+
+NRD_TEST(RecentInstancesAreNeverEvicted)
+{
+	ResidencyEntry entries[3] = {
+		{ 0, 100, 500 * MB },
+		{ 1, 99, 500 * MB },
+		{ 2, 98, 500 * MB },
+	};
+	int evictions[3];
+
+	// Hopelessly over budget, but 0 ran this frame and 1 in the previous one
+	int count = SelectEvictions(entries, 3, 100, 0, 4000 * MB, 1000 * MB, evictions);
+	NRD_CHECK(count == 1);
+	NRD_CHECK(evictions[0] == 2);
+}
+
+
+NRD_TEST(OrderDoesNotDependOnInput)
+{
+	ResidencyEntry entries[5] = {
+		{ 4, 50, 10 * MB },
+		{ 1, 50, 10 * MB },
+		{ 3, 10, 10 * MB },
+		{ 0, 70, 10 * MB },
+		{ 2, 10, 10 * MB },
+	};
+	ResidencyEntry reversed[5];
+	for (int i = 0; i < 5; i++)
+		reversed[i] = entries[4 - i];
+
+	int a[5];
+	int b[5];
+	int countA = SelectEvictions(entries, 5, 100, 60, 1040 * MB, 1000 * MB, a);
+	int countB = SelectEvictions(reversed, 5, 100, 60, 1040 * MB, 1000 * MB, b);
+
+	// Idle 2 and 3 free 20 MB; pressure adds 1 and 4 (tie on frame, lower slot first) for 40 MB
+	NRD_CHECK(countA == 4);
+	NRD_CHECK(countB == countA);
+	NRD_CHECK(memcmp(a, b, sizeof(int) * countA) == 0);
+	NRD_CHECK(a[0] == 2 && a[1] == 3 && a[2] == 1 && a[3] == 4);
+}
+
+
+// Per-frame residency the way RenderAPI_D3D12::UpdateResidency drives it: a scripted set of slots
+// executes each frame, suspended slots that execute are rebuilt and rejoin a frame later (the
+// background build is swapped in by the next poll), and the policy runs once per frame over the
+// resident ones against a fixed budget.
+struct SimSlot
+{
+	uint64_t bytes;
+	bool resident;
+	bool resuming;
+	uint64_t lastUsedFrame;
+};
+
+struct SimResult
+{
+	int suspensions;
+	int resumes;
+	int skippedDispatches;
+	uint64_t peakUsage;
+	int unmetFrames; // Still over budget after eviction although an evictable instance was left resident
+	int evictionLog[256];
+	int evictionLogCount;
+};
+
+static const int SIM_SLOTS = 6;
+
+// Slot 0 and 1 run every frame; 2 every other frame; 3 and 4 in bursts; 5 only at the start
+static bool SimExecutes(int slot, uint64_t frame)
+{
+	switch (slot)
+	{
+	case 0:
+	case 1: return true;
+	case 2: return frame % 2 == 0;
+	case 3: return (frame / 40) % 2 == 0;
+	case 4: return (frame / 25) % 3 == 1;
+	default: return frame < 10;
+	}
+}
+
+static void Simulate(uint64_t frames, uint64_t idleFrames, uint64_t budget, SimResult& result)
+{
+	SimSlot slots[SIM_SLOTS];
+	for (int i = 0; i < SIM_SLOTS; i++)
+		slots[i] = { (uint64_t)(i + 1) * 40 * MB, true, false, 0 };
+
+	memset(&result, 0, sizeof(result));
+
+	for (uint64_t frame = 1; frame <= frames; frame++)
+	{
+		// Poll: rebuilds started last frame are swapped in and count as used
+		for (int i = 0; i < SIM_SLOTS; i++)
+		{
+			if (slots[i].resuming)
+			{
+				slots[i].resuming = false;
+				slots[i].resident = true;
+				slots[i].lastUsedFrame = frame;
+				result.resumes++;
+			}
+		}
+
+		// Residency, before this frame's dispatches
+		ResidencyEntry entries[SIM_SLOTS];
+		int count = 0;
+		uint64_t usage = 0;
+		for (int i = 0; i < SIM_SLOTS; i++)
+		{
+			if (!slots[i].resident)
+				continue;
+			entries[count++] = { i, slots[i].lastUsedFrame, slots[i].bytes };
+			usage += slots[i].bytes;
+		}
+
+		int evictions[SIM_SLOTS];
+		int evictionCount = SelectEvictions(entries, count, frame, idleFrames, usage, budget, evictions);
+		for (int e = 0; e < evictionCount; e++)
+		{
+			slots[evictions[e]].resident = false;
+			result.suspensions++;
+			usage -= slots[evictions[e]].bytes;
+			if (result.evictionLogCount < 256)
+				result.evictionLog[result.evictionLogCount++] = (int)(frame * SIM_SLOTS) + evictions[e];
+		}
+
+		bool evictable = false;
+		for (int i = 0; i < SIM_SLOTS; i++)
+			evictable |= slots[i].resident && slots[i].lastUsedFrame + 1 < frame;
+		if (budget != 0 && usage > budget && evictable)
+			result.unmetFrames++;
+
+		// Dispatches: a suspended slot starts its rebuild and is skipped
+		usage = 0;
+		for (int i = 0; i < SIM_SLOTS; i++)
+		{
+			if (SimExecutes(i, frame))
+			{
+				if (slots[i].resident)
+					slots[i].lastUsedFrame = frame;
+				else
+				{
+					slots[i].resuming = true;
+					result.skippedDispatches++;
+				}
+			}
+
+			if (slots[i].resident)
+				usage += slots[i].bytes;
+		}
+
+		if (usage > result.peakUsage)
+			result.peakUsage = usage;
+	}
+}
+
+
+NRD_TEST(SimulationIsDeterministic)
+{
+	SimResult a;
+	SimResult b;
+	Simulate(300, 30, 500 * MB, a);
+	Simulate(300, 30, 500 * MB, b);
+
+	NRD_CHECK(a.suspensions > 0);
+	NRD_CHECK(a.suspensions == b.suspensions);
+	NRD_CHECK(a.resumes == b.resumes);
+	NRD_CHECK(a.evictionLogCount == b.evictionLogCount);
+	NRD_CHECK(memcmp(a.evictionLog, b.evictionLog, sizeof(int) * a.evictionLogCount) == 0);
+}
+
+
+NRD_TEST(SimulationKeepsHotSlotsResident)
+{
+	SimResult result;
+	Simulate(300, 30, 500 * MB, result);
+
+	// Slots 0 and 1 run every frame, so they are never chosen
+	for (int i = 0; i < result.evictionLogCount; i++)
+	{
+		int slot = result.evictionLog[i] % SIM_SLOTS;
+		NRD_CHECK(slot != 0 && slot != 1);
+	}
+
+	// Slot 5 stops after frame 9 and is suspended for idleness once, never to come back
+	int slot5 = 0;
+	for (int i = 0; i < result.evictionLogCount; i++)
+		slot5 += result.evictionLog[i] % SIM_SLOTS == 5 ? 1 : 0;
+	NRD_CHECK(slot5 == 1);
+
+	// Every skipped dispatch started a rebuild that completed a frame later (except at the very end)
+	NRD_CHECK(result.resumes <= result.skippedDispatches);
+	NRD_CHECK(result.resumes <= result.suspensions);
+}
+
+
+NRD_TEST(SimulationWithoutBudgetOnlyDropsIdleSlots)
+{
+	SimResult result;
+	Simulate(300, 30, 0, result);
+
+	// Nothing is under pressure: 0, 1 and 2 never idle for 30 frames, so only the bursty ones go
+	for (int i = 0; i < result.evictionLogCount; i++)
+	{
+		int slot = result.evictionLog[i] % SIM_SLOTS;
+		NRD_CHECK(slot >= 3);
+	}
+	NRD_CHECK(result.peakUsage == 840 * MB);
+}
+
+
+NRD_TEST(SimulationWithTightBudgetMeetsItEveryFrame)
+{
+	// Room for little more than the every-frame slots (40 + 80 MB): the others are evicted as soon
+	// as they fall behind, and whatever stays resident fits unless it was all used a frame ago
+	SimResult result;
+	Simulate(300, 0, 200 * MB, result);
+
+	NRD_CHECK(result.suspensions > 0);
+	NRD_CHECK(result.resumes > 0);
+	NRD_CHECK(result.unmetFrames == 0);
+	for (int i = 0; i < result.evictionLogCount; i++)
+	{
+		int slot = result.evictionLog[i] % SIM_SLOTS;
+		NRD_CHECK(slot != 0 && slot != 1);
+	}
+}
@@ -0,0 +1,156 @@
+#include "NRDTest.h"
+#include "NRDTestFence.h"
+
+#include <vector>
+
+
+// A retired object that records its destruction in a shared log
+struct TrackedObject
+{
+	int id;
+	std::vector<int>* log;
+};
+
+static void DestroyTracked(void* object)
+{
+	TrackedObject* tracked = (TrackedObject*)object;
+	tracked->log->push_back(tracked->id);
+}
+
+
+NRD_TEST(CollectDestroysOnlyCompletedEntries)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	std::vector<int> log;
+	TrackedObject objects[3] = { { 0, &log }, { 1, &log }, { 2, &log } };
+	NRDRetireQueue queue;
+	queue.SetFenceSource(&fences);
+
+	queue.Retire(&fence, 2, DestroyTracked, &objects[0]);
+	queue.Retire(&fence, 1, DestroyTracked, &objects[1]);
+	queue.Retire(&fence, 3, DestroyTracked, &objects[2]);
+
+	NRD_CHECK(queue.Collect() == 0);
+	fence = 2;
+	NRD_CHECK(queue.Collect() == 2);
+	NRD_CHECK(log.size() == 2 && log[0] == 0 && log[1] == 1);
+	NRD_CHECK(queue.GetPendingCount() == 1);
+
+	fence = 3;
+	NRD_CHECK(queue.Collect() == 1);
+	NRD_CHECK(queue.GetPendingCount() == 0);
+	NRD_CHECK(fences.waitCount == 0);
+}
+
+
+NRD_TEST(UnusedObjectsGoOnNextCollect)
+{
+	FakeFenceSource fences;
+	std::vector<int> log;
+	TrackedObject never = { 7, &log };
+	TrackedObject zero = { 8, &log };
+	NRDRetireQueue queue;
+	queue.SetFenceSource(&fences);
+
+	uint64_t fence = 0;
+	queue.Retire(nullptr, 5, DestroyTracked, &never);
+	queue.Retire(&fence, 0, DestroyTracked, &zero);
+	NRD_CHECK(log.empty());
+	NRD_CHECK(queue.Collect() == 2);
+	NRD_CHECK(log.size() == 2);
+}
+
+
+NRD_TEST(FullQueueWaitsOnTheOldestEntry)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	std::vector<int> log;
+	std::vector<TrackedObject> objects(NRD_RETIRE_QUEUE_CAPACITY + 1);
+	NRDRetireQueue queue;
+	queue.SetFenceSource(&fences);
+
+	for (int i = 0; i < NRD_RETIRE_QUEUE_CAPACITY; i++)
+	{
+		objects[i] = { i, &log };
+		queue.Retire(&fence, (uint64_t)i + 1, DestroyTracked, &objects[i]);
+	}
+	NRD_CHECK(queue.GetPendingCount() == NRD_RETIRE_QUEUE_CAPACITY);
+	NRD_CHECK(queue.GetForcedWaitCount() == 0);
+
+	// One more: nothing has completed, so it blocks on entry 0 only
+	objects[NRD_RETIRE_QUEUE_CAPACITY] = { NRD_RETIRE_QUEUE_CAPACITY, &log };
+	queue.Retire(&fence, NRD_RETIRE_QUEUE_CAPACITY + 1, DestroyTracked, &objects[NRD_RETIRE_QUEUE_CAPACITY]);
+	NRD_CHECK(queue.GetForcedWaitCount() == 1);
+	NRD_CHECK(fences.waitCount == 1);
+	NRD_CHECK(fence == 1);
+	NRD_CHECK(log.size() == 1 && log[0] == 0);
+	NRD_CHECK(queue.GetPendingCount() == NRD_RETIRE_QUEUE_CAPACITY);
+
+	// A full queue that Collect can make room in needs no wait
+	fence = 10;
+	objects[0] = { 100, &log };
+	queue.Retire(&fence, 1000, DestroyTracked, &objects[0]);
+	NRD_CHECK(queue.GetForcedWaitCount() == 1);
+	NRD_CHECK(queue.GetPendingCount() == NRD_RETIRE_QUEUE_CAPACITY - 9 + 1);
+}
+
+
+NRD_TEST(MemoryStaysBoundedWhileTheGpuStalls)
+{
+	// The GPU never advances on its own and Collect is never called: every Retire past the
+	// capacity waits for exactly one entry, in retirement order
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	std::vector<int> log;
+	const int count = 1000;
+	std::vector<TrackedObject> objects(count);
+	NRDRetireQueue queue;
+	queue.SetFenceSource(&fences);
+
+	for (int i = 0; i < count; i++)
+	{
+		objects[i] = { i, &log };
+		queue.Retire(&fence, (uint64_t)i + 1, DestroyTracked, &objects[i]);
+		NRD_CHECK(queue.GetPendingCount() <= NRD_RETIRE_QUEUE_CAPACITY);
+	}
+
+	NRD_CHECK(queue.GetForcedWaitCount() == (uint64_t)(count - NRD_RETIRE_QUEUE_CAPACITY));
+	NRD_CHECK(fences.waitCount == count - NRD_RETIRE_QUEUE_CAPACITY);
+	NRD_CHECK((int)log.size() == count - NRD_RETIRE_QUEUE_CAPACITY);
+	for (int i = 0; i < (int)log.size(); i++)
+		NRD_CHECK(log[i] == i);
+}
+
+
+NRD_TEST(DrainWaitsForEveryEntryOnShutdown)
+{
+	FakeFenceSource fences;
+	uint64_t graphics = 0;
+	uint64_t compute = 5;
+	std::vector<int> log;
+	TrackedObject objects[4] = { { 0, &log }, { 1, &log }, { 2, &log }, { 3, &log } };
+	NRDRetireQueue queue;
+	queue.SetFenceSource(&fences);
+
+	queue.Retire(&graphics, 3, DestroyTracked, &objects[0]);
+	queue.Retire(&compute, 4, DestroyTracked, &objects[1]);
+	queue.Retire(&graphics, 7, DestroyTracked, &objects[2]);
+	queue.Retire(nullptr, 0, DestroyTracked, &objects[3]);
+
+	queue.Drain();
+	NRD_CHECK(queue.GetPendingCount() == 0);
+	NRD_CHECK(log.size() == 4);
+	for (int i = 0; i < 4; i++)
+		NRD_CHECK(log[i] == i);
+
+	// Only the two graphics entries were still running; a drain isn't a forced wait
+	NRD_CHECK(fences.waitCount == 2);
+	NRD_CHECK(graphics == 7);
+	NRD_CHECK(queue.GetForcedWaitCount() == 0);
+
+	// Draining an empty queue is a no-op
+	queue.Drain();
+	NRD_CHECK(fences.waitCount == 2);
+}
@@ -0,0 +1,49 @@
+#include "NRDTest.h"
+
+#include <stdio.h>
+
+
+static const int NRD_TEST_MAX = 64;
+
+struct NRDTestEntry
+{
+	const char* name;
+	NRDTestFunction function;
+};
+
+static NRDTestEntry s_tests[NRD_TEST_MAX];
+static int s_testCount = 0;
+static int s_failures = 0;
+
+
+NRDTestRegistration::NRDTestRegistration(const char* name, NRDTestFunction function)
+{
+	if (s_testCount < NRD_TEST_MAX)
+		s_tests[s_testCount++] = { name, function };
+}
+
+
+void NRDTestFail(const char* file, int line, const char* expression)
+{
+	printf("%s(%d): check failed: %s\n", file, line, expression);
+	s_failures++;
+}
+
+
+int main()
+{
+	int failedTests = 0;
+	for (int i = 0; i < s_testCount; i++)
+	{
+		int failures = s_failures;
+		s_tests[i].function();
+
+		bool passed = s_failures == failures;
+		printf("%s %s\n", passed ? "[ OK ]  " : "[ FAIL ]", s_tests[i].name);
+		if (!passed)
+			failedTests++;
+	}
+
+	printf("%d of %d tests passed\n", s_testCount - failedTests, s_testCount);
+	return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <math.h>
+
+
+// Minimal host test harness: every NRD_TEST in an executable runs in definition order (NRDTest.cpp),
+// and the executable exits non-zero if any NRD_CHECK failed.
+typedef void (*NRDTestFunction)();
+
+struct NRDTestRegistration
+{
+	NRDTestRegistration(const char* name, NRDTestFunction function);
+};
+
+void NRDTestFail(const char* file, int line, const char* expression);
+
+
+#define NRD_TEST(name) \
+	static void name(); \
+	static NRDTestRegistration s_register_##name(#name, name); \
+	static void name()
+
+#define NRD_CHECK(expression) \
+	do { if (!(expression)) NRDTestFail(__FILE__, __LINE__, #expression); } while (0)
+
+#define NRD_CHECK_NEAR(a, b, tolerance) \
+	NRD_CHECK(fabs((double)(a) - (double)(b)) <= (double)(tolerance))
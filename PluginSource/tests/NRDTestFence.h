@@ -0,0 +1,24 @@
+#pragma once
+
+#include "NRDRetireQueue.h"
+
+
+// GPU stand-in for the fence-driven allocators: a fence is a uint64_t the test advances by hand.
+// A wait completes the fence at once, as if the GPU had caught up.
+class FakeFenceSource : public RetireFenceSource
+{
+public:
+	int waitCount = 0;
+
+	uint64_t GetCompletedValue(void* fence) override
+	{
+		return *(uint64_t*)fence;
+	}
+
+	void WaitForValue(void* fence, uint64_t value) override
+	{
+		waitCount++;
+		if (*(uint64_t*)fence < value)
+			*(uint64_t*)fence = value;
+	}
+};
@@ -0,0 +1,231 @@
+#include "NRDTest.h"
+#include "NRDTestFence.h"
+
+#include "NRDUploadRing.h"
+
+#include <vector>
+
+
+static const uint64_t CB_ALIGNMENT = 256; // D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+
+
+NRD_TEST(AllocationsAreAligned)
+{
+	FakeFenceSource fences;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(4096);
+
+	NRD_CHECK(ring.Allocate(100, CB_ALIGNMENT) == 0);
+	NRD_CHECK(ring.Allocate(100, CB_ALIGNMENT) == 256);
+	NRD_CHECK(ring.Allocate(4, 1) == 356);
+	NRD_CHECK(ring.Allocate(8, 8) == 360);
+	NRD_CHECK(ring.GetBytesAllocated() == 212);
+	NRD_CHECK(ring.GetOccupancy() == 368);
+
+	NRD_CHECK(ring.Allocate(0, CB_ALIGNMENT) == NRD_UPLOAD_RING_FULL);
+}
+
+
+NRD_TEST(SubmissionIsReclaimedOnlyAfterItsFence)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(1024);
+
+	ring.Allocate(512, CB_ALIGNMENT);
+	ring.EndSubmission(&fence, 1);
+	ring.Allocate(256, CB_ALIGNMENT);
+	ring.EndSubmission(&fence, 2);
+	NRD_CHECK(ring.GetPendingSubmissionCount() == 2);
+
+	// 256 bytes left: the 512 of submission 1 are still in flight
+	NRD_CHECK(ring.Allocate(512, CB_ALIGNMENT) == NRD_UPLOAD_RING_FULL);
+
+	fence = 1;
+	NRD_CHECK(ring.Collect() == 1);
+	NRD_CHECK(ring.GetOccupancy() == 256);
+	NRD_CHECK(ring.GetPendingSubmissionCount() == 1);
+
+	void* pendingFence = nullptr;
+	uint64_t pendingValue = 0;
+	ring.GetPendingSubmission(0, &pendingFence, &pendingValue);
+	NRD_CHECK(pendingFence == &fence);
+	NRD_CHECK(pendingValue == 2);
+
+	fence = 2;
+	NRD_CHECK(ring.Collect() == 1);
+	NRD_CHECK(ring.GetOccupancy() == 0);
+	NRD_CHECK(ring.Allocate(1024, CB_ALIGNMENT) == 0);
+}
+
+
+NRD_TEST(WrapSkipsTheTailAsPadding)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(1024);
+
+	ring.Allocate(512, CB_ALIGNMENT);
+	ring.EndSubmission(&fence, 1);
+	NRD_CHECK(ring.Allocate(256, CB_ALIGNMENT) == 512);
+	ring.EndSubmission(&fence, 2);
+
+	fence = 1;
+
+	// 256 bytes before the end aren't enough — the allocation wraps to 0 and the tail is padding
+	NRD_CHECK(ring.Allocate(300, CB_ALIGNMENT) == 0);
+	NRD_CHECK(ring.GetOccupancy() == 256 + 256 + 300);
+
+	// The next aligned offset is 512 — submission 2's bytes — so nothing more fits
+	NRD_CHECK(ring.Allocate(1, CB_ALIGNMENT) == NRD_UPLOAD_RING_FULL);
+	NRD_CHECK(ring.Allocate(212, 4) == 300);
+	NRD_CHECK(ring.Allocate(4, 4) == NRD_UPLOAD_RING_FULL);
+	ring.EndSubmission(&fence, 3);
+
+	fence = 3;
+	ring.Collect();
+	NRD_CHECK(ring.GetOccupancy() == 0);
+	NRD_CHECK(ring.GetHighWaterMark() == 1024);
+}
+
+
+NRD_TEST(GrowDoublesUntilTheRequestFits)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(1024);
+
+	ring.Allocate(768, CB_ALIGNMENT);
+	ring.EndSubmission(&fence, 1);
+	NRD_CHECK(ring.Allocate(512, CB_ALIGNMENT) == NRD_UPLOAD_RING_FULL);
+
+	// The backend retires the old buffer against the pending submissions, then grows
+	NRD_CHECK(ring.GetPendingSubmissionCount() == 1);
+	ring.Grow(512, CB_ALIGNMENT);
+	NRD_CHECK(ring.GetCapacity() == 2048);
+	NRD_CHECK(ring.GetGrowCount() == 1);
+	NRD_CHECK(ring.GetPendingSubmissionCount() == 0);
+	NRD_CHECK(ring.GetOccupancy() == 0);
+	NRD_CHECK(ring.Allocate(512, CB_ALIGNMENT) == 0);
+
+	// A request larger than twice the size keeps doubling
+	ring.Grow(10000, CB_ALIGNMENT);
+	NRD_CHECK(ring.GetCapacity() == 16384);
+	NRD_CHECK(ring.Allocate(10000, CB_ALIGNMENT) == 0);
+
+	// From an empty ring
+	NRDUploadRing empty;
+	NRD_CHECK(empty.Allocate(64, CB_ALIGNMENT) == NRD_UPLOAD_RING_FULL);
+	empty.Grow(64, CB_ALIGNMENT);
+	NRD_CHECK(empty.GetCapacity() >= 64 + CB_ALIGNMENT);
+	NRD_CHECK(empty.Allocate(64, CB_ALIGNMENT) == 0);
+}
+
+
+NRD_TEST(TooManySubmissionsInFlightWaitsForTheOldest)
+{
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(1 << 20);
+
+	for (int i = 0; i < NRD_UPLOAD_RING_MAX_SUBMISSIONS; i++)
+	{
+		ring.Allocate(256, CB_ALIGNMENT);
+		ring.EndSubmission(&fence, i + 1);
+	}
+	NRD_CHECK(ring.GetForcedWaitCount() == 0);
+
+	ring.Allocate(256, CB_ALIGNMENT);
+	ring.EndSubmission(&fence, NRD_UPLOAD_RING_MAX_SUBMISSIONS + 1);
+	NRD_CHECK(ring.GetForcedWaitCount() == 1);
+	NRD_CHECK(fences.waitCount == 1);
+	NRD_CHECK(fence == 1);
+	NRD_CHECK(ring.GetPendingSubmissionCount() == NRD_UPLOAD_RING_MAX_SUBMISSIONS);
+
+	// Nothing allocated — nothing to close
+	ring.EndSubmission(&fence, 100);
+	NRD_CHECK(ring.GetPendingSubmissionCount() == NRD_UPLOAD_RING_MAX_SUBMISSIONS);
+}
+
+
+// Deterministic simulation of the backend: random constant uploads per submission, a GPU that
+// lags a few submissions behind, and growth when the ring is full. No two allocations the GPU may
+// still read may share a byte.
+NRD_TEST(SimulatedFramesNeverOverlapInFlightBytes)
+{
+	struct Live
+	{
+		uint64_t begin;
+		uint64_t end;
+		uint64_t fenceValue;
+		uint64_t generation; // Buffer the bytes belong to
+	};
+
+	FakeFenceSource fences;
+	uint64_t fence = 0;
+	NRDUploadRing ring;
+	ring.SetFenceSource(&fences);
+	ring.Reset(4096);
+
+	std::vector<Live> live;
+	uint64_t generation = 0;
+	uint32_t state = 777;
+	auto next = [&state](uint32_t range)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) % range;
+	};
+
+	bool disjoint = true;
+	bool aligned = true;
+	for (uint64_t submission = 1; submission <= 2000; submission++)
+	{
+		int uploads = 1 + (int)next(6);
+		for (int u = 0; u < uploads; u++)
+		{
+			uint64_t size = 16 + next(1024);
+			uint64_t offset = ring.Allocate(size, CB_ALIGNMENT);
+			if (offset == NRD_UPLOAD_RING_FULL)
+			{
+				ring.Grow(size, CB_ALIGNMENT);
+				generation++;
+				offset = ring.Allocate(size, CB_ALIGNMENT);
+			}
+
+			aligned = aligned && offset != NRD_UPLOAD_RING_FULL && offset % CB_ALIGNMENT == 0 && offset + size <= ring.GetCapacity();
+			for (const Live& other : live)
+			{
+				if (other.generation == generation && other.fenceValue > fence && offset < other.end && other.begin < offset + size)
+					disjoint = false;
+			}
+			live.push_back({ offset, offset + size, submission, generation });
+		}
+
+		ring.EndSubmission(&fence, submission);
+
+		// The GPU completes up to three submissions behind, sometimes stalling
+		if (next(4) != 0 && fence + 3 < submission)
+			fence = submission - 3;
+
+		size_t write = 0;
+		for (size_t i = 0; i < live.size(); i++)
+		{
+			if (live[i].fenceValue > fence)
+				live[write++] = live[i];
+		}
+		live.resize(write);
+	}
+
+	NRD_CHECK(disjoint);
+	NRD_CHECK(aligned);
+	NRD_CHECK(ring.GetCapacity() <= 32768);
+}
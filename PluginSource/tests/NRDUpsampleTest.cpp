@@ -0,0 +1,203 @@
+#include "NRDTest.h"
+
+#include "NRDUpsample.h"
+
+#include <math.h>
+#include <vector>
+
+
+// A 2x reduced image pair: 4x3 reduced, 8x6 full resolution
+static const int LOW_WIDTH = 4;
+static const int LOW_HEIGHT = 3;
+static const int DIVISOR = 2;
+static const int WIDTH = LOW_WIDTH * DIVISOR;
+static const int HEIGHT = LOW_HEIGHT * DIVISOR;
+
+struct UpsampleImages
+{
+	std::vector<float> lowValue = std::vector<float>(LOW_WIDTH * LOW_HEIGHT * 4, 0.0f);
+	std::vector<float> lowViewZ = std::vector<float>(LOW_WIDTH * LOW_HEIGHT, 10.0f);
+	std::vector<float> lowNormal = std::vector<float>(LOW_WIDTH * LOW_HEIGHT * 3, 0.0f);
+	std::vector<float> viewZ = std::vector<float>(WIDTH * HEIGHT, 10.0f);
+	std::vector<float> normal = std::vector<float>(WIDTH * HEIGHT * 3, 0.0f);
+	std::vector<float> result = std::vector<float>(WIDTH * HEIGHT * 4, 0.0f);
+
+	// Every normal +Z
+	UpsampleImages()
+	{
+		for (int i = 0; i < LOW_WIDTH * LOW_HEIGHT; i++)
+			lowNormal[i * 3 + 2] = 1.0f;
+		for (int i = 0; i < WIDTH * HEIGHT; i++)
+			normal[i * 3 + 2] = 1.0f;
+	}
+
+	void Run(bool withNormals)
+	{
+		UpsampleImage(lowValue.data(), lowViewZ.data(), withNormals ? lowNormal.data() : nullptr, LOW_WIDTH, LOW_HEIGHT,
+			viewZ.data(), withNormals ? normal.data() : nullptr, WIDTH, HEIGHT, DIVISOR, result.data());
+	}
+
+	float Result(int x, int y, int channel = 0) const
+	{
+		return result[(y * WIDTH + x) * 4 + channel];
+	}
+};
+
+
+NRD_TEST(ConstantImageStaysConstant)
+{
+	UpsampleImages images;
+	for (size_t i = 0; i < images.lowValue.size(); i++)
+		images.lowValue[i] = 0.7f;
+
+	images.Run(true);
+	for (size_t i = 0; i < images.result.size(); i++)
+		NRD_CHECK_NEAR(images.result[i], 0.7f, 1e-6f);
+}
+
+
+NRD_TEST(DepthEdgeIsNotBlurred)
+{
+	// Left half near (view Z 1, value 0), right half far (view Z 100, value 1)
+	UpsampleImages images;
+	for (int y = 0; y < LOW_HEIGHT; y++)
+	{
+		for (int x = 0; x < LOW_WIDTH; x++)
+		{
+			bool far = x >= LOW_WIDTH / 2;
+			images.lowViewZ[y * LOW_WIDTH + x] = far ? 100.0f : 1.0f;
+			for (int c = 0; c < 4; c++)
+				images.lowValue[(y * LOW_WIDTH + x) * 4 + c] = far ? 1.0f : 0.0f;
+		}
+	}
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		for (int x = 0; x < WIDTH; x++)
+			images.viewZ[y * WIDTH + x] = x >= WIDTH / 2 ? 100.0f : 1.0f;
+	}
+
+	images.Run(true);
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		for (int x = 0; x < WIDTH; x++)
+			NRD_CHECK_NEAR(images.Result(x, y), x >= WIDTH / 2 ? 1.0f : 0.0f, 1e-3f);
+	}
+
+	// Depth weights alone keep the edge too
+	images.Run(false);
+	NRD_CHECK_NEAR(images.Result(WIDTH / 2 - 1, 0), 0.0f, 1e-3f);
+	NRD_CHECK_NEAR(images.Result(WIDTH / 2, 0), 1.0f, 1e-3f);
+}
+
+
+NRD_TEST(FlatSurfaceIsBilinear)
+{
+	// A ramp in x at one depth: every weight but the bilinear one is 1
+	UpsampleImages images;
+	for (int y = 0; y < LOW_HEIGHT; y++)
+	{
+		for (int x = 0; x < LOW_WIDTH; x++)
+			images.lowValue[(y * LOW_WIDTH + x) * 4] = (float)x;
+	}
+
+	images.Run(true);
+
+	// Pixel x sits at (x + 0.5) / 2 - 0.5 in reduced texels; the border clamps
+	NRD_CHECK_NEAR(images.Result(0, 2), 0.0f, 1e-5f);
+	NRD_CHECK_NEAR(images.Result(1, 2), 0.25f, 1e-5f);
+	NRD_CHECK_NEAR(images.Result(2, 2), 0.75f, 1e-5f);
+	NRD_CHECK_NEAR(images.Result(3, 2), 1.25f, 1e-5f);
+	NRD_CHECK_NEAR(images.Result(WIDTH - 1, 2), 3.0f, 1e-5f);
+}
+
+
+NRD_TEST(FootprintWeightsAndClamping)
+{
+	int taps[4][2];
+	float weights[4];
+
+	// Interior: (1.25, 0.75) in reduced texels
+	GetUpsampleFootprint(3, 2, 2, LOW_WIDTH, LOW_HEIGHT, taps, weights);
+	NRD_CHECK(taps[0][0] == 1 && taps[0][1] == 0);
+	NRD_CHECK(taps[3][0] == 2 && taps[3][1] == 1);
+	NRD_CHECK_NEAR(weights[0], 0.75f * 0.25f, 1e-6f);
+	NRD_CHECK_NEAR(weights[1], 0.25f * 0.25f, 1e-6f);
+	NRD_CHECK_NEAR(weights[2], 0.75f * 0.75f, 1e-6f);
+	NRD_CHECK_NEAR(weights[3], 0.25f * 0.75f, 1e-6f);
+
+	// Top-left corner: the taps before the first texel clamp onto it
+	GetUpsampleFootprint(0, 0, 2, LOW_WIDTH, LOW_HEIGHT, taps, weights);
+	for (int i = 0; i < 4; i++)
+		NRD_CHECK(taps[i][0] >= 0 && taps[i][0] < LOW_WIDTH && taps[i][1] >= 0 && taps[i][1] < LOW_HEIGHT);
+	NRD_CHECK(taps[0][0] == 0 && taps[0][1] == 0);
+	NRD_CHECK_NEAR(weights[0] + weights[1] + weights[2] + weights[3], 1.0f, 1e-6f);
+}
+
+
+NRD_TEST(RejectedTapsFallBackToClosestDepth)
+{
+	NRDUpsampleTexel texel = {};
+	texel.viewZ = 1.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		texel.tapWeight[i] = 0.25f;
+		texel.tapViewZ[i] = 50.0f + (float)i;
+		texel.tapValue[i][0] = (float)i;
+	}
+	texel.tapViewZ[2] = 20.0f;
+
+	float result[4];
+	EvaluateUpsample(texel, result);
+	NRD_CHECK(result[0] == 2.0f);
+}
+
+
+NRD_TEST(NormalsRejectOtherSurfaces)
+{
+	// Taps 0 and 1 face +Z like the pixel, taps 2 and 3 face +X
+	NRDUpsampleTexel texel = {};
+	texel.viewZ = 5.0f;
+	texel.hasNormal = 1;
+	texel.normal[2] = 1.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		texel.tapWeight[i] = 0.25f;
+		texel.tapViewZ[i] = 5.0f;
+		texel.tapValue[i][0] = (float)i;
+		texel.tapNormal[i][i < 2 ? 2 : 0] = 1.0f;
+	}
+
+	float result[4];
+	EvaluateUpsample(texel, result);
+	NRD_CHECK_NEAR(result[0], 0.5f, 1e-6f);
+
+	// Without normals all four count
+	texel.hasNormal = 0;
+	EvaluateUpsample(texel, result);
+	NRD_CHECK_NEAR(result[0], 1.5f, 1e-6f);
+}
+
+
+NRD_TEST(DownsamplePicksNearestTexel)
+{
+	static const float VIEW_Z[4 * 4] = {
+		5, 4, 9, 9,
+		3, 6, 9, 1,
+		9, 9, 9, 9,
+		9, 9, 9, 2,
+	};
+	int texel[2];
+
+	GetDownsampleTexel(VIEW_Z, 4, 0, 0, 2, 4, 4, texel);
+	NRD_CHECK(texel[0] == 0 && texel[1] == 1);
+	GetDownsampleTexel(VIEW_Z, 4, 1, 0, 2, 4, 4, texel);
+	NRD_CHECK(texel[0] == 3 && texel[1] == 1);
+	GetDownsampleTexel(VIEW_Z, 4, 1, 1, 2, 4, 4, texel);
+	NRD_CHECK(texel[0] == 3 && texel[1] == 3);
+
+	// Ties keep the first in row order; a rect of width 3 leaves column 3 out
+	GetDownsampleTexel(VIEW_Z, 4, 0, 1, 2, 4, 4, texel);
+	NRD_CHECK(texel[0] == 0 && texel[1] == 2);
+	GetDownsampleTexel(VIEW_Z, 4, 1, 1, 2, 3, 4, texel);
+	NRD_CHECK(texel[0] == 2 && texel[1] == 2);
+}